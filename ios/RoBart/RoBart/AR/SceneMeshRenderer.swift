@@ -24,14 +24,58 @@ import ARKit
 import RealityKit
 
 struct SceneMesh {
+    let identifier: UUID        // anchor identifier
     let vertices: [Vector3]
+    let triangles: [UInt32]     // 3 vertex indices per triangle
     let transform: Matrix4x4
+    let version: UInt64         // changes whenever ARKit updates the anchor
+}
+
+extension MeshAnchorID {
+    init(_ uuid: UUID) {
+        let bytes = withUnsafeBytes(of: uuid.uuid) { Array($0) }
+        self.init(
+            high: bytes[0..<8].reduce(0) { ($0 << 8) | UInt64($1) },
+            low: bytes[8..<16].reduce(0) { ($0 << 8) | UInt64($1) }
+        )
+    }
+}
+
+extension Array where Element == SceneMesh {
+    /// Calls `body` with a span referencing each mesh's vertex and triangle storage, without copying.
+    /// The spans are only valid for the duration of the call.
+    func withVertexSpans<R>(_ body: ([MeshVertexSpan]) -> R) -> R {
+        var spans: [MeshVertexSpan] = []
+        spans.reserveCapacity(count)
+        return withVertexSpans(from: 0, appendingTo: &spans, body)
+    }
+
+    private func withVertexSpans<R>(from idx: Int, appendingTo spans: inout [MeshVertexSpan], _ body: ([MeshVertexSpan]) -> R) -> R {
+        guard idx < count else {
+            return body(spans)
+        }
+        let mesh = self[idx]
+        return mesh.vertices.withUnsafeBufferPointer { verticesPtr in
+            mesh.triangles.withUnsafeBufferPointer { trianglesPtr in
+                spans.append(MeshVertexSpan(
+                    vertices: verticesPtr.baseAddress,
+                    numVertices: verticesPtr.count,
+                    triangleIndices: trianglesPtr.baseAddress,
+                    numTriangles: trianglesPtr.count / 3,
+                    transform: mesh.transform,
+                    version: mesh.version
+                ))
+                return withVertexSpans(from: idx + 1, appendingTo: &spans, body)
+            }
+        }
+    }
 }
 
 /// Renders anchor geometry.
 class SceneMeshRenderer {
     private var _entityByAnchorID: [UUID: Entity] = [:]
-    private var _verticesByAnchorID: [UUID: [Vector3]] = [:]
+    private var _geometryByAnchorID: [UUID: (vertices: [Vector3], triangles: [UInt32], version: UInt64)] = [:]
+    private var _nextVersion: UInt64 = 0
     private var _planeRootEntity: Entity?
     private var _worldMeshRootEntity: Entity?
     private let _planeColor = UIColor(cgColor: CGColor(red: 0, green: 1, blue: 1, alpha: 0.6))
@@ -65,10 +109,10 @@ class SceneMeshRenderer {
             break
         case let meshAnchor as ARMeshAnchor:
 #if !targetEnvironment(simulator)
-            guard let (mesh, vertices) = tryCreateWorldMesh(from: meshAnchor) else { break }
+            guard let (mesh, vertices, triangles) = tryCreateWorldMesh(from: meshAnchor) else { break }
             entity = createUnanchoredEntity(anchoredTo: anchor, with: mesh, color: _worldMeshColor)
             worldMeshRootEntity.addChild(entity!)
-            _verticesByAnchorID[anchor.identifier] = vertices
+            _geometryByAnchorID[anchor.identifier] = (vertices: vertices, triangles: triangles, version: nextVersion())
 #endif
             break
         default:
@@ -95,10 +139,10 @@ class SceneMeshRenderer {
             guard let mesh = tryCreatePlaneMesh(from: planeAnchor) else { break }
             modelEntity.model?.mesh = mesh
         case let meshAnchor as ARMeshAnchor:
-            guard let (mesh, vertices) = tryCreateWorldMesh(from: meshAnchor) else { break }
+            guard let (mesh, vertices, triangles) = tryCreateWorldMesh(from: meshAnchor) else { break }
             modelEntity.model?.mesh = mesh
             entity.transform.matrix = anchor.transform  // because entity is not a real AnchorEntity
-            _verticesByAnchorID[anchor.identifier] = vertices
+            _geometryByAnchorID[anchor.identifier] = (vertices: vertices, triangles: triangles, version: nextVersion())
         default:
             break
         }
@@ -114,7 +158,7 @@ class SceneMeshRenderer {
         if let entity = _entityByAnchorID.removeValue(forKey: anchor.identifier) {
             entity.removeFromParent()
         }
-        _verticesByAnchorID.removeValue(forKey: anchor.identifier)
+        _geometryByAnchorID.removeValue(forKey: anchor.identifier)
     }
 
     func removeMeshes(for anchors: [ARAnchor]) {
@@ -124,11 +168,18 @@ class SceneMeshRenderer {
     }
 
     func getMeshes() -> [SceneMesh] {
-        return _verticesByAnchorID.map { (identifier: UUID, vertices: [Vector3]) -> SceneMesh in
-            SceneMesh(vertices: vertices, transform: _entityByAnchorID[identifier]!.transform.matrix)
+        return _geometryByAnchorID.map { (identifier: UUID, geometry: (vertices: [Vector3], triangles: [UInt32], version: UInt64)) -> SceneMesh in
+            SceneMesh(identifier: identifier, vertices: geometry.vertices, triangles: geometry.triangles, transform: _entityByAnchorID[identifier]!.transform.matrix, version: geometry.version)
         }
     }
 
+    /// Versions are unique across anchors, so a removed anchor that reappears is never mistaken for
+    /// the old one.
+    private func nextVersion() -> UInt64 {
+        _nextVersion += 1
+        return _nextVersion
+    }
+
     private func tryCreatePlaneMesh(from anchor: ARPlaneAnchor) -> MeshResource? {
         var descriptor = MeshDescriptor(name: "Plane")
         descriptor.positions = MeshBuffer(anchor.geometry.vertices)
@@ -136,7 +187,7 @@ class SceneMeshRenderer {
         return try? MeshResource.generate(from: [ descriptor ])
     }
 
-    private func tryCreateWorldMesh(from anchor: ARMeshAnchor) -> (MeshResource, [Vector3])? {
+    private func tryCreateWorldMesh(from anchor: ARMeshAnchor) -> (MeshResource, [Vector3], [UInt32])? {
         // Read out triangles
         assert(anchor.geometry.faces.primitiveType == .triangle)
         let numFaces = anchor.geometry.faces.count
@@ -171,7 +222,7 @@ class SceneMeshRenderer {
         descriptor.primitives = .triangles(triangles)
 
         if let mesh = try? MeshResource.generate(from: [descriptor]) {
-            return (mesh, vertices)
+            return (mesh, vertices, triangles)
         }
         return nil
     }
@@ -460,10 +460,11 @@ class Brain: ObservableObject {
                let memories = decodeMemories(from: memoryThought.json) {
 
                 let occupancy = NavigationController.shared.occupancy
+                let distanceField = DistanceField(occupancy, ourPosition, _robotRadius)
                 let reachableLandmarks = memories.filter { (memory: Memory) in
                     // Reachable by direct line or path
                     guard let point = findNavigablePoint(pointID: memory.pointNumber, in: photosByNavigablePoint) else { return false }
-                    return occupancy.isLineUnobstructed(ourPosition, point.worldPoint) || findPath(occupancy, ourPosition, point.worldPoint, _robotRadius).size() > 0
+                    return occupancy.isLineUnobstructed(ourPosition, point.worldPoint) || distanceField.isReachable(point.worldPoint)
                 }
                 if !reachableLandmarks.isEmpty {
                     resultsDescription.append("The following previously-observed navigable points can still be reached:")
@@ -537,8 +538,10 @@ class Brain: ObservableObject {
             try? await Task.sleep(timeout: .seconds(maxMoveTime), until: { !HoverboardController.shared.isMoving })
         } else {
             // Attempt to pathfind
-            let pathCells = findPath(NavigationController.shared.occupancy, startPosition, navigablePoint.worldPoint, _robotRadius)
-            let path = pathCells.map { NavigationController.shared.occupancy.cellToPosition($0) }
+            let path = NavigationController.shared.withPlanningOccupancy { occupancy in
+                let pathCells = findPath(occupancy, startPosition, navigablePoint.worldPoint, _robotRadius)
+                return pathCells.map { occupancy.cellToPosition($0) }
+            }
             if path.isEmpty {
                 return "Unable to move to point \(moveTo.pointNumber) because there is no clear path to it"
             }
@@ -696,10 +699,11 @@ class Brain: ObservableObject {
        // Produce updated photos if there are any reachable navigable points
         var updatedPhotos: [AnnotatingCamera.Photo] = []
         let occupancy = NavigationController.shared.occupancy
+        let distanceField = DistanceField(occupancy, ourPosition, _robotRadius)
         for photo in photos {
             let reachableNavigablePoints = photo.navigablePoints.filter {
                 // Reachable by direct line or path
-                return occupancy.isLineUnobstructed(ourPosition, $0.worldPoint) || findPath(occupancy, ourPosition, $0.worldPoint, _robotRadius).size() > 0
+                return occupancy.isLineUnobstructed(ourPosition, $0.worldPoint) || distanceField.isReachable($0.worldPoint)
             }
             if reachableNavigablePoints.isEmpty {
                 continue
@@ -91,12 +91,34 @@ class HoverboardController {
     /// orientation is also within tolerance.
     var orientationGoalMaximumAngularSpeed: Float = 2.0
 
-    var maxThrottle: Float = 0.01
+    var maxThrottle: Float = 0.01 {
+        didSet {
+            if maxThrottle != oldValue {
+                _cruiseSpeed = nil
+                _secondsCruising = 0
+            }
+        }
+    }
 
     var isMoving: Bool {
         return _targetForward != nil || _targetPosition != nil || _leftMotorThrottle != 0 || _rightMotorThrottle != 0
     }
 
+    /// Kinematics for the state lattice planner. Turn rate comes from the steering calibration at
+    /// the current throttle limit, which is the fastest the orientation controller will turn.
+    /// There is no such calibration for forward driving, so forward speed is the speed observed at
+    /// the throttle limit, falling back to the model's nominal default until we have driven at it.
+    var latticeMotionModel: LatticeMotionModel {
+        var model = LatticeMotionModel()
+        model.angularSpeed = max(1, abs(_angularVelocityFromSteering.interpolate(x: maxThrottle)))
+        if let cruiseSpeed = _cruiseSpeed {
+            model.linearSpeed = max(0.05, cruiseSpeed)
+        }
+        model.robotWidth = Calibration.robotBounds.x
+        model.robotLength = Calibration.robotBounds.z
+        return model
+    }
+
     private let _ble = AsyncBluetoothManager(
         service: CBUUID(string: "df72a6f9-a217-11ee-a726-a4b1c10ba08a"),
         rxCharacteristic: CBUUID(string: "9472ed74-a21a-11ee-91d6-a4b1c10ba08a"),
@@ -140,6 +162,15 @@ class HoverboardController {
     private let _angularVelocityFromSteering = Util.Interpolator(filename: "angular_velocity_kitchen_floor.txt")
     private let _steeringFromAngularVelocity = Util.Interpolator(filename: "angular_velocity_kitchen_floor.txt", columns: 2, columnX: 1, columnY: 0)
 
+    /// Smoothed forward speed (m/sec) measured while the position controller drives at
+    /// `maxThrottle`. Forgotten when `maxThrottle` changes. Only sampled once the throttle has been
+    /// saturated, with little steering, for `cruiseSettlingSeconds`, so that standing starts,
+    /// acceleration, and turning do not drag it down. The first settled sample seeds it.
+    private var _cruiseSpeed: Float?
+    private var _secondsCruising: Float = 0
+    private static let cruiseSettlingSeconds: Float = 0.5
+    private static let cruiseMaxOrientationErrorDegrees: Float = 5
+
     private var _subscriptions = Set<AnyCancellable>()
 
     static func send(_ command: HoverboardCommand) {
@@ -296,6 +327,8 @@ class HoverboardController {
         var leftMotorThrottle: Float = 0
         var rightMotorThrottle: Float = 0
         var pidEnabled = false
+        var orientationErrorDegrees: Float = 0
+        var isCruising = false
 
         // Orientation target: use target if one set, otherwise use vector toward target position if position set, otherwise none
         let targetForward = _targetForward != nil ? _targetForward! : (_targetPosition != nil ? (_targetPosition! - currentPosition).xzProjected.normalized : nil)
@@ -304,7 +337,7 @@ class HoverboardController {
 
             // Orientation error: if heading to a position, we must keep the orientation PID active
             // but if only rotating, we stop when we hit our goal.
-            let orientationErrorDegrees = Vector3.signedAngle(from: currentForward, to: targetForward, axis: Vector3.up)
+            orientationErrorDegrees = Vector3.signedAngle(from: currentForward, to: targetForward, axis: Vector3.up)
             if _targetPosition == nil && abs(orientationErrorDegrees) <= abs(orientationGoalTolerance) && angularSpeed <= orientationGoalMaximumAngularSpeed {
                 _targetForward = nil
                 runOrientationPID = false
@@ -353,6 +386,16 @@ class HoverboardController {
                 leftMotorThrottle += direction * throttle
                 rightMotorThrottle += direction * throttle
 
+                // Learn how fast the throttle limit actually drives us, once we have settled into
+                // driving straight at it
+                if throttle >= maxThrottle && abs(orientationErrorDegrees) <= Self.cruiseMaxOrientationErrorDegrees {
+                    isCruising = true
+                    _secondsCruising += deltaTime
+                    if _secondsCruising >= Self.cruiseSettlingSeconds {
+                        _cruiseSpeed = _cruiseSpeed.map { $0 + 0.1 * (speed - $0) } ?? speed
+                    }
+                }
+
                 log("Position: error=\(positionError) speed=\(speed) targetVel=\(targetLinearVelocity) throttle=\(direction * throttle)")
             }
 
@@ -360,6 +403,10 @@ class HoverboardController {
             pidEnabled = true
         }
 
+        if !isCruising {
+            _secondsCruising = 0
+        }
+
         // Send to board
         if pidEnabled {
             _leftMotorThrottle = leftMotorThrottle
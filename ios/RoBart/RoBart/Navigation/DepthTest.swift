@@ -76,7 +76,9 @@
 
 import ARKit
 import Combine
+import CoreImage
 import RealityKit
+import Vision
 
 class DepthTest: ObservableObject {
     @Published var image: UIImage?
@@ -106,6 +108,9 @@ class DepthTest: ObservableObject {
     /// Moving average of LiDAR samples found in each cell.
     private var _hitCounts: OccupancyMap?
 
+    /// Downsampled points of the most recently sampled depth frame.
+    private var _pointCloud = DepthPointCloud()
+
     /// Occupancy map (binary occupied/not occupied), integrated from hit count map or from GPU
     /// occupancy map.
     private var _occupancy: OccupancyMap?
@@ -245,6 +250,605 @@ class DepthTest: ObservableObject {
 //        image = renderOccupancy(occupancy: occupancy, path: pathCells)
     }
 
+    /// Compares `findPathUnidirectional()` against `findPathBidirectional()`, which share the same
+    /// flat arrays and differ only in the second search thread, on the current occupancy map for
+    /// destinations at increasing distances from our position and logs the speedup. Both find shortest
+    /// paths but may break ties differently, so waypoint counts can differ.
+    func benchmarkPathfinding() {
+        let occupancy = NavigationController.shared.occupancy
+        let from = ARSessionManager.shared.transform.position
+        let robotRadius = 0.5 * max(Calibration.robotBounds.x, Calibration.robotBounds.z)
+        let numIterations = 10
+
+        for distance: Float in [ 1, 2, 5, 10 ] {
+            let to = from + Vector3(x: distance, y: 0, z: 0)
+            var unidirectionalPath = 0
+            var bidirectionalPath = 0
+            let unidirectionalSeconds = Util.Stopwatch.measure {
+                for _ in 0..<numIterations {
+                    unidirectionalPath = findPathUnidirectional(occupancy, from, to, robotRadius).size()
+                }
+            }
+            let bidirectionalSeconds = Util.Stopwatch.measure {
+                for _ in 0..<numIterations {
+                    bidirectionalPath = findPathBidirectional(occupancy, from, to, robotRadius).size()
+                }
+            }
+            let unidirectionalMs = 1e3 * unidirectionalSeconds / Double(numIterations)
+            let bidirectionalMs = 1e3 * bidirectionalSeconds / Double(numIterations)
+            log("Pathfinding \(distance) m: unidirectional=\(unidirectionalMs) ms (\(unidirectionalPath) waypoints), bidirectional=\(bidirectionalMs) ms (\(bidirectionalPath) waypoints), speedup=\(unidirectionalMs / bidirectionalMs)x")
+        }
+    }
+
+    /// Times `findHumans()` (and its multi-resolution variant at each pyramid level) on the person
+    /// segmentation mask of the next camera frame and on synthetic masks containing 0 to 20
+    /// people, all at depth map resolution.
+    func benchmarkHumanInstancing() {
+        Task {
+            let numIterations = 100
+            let width = 256
+            let height = 192
+            var masks: [(label: String, mask: CVPixelBuffer)] = []
+
+            // Record a real mask
+            if let frame = try? await ARSessionManager.shared.nextFrame(),
+               let mask = segmentPeople(in: frame, width: width, height: height) {
+                masks.append((label: "camera", mask: mask))
+            }
+
+            for numPeople in [ 0, 1, 5, 10, 20 ] {
+                if let mask = createSyntheticSegmentationMask(width: width, height: height, numPeople: numPeople) {
+                    masks.append((label: "\(numPeople) people", mask: mask))
+                }
+            }
+
+            for (label, mask) in masks {
+                for downsampleFactor: Int32 in [ 1, 2, 4 ] {
+                    var numHumans = 0
+                    let seconds = Util.Stopwatch.measure {
+                        for _ in 0..<numIterations {
+                            numHumans = findHumansMultiResolution(mask, 200, downsampleFactor).size()
+                        }
+                    }
+                    log("Human instancing (\(label), \(downsampleFactor)x): \(1e3 * seconds / Double(numIterations)) ms, \(numHumans) boxes")
+                }
+            }
+        }
+    }
+
+    /// Times `HumanTracker` updates with 1 to 50 people moving through a depth-resolution frame.
+    func benchmarkHumanTracker() {
+        let numFrames = 300
+        let deltaTime: Float = 0.1
+        for numPeople in [ 1, 5, 10, 20, 50 ] {
+            var tracker = HumanTracker(0.1, 0.75, 5, 50)
+            var positions = (0..<numPeople).map { _ in Vector2(x: Float.random(in: 0..<256), y: Float.random(in: 0..<192)) }
+            let velocities = (0..<numPeople).map { _ in Vector2(x: Float.random(in: -20..<20), y: Float.random(in: -10..<10)) }
+            let depths = (0..<numPeople).map { _ in Float.random(in: 0.5..<3) }
+            var numTracks = 0
+            var seconds: TimeInterval = 0
+            for _ in 0..<numFrames {
+                var boxes: [Box2D] = []
+                for i in 0..<numPeople {
+                    positions[i] += velocities[i] * deltaTime
+                    boxes.append(Box2D(x: Int32(positions[i].x), y: Int32(positions[i].y), width: 20, height: 34))
+                }
+                seconds += Util.Stopwatch.measure {
+                    numTracks = boxes.withUnsafeBufferPointer { boxesPtr in
+                        depths.withUnsafeBufferPointer { depthsPtr in
+                            tracker.update(boxesPtr.baseAddress, depthsPtr.baseAddress, boxes.count, deltaTime).size()
+                        }
+                    }
+                }
+            }
+            log("Human tracker (\(numPeople) people): \(1e6 * seconds / Double(numFrames)) us/frame, \(numTracks) tracks")
+        }
+    }
+
+    /// Times the two ways `computeAverageDepthOfBoundingBoxes()` can average box depths on a live
+    /// depth map, scanning each box and querying a `DepthIntegralImage`, as the boxes cover 0.25 to
+    /// 3 times the frame. The tables pay off beyond the coverage at which they become faster.
+    func benchmarkBoxDepth() {
+        Task {
+            guard let frame = try? await ARSessionManager.shared.nextFrame(),
+                  let depthMap = frame.sceneDepth?.depthMap else {
+                return
+            }
+            let numIterations = 100
+            let maximumDepth: Float = 5
+            let boxWidth = depthMap.width / 4
+            let boxHeight = depthMap.height / 2
+            for coverage: Float in [ 0.25, 0.5, 1, 1.5, 2, 3 ] {
+                let numBoxes = Int(coverage * 8)
+                let boxes = (0..<numBoxes).map { _ in
+                    Box2D(x: Int32.random(in: 0...Int32(depthMap.width - boxWidth)), y: Int32.random(in: 0...Int32(depthMap.height - boxHeight)), width: Int32(boxWidth), height: Int32(boxHeight))
+                }
+                var scanSum: Float = 0
+                var tableSum: Float = 0
+                let scanSeconds = Util.Stopwatch.measure {
+                    for _ in 0..<numIterations {
+                        scanSum = boxes.reduce(0) { $0 + computeAverageDepthOfBoundingBox($1, depthMap, maximumDepth) }
+                    }
+                }
+                let tableSeconds = Util.Stopwatch.measure {
+                    for _ in 0..<numIterations {
+                        let integralImage = DepthIntegralImage(depthMap, maximumDepth)
+                        tableSum = boxes.reduce(0) { $0 + integralImage.averageDepth($1) }
+                    }
+                }
+                let scanMs = 1e3 * scanSeconds / Double(numIterations)
+                let tableMs = 1e3 * tableSeconds / Double(numIterations)
+                log("Box depth (\(coverage)x frame, \(numBoxes) boxes): scan=\(scanMs) ms, integral image=\(tableMs) ms, speedup=\(scanMs / tableMs)x, difference=\(abs(scanSum - tableSum))")
+            }
+        }
+    }
+
+    /// Feeds live frames through `HumanPerceptionPipeline` for 10 seconds and logs per-stage
+    /// latency percentiles and frame counts.
+    func benchmarkHumanPerceptionPipeline() {
+        Task {
+            var pipeline = HumanPerceptionPipeline(UInt8(ARConfidenceLevel.high.rawValue), 200, 2)
+            var result = HumanPerceptionResult()
+            var frameId: UInt64 = 0
+            var numResults = 0
+            let stopAt = Date.now.advanced(by: 10)
+            while Date.now < stopAt {
+                guard let frame = try? await ARSessionManager.shared.nextFrame(),
+                      let depthMap = frame.sceneDepth?.depthMap,
+                      let confidenceMap = frame.sceneDepth?.confidenceMap,
+                      let segmentationMap = segmentPeople(in: frame, width: depthMap.width, height: depthMap.height) else {
+                    continue
+                }
+                frameId += 1
+                _ = pipeline.submit(frameId, depthMap, confidenceMap, segmentationMap)
+                if pipeline.takeLatestResult(&result) {
+                    numResults += 1
+                }
+            }
+            pipeline.waitUntilIdle()
+
+            let stages: [(name: String, stage: PerceptionStage)] = [
+                (name: "filter depth", stage: .FilterDepth),
+                (name: "find humans", stage: .FindHumans),
+                (name: "box depth", stage: .BoxDepth),
+                (name: "total", stage: .Total)
+            ]
+            for (name, stage) in stages {
+                log("Perception pipeline \(name): p50=\(pipeline.latencyPercentile(stage, 50)) ms, p90=\(pipeline.latencyPercentile(stage, 90)) ms, p99=\(pipeline.latencyPercentile(stage, 99)) ms")
+            }
+            log("Perception pipeline frames: submitted=\(pipeline.submittedFrames()), dropped=\(pipeline.droppedFrames()), completed=\(pipeline.completedFrames()), results taken=\(numResults)")
+        }
+    }
+
+    /// Integrates 5 seconds of live depth frames into a `VoxelMap` at several voxel sizes, then
+    /// projects it onto slabs at base height and at phone height. Logs integration and projection
+    /// times and how many cells each slab marks.
+    func benchmarkVoxelMap() {
+        Task {
+            let voxelSides: [Float] = [ 0.1, 0.05, 0.025 ]
+            let voxelMaps = voxelSides.map { VoxelMap($0, 2) }
+            var integrationSeconds = Array(repeating: TimeInterval(0), count: voxelMaps.count)
+            var numFrames = 0
+            let stopAt = Date.now.advanced(by: 5)
+            while Date.now < stopAt {
+                guard let frame = try? await ARSessionManager.shared.nextFrame(),
+                      let depthMap = frame.sceneDepth?.depthMap,
+                      let confidenceMap = frame.sceneDepth?.confidenceMap else {
+                    continue
+                }
+                filterDepthMap(depthMap, confidenceMap, UInt8(ARConfidenceLevel.high.rawValue))
+                let rgbResolution = simd_float2(Float(frame.camera.imageResolution.width), Float(frame.camera.imageResolution.height))
+                for i in 0..<voxelMaps.count {
+                    var voxelMap = voxelMaps[i]
+                    integrationSeconds[i] += Util.Stopwatch.measure {
+                        voxelMap.integrateDepth(depthMap, frame.camera.intrinsics, rgbResolution, frame.camera.transform, 0.5, 3.0)
+                    }
+                }
+                numFrames += 1
+            }
+
+            let floorY = ARSessionManager.shared.floorY
+            let geometry = NavigationController.shared.occupancy
+            var projected = OccupancyMap(geometry.width(), geometry.depth(), geometry.cellSide(), geometry.centerPoint())
+            let slabs: [(name: String, minHeight: Float, maxHeight: Float)] = [
+                (name: "base", minHeight: floorY + 0.1, maxHeight: floorY + 0.5),
+                (name: "phone", minHeight: floorY + 0.5, maxHeight: floorY + Calibration.phoneHeightAboveFloor + 0.1)
+            ]
+            for (voxelSide, (voxelMap, seconds)) in zip(voxelSides, zip(voxelMaps, integrationSeconds)) {
+                log("Voxel map (\(voxelSide) m): \(voxelMap.numBlocks()) blocks, integrate=\(1e3 * seconds / Double(max(numFrames, 1))) ms/frame")
+                for slab in slabs {
+                    var numOccupied = 0
+                    let projectSeconds = Util.Stopwatch.measure {
+                        voxelMap.project(&projected, slab.minHeight, slab.maxHeight)
+                        numOccupied = getOccupancyArray(projected).filter { $0 != 0 }.count
+                    }
+                    log("  \(slab.name) slab: project=\(1e3 * projectSeconds) ms, \(numOccupied) cells occupied")
+                }
+            }
+        }
+    }
+
+    /// Compares unprojecting every depth pixel against stride-adaptive downsampling for 5 seconds
+    /// of live depth frames, feeding both into occupancy cell counts. Logs point counts, the time
+    /// spent in each stage, and how far the resulting counts differ.
+    func benchmarkPointCloud() {
+        Task {
+            let cellSide: Float = 0.25
+            let position = ARSessionManager.shared.transform.position.xzProjected
+            var fullCounts = OccupancyMap(20, 20, cellSide, position)
+            var sparseCounts = OccupancyMap(20, 20, cellSide, position)
+            var fullCloud = DepthPointCloud()
+            var sparseCloud = DepthPointCloud()
+            var fullSeconds: (unproject: TimeInterval, count: TimeInterval) = (0, 0)
+            var sparseSeconds: (unproject: TimeInterval, count: TimeInterval) = (0, 0)
+            var fullPoints = 0
+            var sparsePoints = 0
+            var numFrames = 0
+            let minHeight = ARSessionManager.shared.floorY + 0.25
+            let maxHeight = ARSessionManager.shared.floorY + Calibration.phoneHeightAboveFloor
+            let stopAt = Date.now.advanced(by: 5)
+            while Date.now < stopAt {
+                guard let frame = try? await ARSessionManager.shared.nextFrame(),
+                      let depthMap = frame.sceneDepth?.depthMap,
+                      let confidenceMap = frame.sceneDepth?.confidenceMap else {
+                    continue
+                }
+                filterDepthMap(depthMap, confidenceMap, UInt8(ARConfidenceLevel.high.rawValue))
+                let rgbResolution = simd_float2(Float(frame.camera.imageResolution.width), Float(frame.camera.imageResolution.height))
+                fullSeconds.unproject += Util.Stopwatch.measure {
+                    fullCloud.update(depthMap, frame.camera.intrinsics, rgbResolution, frame.camera.transform, 0.5, 3.0, 0)
+                }
+                fullSeconds.count += Util.Stopwatch.measure {
+                    fullCounts.updateCellCountsFromPoints(fullCloud, minHeight, maxHeight, 1, 1)
+                }
+                sparseSeconds.unproject += Util.Stopwatch.measure {
+                    sparseCloud.update(depthMap, frame.camera.intrinsics, rgbResolution, frame.camera.transform, 0.5, 3.0, 0.25 * cellSide)
+                }
+                sparseSeconds.count += Util.Stopwatch.measure {
+                    sparseCounts.updateCellCountsFromPoints(sparseCloud, minHeight, maxHeight, 1, 1)
+                }
+                fullPoints += fullCloud.size()
+                sparsePoints += sparseCloud.size()
+                numFrames += 1
+            }
+
+            let perFrame = 1e3 / Double(max(numFrames, 1))
+            log("Full: \(fullPoints / max(numFrames, 1)) points/frame, unproject=\(perFrame * fullSeconds.unproject) ms, count=\(perFrame * fullSeconds.count) ms")
+            log("Downsampled: \(sparsePoints / max(numFrames, 1)) points/frame, unproject=\(perFrame * sparseSeconds.unproject) ms, count=\(perFrame * sparseSeconds.count) ms")
+
+            let full = getOccupancyArray(fullCounts)
+            let sparse = getOccupancyArray(sparseCounts)
+            let total = full.reduce(0, +)
+            let difference = zip(full, sparse).reduce(0) { $0 + abs($1.0 - $1.1) }
+            log("Cell count difference: \(100 * difference / max(total, 1))% of \(total) samples")
+        }
+    }
+
+    /// Fuses 5 seconds of live depth frames into a `TSDFVolume` at several voxel sizes and logs
+    /// integration throughput, then extracts the base-height slab from each volume.
+    func benchmarkTSDF() {
+        Task {
+            let voxelSides: [Float] = [ 0.1, 0.05, 0.025 ]
+            let volumes = voxelSides.map { TSDFVolume($0, 3 * $0, 64) }
+            var integrationSeconds = Array(repeating: TimeInterval(0), count: volumes.count)
+            var numFrames = 0
+            let stopAt = Date.now.advanced(by: 5)
+            while Date.now < stopAt {
+                guard let frame = try? await ARSessionManager.shared.nextFrame(),
+                      let depthMap = frame.sceneDepth?.depthMap,
+                      let confidenceMap = frame.sceneDepth?.confidenceMap else {
+                    continue
+                }
+                filterDepthMap(depthMap, confidenceMap, UInt8(ARConfidenceLevel.high.rawValue))
+                let rgbResolution = simd_float2(Float(frame.camera.imageResolution.width), Float(frame.camera.imageResolution.height))
+                for i in 0..<volumes.count {
+                    var volume = volumes[i]
+                    integrationSeconds[i] += Util.Stopwatch.measure {
+                        volume.integrateDepth(depthMap, frame.camera.intrinsics, rgbResolution, frame.camera.transform, 0.5, 3.0)
+                    }
+                }
+                numFrames += 1
+            }
+
+            let floorY = ARSessionManager.shared.floorY
+            let geometry = NavigationController.shared.occupancy
+            var slice = OccupancyMap(geometry.width(), geometry.depth(), geometry.cellSide(), geometry.centerPoint())
+            for (voxelSide, (volume, seconds)) in zip(voxelSides, zip(volumes, integrationSeconds)) {
+                var numOccupied = 0
+                let extractSeconds = Util.Stopwatch.measure {
+                    volume.extractSlice(&slice, floorY + 0.1, floorY + 0.5, 2)
+                    numOccupied = getOccupancyArray(slice).filter { $0 != 0 }.count
+                }
+                log("TSDF (\(voxelSide) m): \(volume.numBlocks()) blocks, \(Double(numFrames) / max(seconds, 1e-6)) frames/sec, extract=\(1e3 * extractSeconds) ms, \(numOccupied) cells occupied")
+            }
+        }
+    }
+
+    /// Saves the current scene meshes, floor height, and robot position to the app's documents
+    /// directory for use by `benchmarkMeshOccupancy()`.
+    func recordSceneMeshes() {
+        let meshes = ARSessionManager.shared.sceneMeshes
+        var data = Data()
+        func append<T>(_ value: T) {
+            withUnsafeBytes(of: value) { data.append(contentsOf: $0) }
+        }
+        append(ARSessionManager.shared.floorY)
+        append(ARSessionManager.shared.transform.position)
+        append(UInt32(meshes.count))
+        for mesh in meshes {
+            append(mesh.transform)
+            append(UInt32(mesh.vertices.count))
+            for vertex in mesh.vertices {
+                append(vertex)
+            }
+            append(UInt32(mesh.triangles.count))
+            for index in mesh.triangles {
+                append(index)
+            }
+        }
+
+        let url = _meshDumpDirectory.appendingPathComponent("scene_\(Int(Date.now.timeIntervalSince1970)).meshes")
+        do {
+            try data.write(to: url)
+            log("Recorded \(meshes.count) meshes to \(url.lastPathComponent)")
+        } catch {
+            log("Error: Unable to write mesh dump: \(error.localizedDescription)")
+        }
+    }
+
+    /// Runs every mesh dump recorded by `recordSceneMeshes()` through the CPU vertex splatting and
+    /// triangle rasterization paths and the elevation map at several cell sizes, and through the
+    /// GPU occupancy kernel (including vertex flattening) at the navigation cell size. Logs
+    /// timings, how many cells each path marks, and any cells on which they disagree.
+    func benchmarkMeshOccupancy() {
+        let urls = (try? FileManager.default.contentsOfDirectory(at: _meshDumpDirectory, includingPropertiesForKeys: nil)) ?? []
+        let numIterations = 20
+        for url in urls where url.pathExtension == "meshes" {
+            guard let (floorY, centerPoint, meshes) = loadSceneMeshes(from: url) else {
+                log("Error: Unable to load \(url.lastPathComponent)")
+                continue
+            }
+            let numVertices = meshes.reduce(0) { $0 + $1.vertices.count }
+            let numTriangles = meshes.reduce(0) { $0 + $1.triangles.count / 3 }
+            let minHeight = floorY + 0.25
+            let maxHeight = floorY + Calibration.phoneHeightAboveFloor
+            log("Mesh occupancy (\(url.lastPathComponent)): \(meshes.count) meshes, \(numVertices) vertices, \(numTriangles) triangles")
+
+            for cellSide: Float in [ 0.25, 0.1, 0.05 ] {
+                var splatOccupancy = OccupancyMap(20, 20, cellSide, centerPoint)
+                let splatSeconds = Util.Stopwatch.measure {
+                    for _ in 0..<numIterations {
+                        splatOccupancy.clear()
+                        meshes.withVertexSpans { spans in
+                            splatOccupancy.updateOccupancyFromMeshes(spans, spans.count, minHeight, maxHeight)
+                        }
+                    }
+                }
+
+                var triangleOccupancy = OccupancyMap(20, 20, cellSide, centerPoint)
+                let triangleSeconds = Util.Stopwatch.measure {
+                    for _ in 0..<numIterations {
+                        triangleOccupancy.clear()
+                        meshes.withVertexSpans { spans in
+                            triangleOccupancy.updateOccupancyFromMeshTriangles(spans, spans.count, minHeight, maxHeight)
+                        }
+                    }
+                }
+
+                var elevation = ElevationMap(triangleOccupancy, minHeight, floorY + 3)
+                let elevationSeconds = Util.Stopwatch.measure {
+                    for _ in 0..<numIterations {
+                        elevation.clear()
+                        meshes.withVertexSpans { spans in
+                            elevation.integrateMeshes(spans, spans.count)
+                        }
+                    }
+                }
+
+                // Every splatted cell contains a vertex within the height range and so should also be
+                // covered by a triangle
+                let splatArray = getOccupancyArray(splatOccupancy)
+                let triangleArray = getOccupancyArray(triangleOccupancy)
+                let numSplatCells = splatArray.filter { $0 != 0 }.count
+                let numTriangleCells = triangleArray.filter { $0 != 0 }.count
+                let numMissedByTriangles = zip(splatArray, triangleArray).filter { $0 != 0 && $1 == 0 }.count
+                let splatMs = 1e3 * splatSeconds / Double(numIterations)
+                let triangleMs = 1e3 * triangleSeconds / Double(numIterations)
+                log("  \(cellSide) m cells: splat=\(splatMs) ms (\(numSplatCells) cells), triangles=\(triangleMs) ms (\(numTriangleCells) cells), splat cells missed by triangles=\(numMissedByTriangles)")
+                log("  \(cellSide) m cells: elevation map=\(1e3 * elevationSeconds / Double(numIterations)) ms")
+
+                // Incremental updates: first (everything new), nothing changed, and one anchor moved
+                var incrementalOccupancy = OccupancyMap(20, 20, cellSide, centerPoint)
+                var cache = MeshOccupancyCache()
+                let ids = meshes.map { MeshAnchorID($0.identifier) }
+                var movedMeshes = meshes
+                if let mesh = meshes.first {
+                    movedMeshes[0] = SceneMesh(identifier: mesh.identifier, vertices: mesh.vertices, triangles: mesh.triangles, transform: Matrix4x4(translation: Vector3(x: 0.1, y: 0, z: 0), rotation: .identity, scale: .one) * mesh.transform, version: mesh.version + 1)
+                }
+                var incrementalMs: [Double] = []
+                for meshSet in [ meshes, meshes, movedMeshes ] {
+                    let seconds = Util.Stopwatch.measure {
+                        meshSet.withVertexSpans { spans in
+                            _ = ids.withUnsafeBufferPointer { idsPtr in
+                                cache.update(&incrementalOccupancy, spans, idsPtr.baseAddress, spans.count, minHeight, maxHeight, nil)
+                            }
+                        }
+                    }
+                    incrementalMs.append(1e3 * seconds)
+                }
+                log("  \(cellSide) m cells: incremental initial=\(incrementalMs[0]) ms, unchanged=\(incrementalMs[1]) ms, one anchor moved=\(incrementalMs[2]) ms")
+
+                guard cellSide == NavigationController.cellSide else { continue }
+                let gpuOccupancy = GPUOccupancyMap(width: 20, depth: 20, cellSide: cellSide, centerPoint: centerPoint)
+                let gpuSeconds = Util.Stopwatch.measure {
+                    for _ in 0..<numIterations {
+                        var vertices: [Vector3] = []
+                        var transformIdxs: [UInt32] = []
+                        for (idx, mesh) in meshes.enumerated() {
+                            vertices.append(contentsOf: mesh.vertices)
+                            transformIdxs.append(contentsOf: repeatElement(UInt32(idx), count: mesh.vertices.count))
+                        }
+                        gpuOccupancy.reset(to: 0)
+                        _ = gpuOccupancy.update(
+                            vertices: vertices,
+                            transforms: meshes.map { $0.transform },
+                            transformIndices: transformIdxs,
+                            minOccupiedHeight: minHeight,
+                            maxOccupiedHeight: maxHeight,
+                            completion: nil
+                        )
+                    }
+                }
+                let gpuArray = gpuOccupancy.getMapArray() ?? []
+                let numMismatched = zip(splatArray, gpuArray).filter { $0 != $1 }.count
+                log("  \(cellSide) m cells: GPU splat=\(1e3 * gpuSeconds / Double(numIterations)) ms, cells differing from CPU splat=\(numMismatched)")
+            }
+        }
+    }
+
+    /// Runs the C++ mapping stages repeatedly on the current scene meshes and checks that, once
+    /// their frame arenas have warmed up, they no longer allocate heap memory at all. Allocations
+    /// are counted by the operator new replacement of Debug builds, on every thread, so this should
+    /// be run while the robot is idle. Crashes with a message if any are found.
+    func checkFrameArenaAllocations() {
+        guard isHeapAllocationCountingEnabled() else {
+            log("Error: Heap allocations are only counted in Debug builds")
+            return
+        }
+
+        let meshes = ARSessionManager.shared.sceneMeshes
+        let floorY = ARSessionManager.shared.floorY
+        let minHeight = floorY + 0.25
+        let maxHeight = floorY + Calibration.phoneHeightAboveFloor
+        var occupancy = OccupancyMap(20, 20, 0.1, ARSessionManager.shared.transform.position.xzProjected)
+        var elevation = ElevationMap(occupancy, minHeight, floorY + 3)
+        var elevationObstacles = Array(repeating: Float(0), count: occupancy.numCells())
+        var dynamicObstacles = DynamicObstacleMap(occupancy, 3)
+        let center = ARSessionManager.shared.transform.position.xzProjected
+        dynamicObstacles.stampRectangle(simd_float2(center.x - 0.5, center.z - 0.5), simd_float2(center.x + 0.5, center.z + 0.5), 0)
+
+        // Everything runs synchronously on this thread, so a single thread-local arena is used
+        let numWarmUpFrames = 3
+        let numFrames = 20
+        var steadyStateAllocations = 0
+        var arenaAllocationsAfterWarmUp = 0
+        for frame in 0..<numFrames {
+            if frame == numWarmUpFrames {
+                arenaAllocationsAfterWarmUp = getFrameArenaHeapAllocations()
+            }
+            let allocationsBefore = getHeapAllocationCount()
+            occupancy.clear()
+            elevation.clear()
+            meshes.withVertexSpans { spans in
+                occupancy.updateOccupancyFromMeshes(spans, spans.count, minHeight, maxHeight)
+                occupancy.updateOccupancyFromMeshTriangles(spans, spans.count, minHeight, maxHeight)
+                elevation.integrateMeshes(spans, spans.count)
+            }
+            elevationObstacles.withUnsafeMutableBufferPointer { ptr in
+                elevation.getObstacleArray(ptr.baseAddress, ptr.count, maxHeight)
+            }
+            _ = dynamicObstacles.overlay(occupancy, 0)
+            if frame >= numWarmUpFrames {
+                steadyStateAllocations += getHeapAllocationCount() - allocationsBefore
+            }
+        }
+
+        let arenaAllocations = getFrameArenaHeapAllocations() - arenaAllocationsAfterWarmUp
+        log("Frame arena: \(meshes.count) meshes, \(steadyStateAllocations) heap allocations (\(arenaAllocations) by arenas) in \(numFrames - numWarmUpFrames) frames after warm-up")
+        precondition(steadyStateAllocations == 0, "Mapping stages allocated heap memory after warm-up")
+    }
+
+    private func getOccupancyArray(_ occupancy: OccupancyMap) -> [Float] {
+        var array = Array(repeating: Float(0), count: occupancy.numCells())
+        array.withUnsafeMutableBufferPointer { ptr in
+            occupancy.getOccupancyArray(ptr.baseAddress, ptr.count)
+        }
+        return array
+    }
+
+    private var _meshDumpDirectory: URL {
+        return FileManager.default.urls(for: .documentDirectory, in: .userDomainMask)[0]
+    }
+
+    private func loadSceneMeshes(from url: URL) -> (floorY: Float, position: Vector3, meshes: [SceneMesh])? {
+        guard let data = try? Data(contentsOf: url) else { return nil }
+        var offset = 0
+        func read<T>(_ type: T.Type) -> T? {
+            guard offset + MemoryLayout<T>.size <= data.count else { return nil }
+            let value = data.withUnsafeBytes { $0.loadUnaligned(fromByteOffset: offset, as: T.self) }
+            offset += MemoryLayout<T>.size
+            return value
+        }
+
+        guard let floorY = read(Float.self),
+              let position = read(Vector3.self),
+              let numMeshes = read(UInt32.self) else {
+            return nil
+        }
+        var meshes: [SceneMesh] = []
+        for _ in 0..<numMeshes {
+            guard let transform = read(Matrix4x4.self),
+                  let numVertices = read(UInt32.self) else {
+                return nil
+            }
+            var vertices: [Vector3] = []
+            vertices.reserveCapacity(Int(numVertices))
+            for _ in 0..<numVertices {
+                guard let vertex = read(Vector3.self) else { return nil }
+                vertices.append(vertex)
+            }
+            guard let numIndices = read(UInt32.self) else { return nil }
+            var triangles: [UInt32] = []
+            triangles.reserveCapacity(Int(numIndices))
+            for _ in 0..<numIndices {
+                guard let index = read(UInt32.self) else { return nil }
+                triangles.append(index)
+            }
+            meshes.append(SceneMesh(identifier: UUID(), vertices: vertices, triangles: triangles, transform: transform, version: 0))
+        }
+        return (floorY: floorY, position: position, meshes: meshes)
+    }
+
+    private func segmentPeople(in frame: ARFrame, width: Int, height: Int) -> CVPixelBuffer? {
+        let request = VNGeneratePersonSegmentationRequest()
+        let requestHandler = VNImageRequestHandler(ciImage: CIImage(cvPixelBuffer: frame.capturedImage))
+        guard (try? requestHandler.perform([request])) != nil else { return nil }
+        return request.results?.first?.pixelBuffer.resize(newWidth: width, newHeight: height)
+    }
+
+    private func createSyntheticSegmentationMask(width: Int, height: Int, numPeople: Int) -> CVPixelBuffer? {
+        var pixelBuffer: CVPixelBuffer?
+        guard CVPixelBufferCreate(kCFAllocatorDefault, width, height, kCVPixelFormatType_OneComponent8, nil, &pixelBuffer) == kCVReturnSuccess,
+              let buffer = pixelBuffer else {
+            return nil
+        }
+
+        CVPixelBufferLockBaseAddress(buffer, [])
+        defer { CVPixelBufferUnlockBaseAddress(buffer, []) }
+        let bytesPerRow = CVPixelBufferGetBytesPerRow(buffer)
+        let pixels = CVPixelBufferGetBaseAddress(buffer)!.assumingMemoryBound(to: UInt8.self)
+        memset(pixels, 0, bytesPerRow * height)
+
+        // Each person is an ellipse elongated along x, which is vertical in portrait orientation
+        for _ in 0..<numPeople {
+            let centerX = Float.random(in: 0..<Float(width))
+            let centerY = Float.random(in: 0..<Float(height))
+            let radiusX = Float.random(in: 20..<60)
+            let radiusY = Float.random(in: 5..<20)
+            for yi in max(0, Int(centerY - radiusY))..<min(height, Int(centerY + radiusY) + 1) {
+                for xi in max(0, Int(centerX - radiusX))..<min(width, Int(centerX + radiusX) + 1) {
+                    let u = (Float(xi) - centerX) / radiusX
+                    let v = (Float(yi) - centerY) / radiusY
+                    if u * u + v * v <= 1 {
+                        pixels[yi * bytesPerRow + xi] = 255
+                    }
+                }
+            }
+        }
+
+        return buffer
+    }
+
     private func onFrame(_ frame: ARFrame) {
         guard let sceneDepth = frame.sceneDepth else { return }
         _sceneDepth = sceneDepth
@@ -399,13 +1003,17 @@ class DepthTest: ObservableObject {
         let tau: Float = 1.0
         let newSampleWeight: Float = 1.0 - exp(-Float(sampleDeltaTime) / tau)   // EWMA: https://en.wikipedia.org/wiki/Exponential_smoothing
         let previousWeight: Float = 1.0 - newSampleWeight
-        hitCounts.updateCellCounts(
+        _pointCloud.update(
             depthMap,
             intrinsics,
             simd_float2(Float(rgbResolution.width), Float(rgbResolution.height)),
             viewMatrix,
             minDepth,
             maxDepth,
+            0.25 * hitCounts.cellSide()   // a few samples per cell is plenty
+        )
+        hitCounts.updateCellCountsFromPoints(
+            _pointCloud,
             minHeight,
             maxHeight,
             newSampleWeight,
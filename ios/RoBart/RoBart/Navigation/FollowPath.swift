@@ -39,6 +39,37 @@ func followPath(_ path: [Vector3]) async throws {
     }
 }
 
+/// Drives through each waypoint in turn along paths from the hierarchical pathfinder. Only the
+/// first leg of a path is refined to individual cells, so just that leg is driven before planning
+/// again from wherever the robot ended up. The rest of the path is thereby refined lazily as the
+/// robot advances, rather than all at once up front.
+func followHierarchicalPath(through waypoints: [Vector3]) async throws {
+    for (i, waypoint) in waypoints.enumerated() {
+        log("Moving to waypoints[\(i)] = \(waypoint)...")
+        while true {
+            let from = ARSessionManager.shared.transform.position
+            let pathCells = NavigationController.shared.hierarchicalPathfinder.findPath(from, waypoint, false)
+            if pathCells.isEmpty {
+                log("No path to waypoints[\(i)]")
+                return
+            }
+
+            // The path begins with the cell we are in, so we have arrived if nothing else remains
+            guard pathCells.count > 1 else { break }
+            let occupancy = NavigationController.shared.occupancy
+            try await followPath([ occupancy.cellToPosition(pathCells[1]) ])
+
+            // Avoid replanning forever if the robot is unable to make progress
+            let cell = occupancy.positionToCell(ARSessionManager.shared.transform.position)
+            if cell.cellX == pathCells[0].cellX && cell.cellZ == pathCells[0].cellZ {
+                log("Unable to make progress toward waypoints[\(i)]")
+                return
+            }
+        }
+        log("At waypoints[\(i)]")
+    }
+}
+
 fileprivate func log(_ message: String) {
     print("[FollowPath] \(message)")
 }
@@ -40,6 +40,11 @@ func followPerson(duration followDuration: TimeInterval?, distance followDistanc
     var goalPositionHistory: [Vector3] = Array(repeating: ARSessionManager.shared.transform.position, count: 5)
     var historyIdx = 0
 
+    // Track people across frames so we keep following the same one
+    var tracker = HumanTracker(0.1, 0.75, 5, 50)
+    var targetTrackId: UInt32?
+    var lastDetectionTimestamp: TimeInterval?
+
     let stopFollowingAt: Date? = followDuration != nil ? Date.now.advanced(by: followDuration!) : nil
     let startedAtPosition = ARSessionManager.shared.transform.position
 
@@ -76,13 +81,24 @@ func followPerson(duration followDuration: TimeInterval?, distance followDistanc
         // Perform person detection and update goal position
         if now >= nextPersonDetectionTime,
            let frame = try? await ARSessionManager.shared.nextFrame() {
-            let people = detectHumans(in: frame, maximumDistance: Settings.shared.maxPersonDistance)
+            let deltaTime = Float(frame.timestamp - (lastDetectionTimestamp ?? frame.timestamp))
+            lastDetectionTimestamp = frame.timestamp
+            let (people, footprints) = detectHumans(in: frame, maximumDistance: Settings.shared.maxPersonDistance, tracker: &tracker, deltaTime: deltaTime)
+            if let footprints = footprints {
+                NavigationController.shared.stampHumans(footprints)
+            }
+
+            // Stay with the person we were following for as long as they are tracked, otherwise
+            // pick up whoever is nearest
+            let trackedPerson = people.first(where: { $0.id == targetTrackId })
+            let nearestPerson = people.min(by: { ($0.position - currentPosition).magnitude < ($1.position - currentPosition).magnitude })
+            if let person = trackedPerson ?? nearestPerson {
+                targetTrackId = person.id
 
-            if let nearestPerson = people.sorted(by: { $0.magnitude > $1.magnitude }).first {
                 // Compute goal position safe distance from person
                 let targetDistanceToPerson = Settings.shared.followDistance
-                let distanceToPerson = (nearestPerson - currentPosition).magnitude
-                let direction = (nearestPerson - currentPosition).xzProjected.normalized
+                let distanceToPerson = (person.position - currentPosition).magnitude
+                let direction = (person.position - currentPosition).xzProjected.normalized
                 let goalPosition = currentPosition + direction * max(0, distanceToPerson - targetDistanceToPerson)  // keep safe distance
                 HoverboardController.shared.send(.driveToFacing(position: goalPosition, forward: direction))
 
@@ -22,21 +22,98 @@
 
 #include "BoxDepth.hpp"
 
+/// Total box area, as a multiple of the depth map area, beyond which
+/// computeAverageDepthOfBoundingBoxes() builds a DepthIntegralImage rather than scanning each box.
+static constexpr float integralImageBreakEvenCoverage = 1.5f;
+
+/// Clips a box to the depth map.
+/// - Returns: False if the box lies entirely outside of it.
+static bool clipBox(Box2D *box, size_t depthWidth, size_t depthHeight)
+{
+    if (box->x >= int(depthWidth) || box->y >= int(depthHeight) || (box->x + box->width) <= 0 || (box->y + box->height) <= 0)
+    {
+        return false;
+    }
+    int x2 = std::min(int(depthWidth), box->x + box->width);
+    int y2 = std::min(int(depthHeight), box->y + box->height);
+    box->x = std::max(0, box->x);
+    box->y = std::max(0, box->y);
+    box->width = x2 - box->x;
+    box->height = y2 - box->y;
+    return true;
+}
+
+DepthIntegralImage::DepthIntegralImage(CVPixelBufferRef depthMap, float maximumDepth)
+{
+    assert(CVPixelBufferGetPixelFormatType(depthMap) == kCVPixelFormatType_DepthFloat32);
+
+    _width = CVPixelBufferGetWidth(depthMap);
+    _height = CVPixelBufferGetHeight(depthMap);
+    size_t tableWidth = _width + 1;
+    _depthSum.assign(tableWidth * (_height + 1), 0.0);
+    _count.assign(tableWidth * (_height + 1), 0);
+
+    CVPixelBufferLockBaseAddress(depthMap, kCVPixelBufferLock_ReadOnly);
+    size_t depthStride = CVPixelBufferGetBytesPerRow(depthMap) / sizeof(float);
+    const float *depthValues = reinterpret_cast<const float *>(CVPixelBufferGetBaseAddress(depthMap));
+
+    // Each entry is the running sum along its row plus the entry directly above
+    for (size_t yi = 0; yi < _height; yi++)
+    {
+        const float *line = &depthValues[yi * depthStride];
+        const double *sumAbove = &_depthSum[yi * tableWidth];
+        const uint32_t *countAbove = &_count[yi * tableWidth];
+        double *sum = &_depthSum[(yi + 1) * tableWidth];
+        uint32_t *count = &_count[(yi + 1) * tableWidth];
+        double rowSum = 0;
+        uint32_t rowCount = 0;
+        for (size_t xi = 0; xi < _width; xi++)
+        {
+            float depth = line[xi];
+            if (depth <= maximumDepth)
+            {
+                rowSum += depth;
+                rowCount += 1;
+            }
+            sum[xi + 1] = sumAbove[xi + 1] + rowSum;
+            count[xi + 1] = countAbove[xi + 1] + rowCount;
+        }
+    }
+
+    CVPixelBufferUnlockBaseAddress(depthMap, kCVPixelBufferLock_ReadOnly);
+}
+
+float DepthIntegralImage::averageDepth(Box2D box) const
+{
+    if (!clipBox(&box, _width, _height))
+    {
+        return -1;
+    }
+
+    size_t tableWidth = _width + 1;
+    size_t topLeft = size_t(box.y) * tableWidth + size_t(box.x);
+    size_t topRight = topLeft + size_t(box.width);
+    size_t bottomLeft = topLeft + size_t(box.height) * tableWidth;
+    size_t bottomRight = bottomLeft + size_t(box.width);
+
+    uint32_t numPixelsCounted = _count[bottomRight] - _count[bottomLeft] - _count[topRight] + _count[topLeft];
+    if (numPixelsCounted == 0)
+    {
+        return -1;
+    }
+    double cumulativeDepth = _depthSum[bottomRight] - _depthSum[bottomLeft] - _depthSum[topRight] + _depthSum[topLeft];
+    return float(cumulativeDepth / double(numPixelsCounted));
+}
+
 float computeAverageDepthOfBoundingBox(Box2D box, CVPixelBufferRef depthMap, float maximumDepth)
 {
     assert(CVPixelBufferGetPixelFormatType(depthMap) == kCVPixelFormatType_DepthFloat32);
 
     // Clip box to frame
-    size_t depthWidth = CVPixelBufferGetWidth(depthMap);
-    size_t depthHeight = CVPixelBufferGetHeight(depthMap);
-    if (box.x >= depthWidth || box.y >= depthHeight || (box.x + box.width) <= 0 || (box.y + box.height) <= 0)
+    if (!clipBox(&box, CVPixelBufferGetWidth(depthMap), CVPixelBufferGetHeight(depthMap)))
     {
         return -1;
     }
-    box.x = std::max(0, box.x);
-    box.y = std::max(0, box.y);
-    box.width = std::min(int(depthWidth) - box.x, box.width);
-    box.height = std::min(int(depthHeight) - box.y, box.height);
 
     // Get buffer
     CVPixelBufferLockBaseAddress(depthMap, kCVPixelBufferLock_ReadOnly);
@@ -70,3 +147,206 @@ float computeAverageDepthOfBoundingBox(Box2D box, CVPixelBufferRef depthMap, flo
 
     return float(cumulativeDepth) / float(numPixelsCounted);
 }
+
+// 1 cm histogram buckets, widened if necessary to bound the histogram size
+static constexpr size_t maxHistogramBuckets = 4096;
+
+static float histogramBucketSize(float maximumDepth, size_t *numBuckets)
+{
+    float bucketSize = std::max(0.01f, maximumDepth / float(maxHistogramBuckets - 1));
+    *numBuckets = std::min(maxHistogramBuckets, size_t(std::max(0.0f, maximumDepth) / bucketSize) + 1);
+    return bucketSize;
+}
+
+// Percentile of the valid depth values within an already clipped box. Depth map and mask must be
+// locked. The histogram is cleared and reused.
+static float depthPercentileOfClippedBox(
+    Box2D box,
+    const float *depthValues,
+    size_t depthStride,
+    const uint8_t *mask,
+    size_t maskStride,
+    uint8_t minimumConfidence,
+    float maximumDepth,
+    float percentile,
+    float bucketSize,
+    std::vector<uint32_t> &histogram
+)
+{
+    size_t numBuckets = histogram.size();
+    std::fill(histogram.begin(), histogram.end(), 0);
+
+    size_t numPixelsCounted = 0;
+    for (int yi = box.y; yi < (box.y + box.height); yi++)
+    {
+        const float *line = &depthValues[yi * depthStride];
+        const uint8_t *maskLine = mask ? &mask[yi * maskStride] : nullptr;
+        for (int xi = box.x; xi < (box.x + box.width); xi++)
+        {
+            float depth = line[xi];
+            if (depth <= maximumDepth && (!maskLine || maskLine[xi] >= minimumConfidence))
+            {
+                size_t bucket = std::min(numBuckets - 1, size_t(std::max(0.0f, depth) / bucketSize));
+                histogram[bucket] += 1;
+                numPixelsCounted += 1;
+            }
+        }
+    }
+
+    if (numPixelsCounted == 0)
+    {
+        return -1;
+    }
+
+    // Walk the cumulative distribution to the bucket containing the requested rank and report its
+    // center
+    size_t rank = size_t(std::clamp(percentile, 0.0f, 100.0f) * 1e-2f * float(numPixelsCounted - 1));
+    size_t cumulativeCount = 0;
+    size_t bucket = 0;
+    for (; bucket < numBuckets; bucket++)
+    {
+        cumulativeCount += histogram[bucket];
+        if (cumulativeCount > rank)
+        {
+            break;
+        }
+    }
+    return std::min(maximumDepth, (float(bucket) + 0.5f) * bucketSize);
+}
+
+float computeDepthPercentileOfBoundingBox(Box2D box, CVPixelBufferRef depthMap, CVPixelBufferRef segmentationMap, uint8_t minimumConfidence, float maximumDepth, float percentile)
+{
+    std::vector<Box2D> boxes(1, box);
+    return computeDepthPercentileOfBoundingBoxes(boxes, depthMap, segmentationMap, minimumConfidence, maximumDepth, percentile)[0];
+}
+
+std::vector<float> computeDepthPercentileOfBoundingBoxes(const std::vector<Box2D> &boxes, CVPixelBufferRef depthMap, CVPixelBufferRef segmentationMap, uint8_t minimumConfidence, float maximumDepth, float percentile)
+{
+    assert(CVPixelBufferGetPixelFormatType(depthMap) == kCVPixelFormatType_DepthFloat32);
+    assert(!segmentationMap || CVPixelBufferGetPixelFormatType(segmentationMap) == kCVPixelFormatType_OneComponent8);
+    assert(!segmentationMap || CVPixelBufferGetWidth(segmentationMap) == CVPixelBufferGetWidth(depthMap));
+    assert(!segmentationMap || CVPixelBufferGetHeight(segmentationMap) == CVPixelBufferGetHeight(depthMap));
+
+    size_t numBuckets;
+    float bucketSize = histogramBucketSize(maximumDepth, &numBuckets);
+    std::vector<uint32_t> histogram(numBuckets);
+
+    CVPixelBufferLockBaseAddress(depthMap, kCVPixelBufferLock_ReadOnly);
+    size_t depthWidth = CVPixelBufferGetWidth(depthMap);
+    size_t depthHeight = CVPixelBufferGetHeight(depthMap);
+    size_t depthStride = CVPixelBufferGetBytesPerRow(depthMap) / sizeof(float);
+    const float *depthValues = reinterpret_cast<const float *>(CVPixelBufferGetBaseAddress(depthMap));
+    const uint8_t *mask = nullptr;
+    size_t maskStride = 0;
+    if (segmentationMap)
+    {
+        CVPixelBufferLockBaseAddress(segmentationMap, kCVPixelBufferLock_ReadOnly);
+        maskStride = CVPixelBufferGetBytesPerRow(segmentationMap);
+        mask = reinterpret_cast<const uint8_t *>(CVPixelBufferGetBaseAddress(segmentationMap));
+    }
+
+    std::vector<float> depths;
+    depths.reserve(boxes.size());
+    for (Box2D box: boxes)
+    {
+        if (!clipBox(&box, depthWidth, depthHeight))
+        {
+            depths.emplace_back(-1);
+            continue;
+        }
+        depths.emplace_back(depthPercentileOfClippedBox(box, depthValues, depthStride, mask, maskStride, minimumConfidence, maximumDepth, percentile, bucketSize, histogram));
+    }
+
+    if (segmentationMap)
+    {
+        CVPixelBufferUnlockBaseAddress(segmentationMap, kCVPixelBufferLock_ReadOnly);
+    }
+    CVPixelBufferUnlockBaseAddress(depthMap, kCVPixelBufferLock_ReadOnly);
+
+    return depths;
+}
+
+float computeMaskedAverageDepthOfBoundingBox(Box2D box, CVPixelBufferRef depthMap, CVPixelBufferRef segmentationMap, uint8_t minimumConfidence, float maximumDepth)
+{
+    assert(CVPixelBufferGetPixelFormatType(depthMap) == kCVPixelFormatType_DepthFloat32);
+    assert(CVPixelBufferGetPixelFormatType(segmentationMap) == kCVPixelFormatType_OneComponent8);
+    assert(CVPixelBufferGetWidth(segmentationMap) == CVPixelBufferGetWidth(depthMap));
+    assert(CVPixelBufferGetHeight(segmentationMap) == CVPixelBufferGetHeight(depthMap));
+
+    if (!clipBox(&box, CVPixelBufferGetWidth(depthMap), CVPixelBufferGetHeight(depthMap)))
+    {
+        return -1;
+    }
+
+    CVPixelBufferLockBaseAddress(depthMap, kCVPixelBufferLock_ReadOnly);
+    CVPixelBufferLockBaseAddress(segmentationMap, kCVPixelBufferLock_ReadOnly);
+    size_t depthStride = CVPixelBufferGetBytesPerRow(depthMap) / sizeof(float);
+    size_t maskStride = CVPixelBufferGetBytesPerRow(segmentationMap);
+    const float *depthValues = reinterpret_cast<const float *>(CVPixelBufferGetBaseAddress(depthMap));
+    const uint8_t *mask = reinterpret_cast<const uint8_t *>(CVPixelBufferGetBaseAddress(segmentationMap));
+
+    float cumulativeDepth = 0;
+    size_t numPixelsCounted = 0;
+    for (int yi = box.y; yi < (box.y + box.height); yi++)
+    {
+        const float *line = &depthValues[yi * depthStride];
+        const uint8_t *maskLine = &mask[yi * maskStride];
+        for (int xi = box.x; xi < (box.x + box.width); xi++)
+        {
+            float depth = line[xi];
+            if (depth <= maximumDepth && maskLine[xi] >= minimumConfidence)
+            {
+                cumulativeDepth += depth;
+                numPixelsCounted += 1;
+            }
+        }
+    }
+
+    CVPixelBufferUnlockBaseAddress(segmentationMap, kCVPixelBufferLock_ReadOnly);
+    CVPixelBufferUnlockBaseAddress(depthMap, kCVPixelBufferLock_ReadOnly);
+
+    if (numPixelsCounted == 0)
+    {
+        return -1;
+    }
+
+    return cumulativeDepth / float(numPixelsCounted);
+}
+
+std::vector<float> computeAverageDepthOfBoundingBoxes(const std::vector<Box2D> &boxes, CVPixelBufferRef depthMap, float maximumDepth)
+{
+    std::vector<float> depths;
+    depths.reserve(boxes.size());
+
+    // Building the tables costs as much as scanning 1.5 to 1.8 frames' worth of box pixels
+    // (measured with DepthTest.benchmarkBoxDepth() at depth map resolution), so it only pays off
+    // when boxes overlap heavily
+    size_t depthWidth = CVPixelBufferGetWidth(depthMap);
+    size_t depthHeight = CVPixelBufferGetHeight(depthMap);
+    size_t totalBoxArea = 0;
+    for (Box2D box: boxes)
+    {
+        if (clipBox(&box, depthWidth, depthHeight))
+        {
+            totalBoxArea += size_t(box.width) * size_t(box.height);
+        }
+    }
+
+    if (float(totalBoxArea) > integralImageBreakEvenCoverage * float(depthWidth * depthHeight))
+    {
+        DepthIntegralImage integralImage(depthMap, maximumDepth);
+        for (const Box2D &box: boxes)
+        {
+            depths.emplace_back(integralImage.averageDepth(box));
+        }
+    }
+    else
+    {
+        for (const Box2D &box: boxes)
+        {
+            depths.emplace_back(computeAverageDepthOfBoundingBox(box, depthMap, maximumDepth));
+        }
+    }
+
+    return depths;
+}
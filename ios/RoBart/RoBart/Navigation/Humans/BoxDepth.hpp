@@ -25,6 +25,7 @@
 
 #include <CoreVideo/CoreVideo.h>
 #include <algorithm>
+#include <vector>
 
 struct Box2D
 {
@@ -56,6 +57,53 @@ struct Box2D
     }
 };
 
+/// Summed-area tables of depth and valid pixel count (depth no greater than a maximum), built once
+/// per depth frame, which make the average depth of any box a constant-time query.
+class DepthIntegralImage
+{
+public:
+    DepthIntegralImage(CVPixelBufferRef depthMap, float maximumDepth);
+
+    /// Average of valid depth values within a box, or -1 if the box contains none (same semantics
+    /// as computeAverageDepthOfBoundingBox()).
+    float averageDepth(Box2D box) const;
+
+private:
+    size_t _width;
+    size_t _height;
+
+    // (width + 1) x (height + 1) tables with a zero first row and column. Sums are kept in double
+    // precision so large boxes do not lose the contribution of individual pixels.
+    std::vector<double> _depthSum;
+    std::vector<uint32_t> _count;
+};
+
 extern float computeAverageDepthOfBoundingBox(Box2D box, CVPixelBufferRef depthMap, float maximumDepth);
 
+/// Computes a percentile of the valid depth values within a box using a histogram with fixed 1 cm
+/// buckets, which is linear in the number of pixels and avoids sorting. Unlike the average, the
+/// median is not pulled towards the background pixels that inevitably fall inside a bounding box.
+/// - Parameter segmentationMap: Optional segmentation mask with the same dimensions as the depth
+/// map. If supplied, only pixels at or above minimumConfidence are considered.
+/// - Parameter percentile: Percentile in [0, 100]. Use 50 for the median.
+/// - Returns: Depth at the given percentile, accurate to the bucket size, or -1 if the box contains
+/// no valid depth values.
+extern float computeDepthPercentileOfBoundingBox(Box2D box, CVPixelBufferRef depthMap, CVPixelBufferRef segmentationMap, uint8_t minimumConfidence, float maximumDepth, float percentile);
+
+/// Computes a percentile of the depth of each box as computeDepthPercentileOfBoundingBox() does,
+/// reusing a single histogram for all of them.
+/// - Returns: Depth per box, or -1 for boxes with no valid depth values.
+extern std::vector<float> computeDepthPercentileOfBoundingBoxes(const std::vector<Box2D> &boxes, CVPixelBufferRef depthMap, CVPixelBufferRef segmentationMap, uint8_t minimumConfidence, float maximumDepth, float percentile);
+
+/// Average depth of the pixels within a box that the segmentation mask labels as belonging to the
+/// object (mask value at or above minimumConfidence).
+/// - Returns: Average depth or -1 if no masked pixels within the box have valid depth values.
+extern float computeMaskedAverageDepthOfBoundingBox(Box2D box, CVPixelBufferRef depthMap, CVPixelBufferRef segmentationMap, uint8_t minimumConfidence, float maximumDepth);
+
+/// Computes the average depth of each box. When the boxes together cover enough pixels to amortize
+/// its construction (about 1.5 times the depth map), a DepthIntegralImage is built and queried;
+/// otherwise boxes are scanned directly.
+/// - Returns: Average depth per box, or -1 for boxes with no valid depth values.
+extern std::vector<float> computeAverageDepthOfBoundingBoxes(const std::vector<Box2D> &boxes, CVPixelBufferRef depthMap, float maximumDepth);
+
 #endif /* BoxDepth_hpp */
@@ -26,14 +26,39 @@ import CoreImage
 import Vision
 import UIKit
 
+/// Tracked human boxes in a depth image along with the camera parameters needed to project them
+/// into the world. Passed to `NavigationController.stampHumans()`.
+struct HumanFootprints {
+    let boxes: [Box2D]
+    let depths: [Float]
+    let depthResolution: simd_float2
+    let intrinsics: simd_float3x3
+    let rgbResolution: simd_float2
+    let viewMatrix: simd_float4x4
+    let timestamp: TimeInterval
+}
+
 func detectHumans(in frame: ARFrame, maximumDistance: Float = 2) -> [Vector3] {
+    // A fresh tracker simply reports every detection as a new track
+    var tracker = HumanTracker(0.1, 0.75, 5, 50)
+    return detectHumans(in: frame, maximumDistance: maximumDistance, tracker: &tracker, deltaTime: 0).people.map { $0.position }
+}
+
+/// Detects humans and associates them with tracks that persist across frames, allowing a specific
+/// person to be followed.
+/// - Parameter tracker: Tracker to update. Should be reused from frame to frame.
+/// - Parameter deltaTime: Time since the frame previously passed to the tracker.
+/// - Returns: Track ID and world position of each human detected in this frame, and the footprints
+/// of the tracks for the dynamic obstacle layer (`nil` if detection failed). ARFrame timestamps
+/// share the system uptime clock used by `NavigationController`.
+func detectHumans(in frame: ARFrame, maximumDistance: Float = 2, tracker: inout HumanTracker, deltaTime: Float) -> (people: [(id: UInt32, position: Vector3)], footprints: HumanFootprints?) {
     var timer = Util.Stopwatch()
     timer.start()
 
     // Get depth map and filter it to preserve only high confidence values
     guard let depthMap = frame.sceneDepth?.depthMap,
           let depthConfidence = frame.sceneDepth?.confidenceMap else {
-        return []
+        return ([], nil)
     }
     filterDepthMap(depthMap, depthConfidence, UInt8(ARConfidenceLevel.high.rawValue))
     log("Filter depth map: \(timer.elapsedMilliseconds()) ms")
@@ -62,48 +87,64 @@ func detectHumans(in frame: ARFrame, maximumDistance: Float = 2) -> [Vector3] {
         try requestHandler.perform([request])
     } catch {
         log("Error: \(error.localizedDescription)")
-        return []
+        return ([], nil)
     }
     guard let buffer = request.results?.first else {
-        return []
+        return ([], nil)
     }
     log("People segmentation: \(timer.elapsedMilliseconds()) ms")
 
     // Extract 2D boxes containing humans. Use the depth map resolution.
     timer.start()
-    guard let segmentationBuffer = buffer.pixelBuffer.resize(newWidth: depthMap.width, newHeight: depthMap.height) else { return [] }
+    guard let segmentationBuffer = buffer.pixelBuffer.resize(newWidth: depthMap.width, newHeight: depthMap.height) else { return ([], nil) }
     let boxes = findHumans(segmentationBuffer, 200)
     log("Human bounding boxes: \(timer.elapsedMilliseconds()) ms")
 
-    // Get average depth for each person
+    // Get depth for each person
     timer.start()
-    var boxesWithDepth: [(box: CGRect, distance: Float)] = []
-    for box in boxes {
-        let depth = computeAverageDepthOfBoundingBox(box, depthMap, maximumDistance)
-        if depth > 0 {
-            let cgBox = CGRect(x: CGFloat(box.x), y: CGFloat(box.y), width: CGFloat(box.width), height: CGFloat(box.height))
-            boxesWithDepth.append((box: cgBox, distance: depth))
-        }
+    // Prefer the median depth of pixels segmented as human, which is not skewed by background
+    // inside the box, falling back to the box average only when no such pixels have valid depth
+    let boxArray = Array(boxes)
+    var depths = Array(computeDepthPercentileOfBoundingBoxes(boxes, depthMap, segmentationBuffer, 200, maximumDistance, 50))
+    for i in depths.indices where depths[i] <= 0 {
+        depths[i] = computeAverageDepthOfBoundingBox(boxArray[i], depthMap, maximumDistance)
     }
     log("Depth value calculation: \(timer.elapsedMilliseconds()) ms")
 
-    // Convert to world space
-    var worldPoints: [Vector3] = []
-    for boxWithDepth in boxesWithDepth {
+    // Update tracks
+    let tracks = boxArray.withUnsafeBufferPointer { boxesPtr in
+        depths.withUnsafeBufferPointer { depthsPtr in
+            tracker.update(boxesPtr.baseAddress, depthsPtr.baseAddress, boxArray.count, deltaTime)
+        }
+    }
+
+    let footprints = HumanFootprints(
+        boxes: tracks.map { $0.box },
+        depths: tracks.map { $0.depth },
+        depthResolution: simd_float2(Float(depthMap.width), Float(depthMap.height)),
+        intrinsics: frame.camera.intrinsics,
+        rgbResolution: simd_float2(Float(frame.camera.imageResolution.width), Float(frame.camera.imageResolution.height)),
+        viewMatrix: viewMatrix,
+        timestamp: frame.timestamp
+    )
+
+    // Convert tracked humans with known depth to world space
+    var worldPoints: [(id: UInt32, position: Vector3)] = []
+    for track in tracks where track.depth > 0 {
         let worldPoint = convertDepthMapPointToWorldSpace(
-            x: Float(boxWithDepth.box.midX),
-            y: Float(boxWithDepth.box.midY),
-            distance: boxWithDepth.distance,
+            x: Float(track.box.x) + 0.5 * Float(track.box.width),
+            y: Float(track.box.y) + 0.5 * Float(track.box.height),
+            distance: track.depth,
             cameraToWorld: cameraToWorld,
             fx: fx,
             fy: fy,
             cx: cx,
             cy: cy
         )
-        worldPoints.append(worldPoint)
+        worldPoints.append((id: track.id, position: worldPoint))
     }
 
-    return worldPoints
+    return (worldPoints, footprints)
 }
 
 fileprivate func convertDepthMapPointToWorldSpace(x: Float, y: Float, distance: Float, cameraToWorld: Matrix4x4, fx: Float, fy: Float, cx: Float, cy: Float) -> Vector3 {
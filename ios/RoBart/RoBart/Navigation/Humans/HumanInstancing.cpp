@@ -21,91 +21,275 @@
 //
 
 #include "HumanInstancing.hpp"
+#include <vector>
 
-int findOverlappingBoxIndex(const std::vector<Box2D> &humans, const Box2D &box)
+#if defined(__ARM_NEON)
+#include <arm_neon.h>
+#elif defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+namespace
 {
-    for (size_t i = 0; i < humans.size(); i++)
+    // Horizontal run of confident mask pixels, [start, end] inclusive
+    struct MaskRun
+    {
+        int y;
+        int start;
+        int end;
+    };
+}
+
+// Confidence comparisons for 16 mask bytes at a time, producing a bit mask with bitsPerByte bits
+// set for each byte at or above the threshold, byte 0 in the least significant bits
+#if defined(__ARM_NEON)
+
+namespace
+{
+    using ByteMask = uint64_t;
+    constexpr int bitsPerByte = 4;
+    constexpr ByteMask allBytes = ~ByteMask(0);
+
+    struct ConfidenceComparator
     {
-        if (box.overlaps(humans[i]))
+        uint8x16_t threshold;
+
+        ConfidenceComparator(uint8_t minimumConfidence)
+            : threshold(vdupq_n_u8(minimumConfidence))
         {
-            return int(i);
         }
-    }
-    return -1;
+
+        inline ByteMask compare(const uint8_t *bytes) const
+        {
+            // Narrowing shift packs each 0x00/0xff byte into a nibble
+            uint8x16_t confident = vcgeq_u8(vld1q_u8(bytes), threshold);
+            uint8x8_t nibbles = vshrn_n_u16(vreinterpretq_u16_u8(confident), 4);
+            return vget_lane_u64(vreinterpret_u64_u8(nibbles), 0);
+        }
+    };
 }
 
-std::vector<Box2D> findHumans(CVPixelBufferRef segmentationMap, uint8_t minimumConfidence)
+#elif defined(__SSE2__)
+
+namespace
 {
-    assert(CVPixelBufferGetPixelFormatType(segmentationMap) == kCVPixelFormatType_OneComponent8);
-    int maskWidth = int(CVPixelBufferGetWidth(segmentationMap));
-    int maskHeight =  int(CVPixelBufferGetHeight(segmentationMap));
-    CVPixelBufferLockBaseAddress(segmentationMap, kCVPixelBufferLock_ReadOnly);
-    size_t offsetToNextLine = CVPixelBufferGetBytesPerRow(segmentationMap) - maskWidth;
-    const uint8_t *mask = reinterpret_cast<const uint8_t *>(CVPixelBufferGetBaseAddress(segmentationMap));
+    using ByteMask = uint32_t;
+    constexpr int bitsPerByte = 1;
+    constexpr ByteMask allBytes = 0xffff;
 
-    std::vector<Box2D> humans;
+    struct ConfidenceComparator
+    {
+        __m128i threshold;
 
-    int neighborWindowSize = 17;            // odd number, size of window (width and height) around a mask pixel to search for a neighboring rect to merge with
-    int offset = neighborWindowSize / 2;    // how many pixels in either direction window extends
+        ConfidenceComparator(uint8_t minimumConfidence)
+            : threshold(_mm_set1_epi8(char(minimumConfidence)))
+        {
+        }
+
+        inline ByteMask compare(const uint8_t *bytes) const
+        {
+            // Unsigned v >= t is equivalent to max(v, t) == v
+            __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i *>(bytes));
+            return ByteMask(_mm_movemask_epi8(_mm_cmpeq_epi8(_mm_max_epu8(v, threshold), v)));
+        }
+    };
+}
 
-    size_t i = 0;
+#endif
+
+/// Extracts runs of pixels at or above the confidence threshold, in row-major order. Where SIMD is
+/// available, 16 pixels are classified at once and only chunks containing a transition between
+/// background and foreground are examined further, so the cost is mostly proportional to the
+/// number of runs rather than the number of pixels.
+/// - Parameter runs: Runs are appended here.
+/// - Parameter rowStart: Filled with maskHeight + 1 entries, where the runs of row y are at
+/// indices [rowStart[y], rowStart[y + 1]).
+static void extractRuns(std::vector<MaskRun> *runs, std::vector<size_t> *rowStart, const uint8_t *mask, int maskWidth, int maskHeight, size_t bytesPerRow, uint8_t minimumConfidence)
+{
+#if defined(__ARM_NEON) || defined(__SSE2__)
+    ConfidenceComparator comparator(minimumConfidence);
+#endif
+
+    rowStart->resize(maskHeight + 1);
     for (int yi = 0; yi < maskHeight; yi++)
     {
-        for (int xi = 0; xi < maskWidth; xi++)
+        (*rowStart)[yi] = runs->size();
+        const uint8_t *line = &mask[yi * bytesPerRow];
+        bool inRun = false;
+        int start = 0;
+        int xi = 0;
+
+#if defined(__ARM_NEON) || defined(__SSE2__)
+        for (; xi + 16 <= maskWidth; xi += 16)
+        {
+            ByteMask confident = comparator.compare(&line[xi]);
+
+            // Skip uniform chunks that continue the current state
+            ByteMask transitions = inRun ? (~confident & allBytes) : confident;
+            while (transitions != 0)
+            {
+                // Position of next transition within chunk
+                int pos = __builtin_ctzll(transitions) / bitsPerByte;
+                if (inRun)
+                {
+                    runs->emplace_back(MaskRun{ .y = yi, .start = start, .end = xi + pos - 1 });
+                }
+                else
+                {
+                    start = xi + pos;
+                }
+                inRun = !inRun;
+
+                // Look for the opposite transition beyond this point
+                ByteMask notYetConsumed = allBytes & ~((ByteMask(1) << (pos * bitsPerByte)) - 1);
+                transitions = (inRun ? (~confident & allBytes) : confident) & notYetConsumed;
+            }
+        }
+#endif
+
+        // Remaining pixels
+        for (; xi < maskWidth; xi++)
         {
-            if (mask[i++] < minimumConfidence)
+            bool confident = line[xi] >= minimumConfidence;
+            if (confident && !inRun)
+            {
+                start = xi;
+                inRun = true;
+            }
+            else if (!confident && inRun)
             {
-                continue;
+                runs->emplace_back(MaskRun{ .y = yi, .start = start, .end = xi - 1 });
+                inRun = false;
             }
+        }
+        if (inRun)
+        {
+            runs->emplace_back(MaskRun{ .y = yi, .start = start, .end = maskWidth - 1 });
+        }
+    }
+    (*rowStart)[maskHeight] = runs->size();
+}
 
-            // We have found a human pixel. Check to see if there are any existing human boxes
-            // nearby that it might belong to.
-            Box2D neighborhood = {.x = xi - offset, .y = yi - offset, .width = neighborWindowSize, .height = neighborWindowSize};
-            int humanIdx = findOverlappingBoxIndex(humans, neighborhood);
-            if (humanIdx < 0)
+static int findRoot(std::vector<int> &parent, int i)
+{
+    while (parent[i] != i)
+    {
+        parent[i] = parent[parent[i]];  // path halving
+        i = parent[i];
+    }
+    return i;
+}
+
+static void unite(std::vector<int> &parent, int a, int b)
+{
+    a = findRoot(parent, a);
+    b = findRoot(parent, b);
+    if (a != b)
+    {
+        // Lower index becomes root so components are ordered by first appearance
+        parent[std::max(a, b)] = std::min(a, b);
+    }
+}
+
+/// Groups runs into humans. Two pixels belong to the same human if they are within linkDistance
+/// of each other in both x and y, which is equivalent to labeling connected components of the mask
+/// dilated by a (2 * linkDistance + 1)-pixel square window, but done directly on the runs. Bounding
+/// boxes that still overlap afterwards are merged.
+static std::vector<Box2D> labelRuns(const std::vector<MaskRun> &maskRuns, const std::vector<size_t> &maskRowStart, int linkDistance)
+{
+    // Runs on the same row separated by no more than linkDistance are always linked. Coalesce them
+    // into single spans first, which is exact: every pixel in a gap is within linkDistance / 2 of
+    // a confident pixel at either end of it, so anything close enough to the gap is close enough
+    // to the runs.
+    int maskHeight = int(maskRowStart.size()) - 1;
+    std::vector<MaskRun> runs;
+    std::vector<size_t> rowStart(maskHeight + 1);
+    runs.reserve(maskRuns.size());
+    for (int yi = 0; yi < maskHeight; yi++)
+    {
+        rowStart[yi] = runs.size();
+        for (size_t r = maskRowStart[yi]; r < maskRowStart[yi + 1]; r++)
+        {
+            if (runs.size() > rowStart[yi] && maskRuns[r].start - runs.back().end <= linkDistance)
             {
-                // New human found, start with a single pixel box
-                humans.emplace_back(Box2D{.x = xi, .y = yi, .width = 1, .height = 1});
+                runs.back().end = maskRuns[r].end;
             }
             else
             {
-                // An existing human was found and its bounding box needs to be expanded
-                Box2D existingBox = humans[humanIdx];
-                int x2 = existingBox.x + existingBox.width - 1;
-                int y2 = existingBox.y + existingBox.height - 1;
-                x2 = std::max(x2, xi);
-                y2 = std::max(y2, yi);
-                int width = x2 - existingBox.x + 1;
-                int height = y2 - existingBox.y + 1;
-                existingBox = Box2D{.x = existingBox.x, .y = existingBox.y, .width = width, .height = height};
-
-                // Move this box to the front of the list by swapping it with first element
-                // because it is likely that this box will be tested again next
-                humans[humanIdx] = humans[0];
-                humans[0] = existingBox;
+                runs.emplace_back(maskRuns[r]);
             }
+        }
+    }
+    rowStart[maskHeight] = runs.size();
 
+    std::vector<int> parent(runs.size());
+    for (size_t i = 0; i < runs.size(); i++)
+    {
+        parent[i] = int(i);
+    }
+
+    // Each row is linked against the preceding linkDistance rows. Runs within a row are sorted and
+    // disjoint, so a cursor per preceding row only ever advances while sweeping the current row.
+    std::vector<size_t> cursor(linkDistance + 1);
+    for (int yi = 0; yi < maskHeight; yi++)
+    {
+        int firstRow = std::max(0, yi - linkDistance);
+        for (int row = firstRow; row < yi; row++)
+        {
+            cursor[yi - row] = rowStart[row];
+        }
+
+        for (size_t r = rowStart[yi]; r < rowStart[yi + 1]; r++)
+        {
+            const MaskRun &run = runs[r];
+            for (int row = firstRow; row < yi; row++)
+            {
+                size_t &c = cursor[yi - row];
+                while (c < rowStart[row + 1] && runs[c].end < run.start - linkDistance)
+                {
+                    c++;
+                }
+                for (size_t other = c; other < rowStart[row + 1] && runs[other].start <= run.end + linkDistance; other++)
+                {
+                    unite(parent, int(r), int(other));
+                }
+            }
         }
+    }
 
-        i += offsetToNextLine;
+    // Accumulate a bounding box per component
+    std::vector<Box2D> humans;
+    std::vector<int> humanIdxByRoot(runs.size(), -1);
+    for (size_t r = 0; r < runs.size(); r++)
+    {
+        const MaskRun &run = runs[r];
+        Box2D box{ .x = run.start, .y = run.y, .width = run.end - run.start + 1, .height = 1 };
+        int root = findRoot(parent, int(r));
+        if (humanIdxByRoot[root] < 0)
+        {
+            humanIdxByRoot[root] = int(humans.size());
+            humans.emplace_back(box);
+        }
+        else
+        {
+            humans[humanIdxByRoot[root]].mergeWith(box);
+        }
     }
 
-    // Merge overlapping boxes
-    bool mergedSomething = false;
+    // Merge overlapping boxes. There are only a handful of components at this point.
+    std::vector<bool> absorbed(humans.size(), false);
+    bool mergedSomething;
     do
     {
         mergedSomething = false;
-        for (int i = 0; i < humans.size(); i++)
+        for (size_t i = 0; i < humans.size(); i++)
         {
-            // Merge current with all subsequent
-            for (int j = i + 1; j < humans.size(); j++)
+            for (size_t j = i + 1; j < humans.size() && !absorbed[i]; j++)
             {
-                if (humans[i].overlaps(humans[j]))
+                if (!absorbed[j] && humans[i].overlaps(humans[j]))
                 {
-                    // Merge and replace the first box. Remove the second.
                     humans[i].mergeWith(humans[j]);
-                    humans.erase(humans.begin() + j);
-                    j -= 1;
+                    absorbed[j] = true;
                     mergedSomething = true;
                 }
             }
@@ -113,6 +297,205 @@ std::vector<Box2D> findHumans(CVPixelBufferRef segmentationMap, uint8_t minimumC
     }
     while (mergedSomething);
 
+    size_t numHumans = 0;
+    for (size_t i = 0; i < humans.size(); i++)
+    {
+        if (!absorbed[i])
+        {
+            humans[numHumans++] = humans[i];
+        }
+    }
+    humans.resize(numHumans);
+    return humans;
+}
+
+std::vector<Box2D> findHumans(CVPixelBufferRef segmentationMap, uint8_t minimumConfidence)
+{
+    assert(CVPixelBufferGetPixelFormatType(segmentationMap) == kCVPixelFormatType_OneComponent8);
+    int maskWidth = int(CVPixelBufferGetWidth(segmentationMap));
+    int maskHeight =  int(CVPixelBufferGetHeight(segmentationMap));
+    CVPixelBufferLockBaseAddress(segmentationMap, kCVPixelBufferLock_ReadOnly);
+    size_t bytesPerRow = CVPixelBufferGetBytesPerRow(segmentationMap);
+    const uint8_t *mask = reinterpret_cast<const uint8_t *>(CVPixelBufferGetBaseAddress(segmentationMap));
+
+    int neighborWindowSize = 17;            // odd number, size of window (width and height) around a mask pixel within which other pixels belong to the same human
+    int offset = neighborWindowSize / 2;    // how many pixels in either direction window extends
+
+    std::vector<MaskRun> runs;
+    std::vector<size_t> rowStart;
+    extractRuns(&runs, &rowStart, mask, maskWidth, maskHeight, bytesPerRow, minimumConfidence);
+
+    CVPixelBufferUnlockBaseAddress(segmentationMap, kCVPixelBufferLock_ReadOnly);
+
+    return labelRuns(runs, rowStart, offset);
+}
+
+/// Downsamples a mask by 2 in each dimension, keeping the maximum of each 2x2 block. Odd trailing
+/// rows and columns are pooled with themselves.
+static void maxPool2x(std::vector<uint8_t> *pooled, int *pooledWidth, int *pooledHeight, const uint8_t *mask, int maskWidth, int maskHeight, size_t bytesPerRow)
+{
+    int width = (maskWidth + 1) / 2;
+    int height = (maskHeight + 1) / 2;
+    pooled->resize(size_t(width) * size_t(height));
+    *pooledWidth = width;
+    *pooledHeight = height;
+
+    for (int yi = 0; yi < height; yi++)
+    {
+        const uint8_t *row0 = &mask[size_t(2 * yi) * bytesPerRow];
+        const uint8_t *row1 = &mask[size_t(std::min(2 * yi + 1, maskHeight - 1)) * bytesPerRow];
+        uint8_t *out = &(*pooled)[size_t(yi) * size_t(width)];
+        int xi = 0;
+
+#if defined(__ARM_NEON)
+        for (; 2 * xi + 32 <= maskWidth; xi += 16)
+        {
+            uint8x16_t a = vmaxq_u8(vld1q_u8(&row0[2 * xi]), vld1q_u8(&row1[2 * xi]));
+            uint8x16_t b = vmaxq_u8(vld1q_u8(&row0[2 * xi + 16]), vld1q_u8(&row1[2 * xi + 16]));
+            uint8x16x2_t evenOdd = vuzpq_u8(a, b);
+            vst1q_u8(&out[xi], vmaxq_u8(evenOdd.val[0], evenOdd.val[1]));
+        }
+#elif defined(__SSE2__)
+        __m128i lowBytes = _mm_set1_epi16(0x00ff);
+        for (; 2 * xi + 32 <= maskWidth; xi += 16)
+        {
+            __m128i a = _mm_max_epu8(_mm_loadu_si128(reinterpret_cast<const __m128i *>(&row0[2 * xi])), _mm_loadu_si128(reinterpret_cast<const __m128i *>(&row1[2 * xi])));
+            __m128i b = _mm_max_epu8(_mm_loadu_si128(reinterpret_cast<const __m128i *>(&row0[2 * xi + 16])), _mm_loadu_si128(reinterpret_cast<const __m128i *>(&row1[2 * xi + 16])));
+
+            // Maximum of each even/odd byte pair lands in the low byte of each 16-bit lane
+            a = _mm_and_si128(_mm_max_epu8(a, _mm_srli_epi16(a, 8)), lowBytes);
+            b = _mm_and_si128(_mm_max_epu8(b, _mm_srli_epi16(b, 8)), lowBytes);
+            _mm_storeu_si128(reinterpret_cast<__m128i *>(&out[xi]), _mm_packus_epi16(a, b));
+        }
+#endif
+
+        for (; xi < width; xi++)
+        {
+            int x0 = 2 * xi;
+            int x1 = std::min(2 * xi + 1, maskWidth - 1);
+            out[xi] = std::max(std::max(row0[x0], row0[x1]), std::max(row1[x0], row1[x1]));
+        }
+    }
+}
+
+static bool rowHasConfidentPixel(const uint8_t *mask, size_t bytesPerRow, int y, int x0, int x1, uint8_t minimumConfidence)
+{
+    const uint8_t *line = &mask[size_t(y) * bytesPerRow];
+    for (int xi = x0; xi <= x1; xi++)
+    {
+        if (line[xi] >= minimumConfidence)
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
+static bool columnHasConfidentPixel(const uint8_t *mask, size_t bytesPerRow, int x, int y0, int y1, uint8_t minimumConfidence)
+{
+    for (int yi = y0; yi <= y1; yi++)
+    {
+        if (mask[size_t(yi) * bytesPerRow + x] >= minimumConfidence)
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
+/// Maps a box found on a mask pooled by factor back to full resolution. Each border row and column
+/// of the coarse box contains a confident pooled pixel, so the exact edges lie within the factor
+/// full resolution rows or columns beneath it.
+static Box2D refineBox(const Box2D &coarseBox, int factor, const uint8_t *mask, int maskWidth, int maskHeight, size_t bytesPerRow, uint8_t minimumConfidence)
+{
+    int x0 = coarseBox.x * factor;
+    int y0 = coarseBox.y * factor;
+    int x1 = std::min(maskWidth, (coarseBox.x + coarseBox.width) * factor) - 1;
+    int y1 = std::min(maskHeight, (coarseBox.y + coarseBox.height) * factor) - 1;
+
+    int top = y0;
+    int bottom = y1;
+    int left = x0;
+    int right = x1;
+    for (int yi = y0; yi <= std::min(y0 + factor - 1, y1); yi++)
+    {
+        if (rowHasConfidentPixel(mask, bytesPerRow, yi, x0, x1, minimumConfidence))
+        {
+            top = yi;
+            break;
+        }
+    }
+    for (int yi = y1; yi >= std::max(y1 - factor + 1, top); yi--)
+    {
+        if (rowHasConfidentPixel(mask, bytesPerRow, yi, x0, x1, minimumConfidence))
+        {
+            bottom = yi;
+            break;
+        }
+    }
+    for (int xi = x0; xi <= std::min(x0 + factor - 1, x1); xi++)
+    {
+        if (columnHasConfidentPixel(mask, bytesPerRow, xi, top, bottom, minimumConfidence))
+        {
+            left = xi;
+            break;
+        }
+    }
+    for (int xi = x1; xi >= std::max(x1 - factor + 1, left); xi--)
+    {
+        if (columnHasConfidentPixel(mask, bytesPerRow, xi, top, bottom, minimumConfidence))
+        {
+            right = xi;
+            break;
+        }
+    }
+
+    return Box2D{ .x = left, .y = top, .width = right - left + 1, .height = bottom - top + 1 };
+}
+
+std::vector<Box2D> findHumansMultiResolution(CVPixelBufferRef segmentationMap, uint8_t minimumConfidence, int downsampleFactor)
+{
+    assert(downsampleFactor == 1 || downsampleFactor == 2 || downsampleFactor == 4);
+    if (downsampleFactor <= 1)
+    {
+        return findHumans(segmentationMap, minimumConfidence);
+    }
+
+    assert(CVPixelBufferGetPixelFormatType(segmentationMap) == kCVPixelFormatType_OneComponent8);
+    int maskWidth = int(CVPixelBufferGetWidth(segmentationMap));
+    int maskHeight =  int(CVPixelBufferGetHeight(segmentationMap));
+    CVPixelBufferLockBaseAddress(segmentationMap, kCVPixelBufferLock_ReadOnly);
+    size_t bytesPerRow = CVPixelBufferGetBytesPerRow(segmentationMap);
+    const uint8_t *mask = reinterpret_cast<const uint8_t *>(CVPixelBufferGetBaseAddress(segmentationMap));
+
+    // Build the pyramid down to the requested level
+    std::vector<uint8_t> pooled[2];
+    int pooledWidth = maskWidth;
+    int pooledHeight = maskHeight;
+    const uint8_t *level = mask;
+    size_t levelBytesPerRow = bytesPerRow;
+    int factor = 1;
+    for (int i = 0; factor < downsampleFactor; i++, factor *= 2)
+    {
+        maxPool2x(&pooled[i & 1], &pooledWidth, &pooledHeight, level, pooledWidth, pooledHeight, levelBytesPerRow);
+        level = pooled[i & 1].data();
+        levelBytesPerRow = size_t(pooledWidth);
+    }
+
+    // Group at the coarse level using the same neighborhood as findHumans(), scaled down
+    int neighborWindowSize = 17;
+    int offset = neighborWindowSize / 2;
+    int coarseOffset = (offset + factor - 1) / factor;
+    std::vector<MaskRun> runs;
+    std::vector<size_t> rowStart;
+    extractRuns(&runs, &rowStart, level, pooledWidth, pooledHeight, levelBytesPerRow, minimumConfidence);
+    std::vector<Box2D> humans = labelRuns(runs, rowStart, coarseOffset);
+
+    for (Box2D &box: humans)
+    {
+        box = refineBox(box, factor, mask, maskWidth, maskHeight, bytesPerRow, minimumConfidence);
+    }
+
     CVPixelBufferUnlockBaseAddress(segmentationMap, kCVPixelBufferLock_ReadOnly);
     return humans;
 }
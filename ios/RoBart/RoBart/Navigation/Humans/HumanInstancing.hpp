@@ -29,4 +29,11 @@
 
 extern std::vector<Box2D> findHumans(CVPixelBufferRef segmentationMap, uint8_t minimumConfidence);
 
+/// Like findHumans() but groups pixels into humans on a copy of the mask max-pooled by
+/// downsampleFactor, then refines each box edge by examining only the full resolution rows and
+/// columns under the border cells of the coarse box. Boxes are exact for the pixels they contain;
+/// grouping is performed at the coarser resolution.
+/// - Parameter downsampleFactor: 1, 2, or 4.
+extern std::vector<Box2D> findHumansMultiResolution(CVPixelBufferRef segmentationMap, uint8_t minimumConfidence, int downsampleFactor);
+
 #endif /* HumanInstancing_hpp */
@@ -0,0 +1,296 @@
+//
+//  HumanPerceptionPipeline.cpp
+//  RoBart
+//
+//  Created by Bart Trzynadlowski on 10/16/26.
+//
+//  This file is part of RoBart.
+//
+//  RoBart is free software: you can redistribute it and/or modify it under the
+//  terms of the GNU General Public License as published by the Free Software
+//  Foundation, either version 3 of the License, or (at your option) any later
+//  version.
+//
+//  RoBart is distributed in the hope that it will be useful, but WITHOUT
+//  ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+//  FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+//  more details.
+//
+//  You should have received a copy of the GNU General Public License along
+//  with RoBart. If not, see <http://www.gnu.org/licenses/>.
+//
+
+#include "HumanPerceptionPipeline.hpp"
+#include "FilterDepthMap.hpp"
+#include "HumanInstancing.hpp"
+#include "ThreadPool.hpp"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+
+using Clock = std::chrono::steady_clock;
+
+static float millisecondsSince(Clock::time_point start)
+{
+    return std::chrono::duration<float, std::milli>(Clock::now() - start).count();
+}
+
+struct HumanPerceptionPipeline::Impl
+{
+    static constexpr size_t numSlots = 2;
+    static constexpr size_t numStages = 4;
+
+    struct FrameSlot
+    {
+        bool busy = false;
+        uint64_t frameId = 0;
+        CVPixelBufferRef depthMap = nullptr;
+        CVPixelBufferRef confidenceMap = nullptr;
+        CVPixelBufferRef segmentationMap = nullptr;
+        std::vector<Box2D> boxes;
+        std::vector<float> depths;
+        std::atomic<int> pendingFirstStages{ 0 };
+        Clock::time_point submitTime;
+    };
+
+    uint8_t minimumDepthConfidence;
+    uint8_t minimumSegmentationConfidence;
+    float maximumDepth;
+
+    mutable std::mutex mutex;
+    std::condition_variable slotFreed;
+    FrameSlot slots[numSlots];
+    uint64_t numSubmitted = 0;
+    uint64_t numDropped = 0;
+    uint64_t numCompleted = 0;
+    uint32_t histograms[numStages][numLatencyBuckets] = {};
+    HumanPerceptionResult latest;
+    bool hasNewResult = false;
+
+    // Declared last so that it is destroyed first, joining the workers before anything they use
+    ThreadPool pool{ 3 };
+
+    Impl(uint8_t minimumDepthConfidence, uint8_t minimumSegmentationConfidence, float maximumDepth)
+        : minimumDepthConfidence(minimumDepthConfidence),
+          minimumSegmentationConfidence(minimumSegmentationConfidence),
+          maximumDepth(maximumDepth)
+    {
+    }
+
+    ~Impl()
+    {
+        waitUntilIdle();
+    }
+
+    void waitUntilIdle()
+    {
+        std::unique_lock<std::mutex> lock(mutex);
+        slotFreed.wait(lock, [this]()
+        {
+            return std::none_of(std::begin(slots), std::end(slots), [](const FrameSlot &slot) { return slot.busy; });
+        });
+    }
+
+    void recordLatency(PerceptionStage stage, float milliseconds)
+    {
+        size_t bucket = std::min(numLatencyBuckets - 1, size_t(std::max(0.0f, milliseconds) / latencyBucketMilliseconds));
+        std::lock_guard<std::mutex> lock(mutex);
+        histograms[size_t(stage)][bucket] += 1;
+    }
+
+    void firstStageFinished(FrameSlot *slot)
+    {
+        if (--slot->pendingFirstStages == 0)
+        {
+            pool.enqueue([this, slot]() { estimateBoxDepths(slot); });
+        }
+    }
+
+    void filterDepth(FrameSlot *slot)
+    {
+        Clock::time_point start = Clock::now();
+        filterDepthMap(slot->depthMap, slot->confidenceMap, minimumDepthConfidence);
+        recordLatency(PerceptionStage::FilterDepth, millisecondsSince(start));
+        firstStageFinished(slot);
+    }
+
+    void instanceHumans(FrameSlot *slot)
+    {
+        Clock::time_point start = Clock::now();
+        slot->boxes = findHumans(slot->segmentationMap, minimumSegmentationConfidence);
+        recordLatency(PerceptionStage::FindHumans, millisecondsSince(start));
+        firstStageFinished(slot);
+    }
+
+    void estimateBoxDepths(FrameSlot *slot)
+    {
+        // Same estimate as detectHumans(): median depth of human pixels, else the box average,
+        // which is only computed for the boxes that need it
+        Clock::time_point start = Clock::now();
+        slot->depths = computeDepthPercentileOfBoundingBoxes(slot->boxes, slot->depthMap, slot->segmentationMap, minimumSegmentationConfidence, maximumDepth, 50);
+        std::vector<size_t> fallbackIndices;
+        std::vector<Box2D> fallbackBoxes;
+        for (size_t i = 0; i < slot->depths.size(); i++)
+        {
+            if (slot->depths[i] <= 0)
+            {
+                fallbackIndices.emplace_back(i);
+                fallbackBoxes.emplace_back(slot->boxes[i]);
+            }
+        }
+        if (!fallbackBoxes.empty())
+        {
+            std::vector<float> averageDepths = computeAverageDepthOfBoundingBoxes(fallbackBoxes, slot->depthMap, maximumDepth);
+            for (size_t i = 0; i < fallbackIndices.size(); i++)
+            {
+                slot->depths[fallbackIndices[i]] = averageDepths[i];
+            }
+        }
+        recordLatency(PerceptionStage::BoxDepth, millisecondsSince(start));
+        recordLatency(PerceptionStage::Total, millisecondsSince(slot->submitTime));
+
+        CVPixelBufferRelease(slot->depthMap);
+        CVPixelBufferRelease(slot->confidenceMap);
+        CVPixelBufferRelease(slot->segmentationMap);
+
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+
+            // Slots can finish out of order. Never replace a newer result with an older one.
+            if (slot->frameId >= latest.frameId)
+            {
+                latest.frameId = slot->frameId;
+                latest.boxes.swap(slot->boxes);
+                latest.depths.swap(slot->depths);
+                hasNewResult = true;
+            }
+            numCompleted += 1;
+            slot->busy = false;
+        }
+        slotFreed.notify_all();
+    }
+};
+
+HumanPerceptionPipeline::HumanPerceptionPipeline(uint8_t minimumDepthConfidence, uint8_t minimumSegmentationConfidence, float maximumDepth)
+    : _impl(std::make_shared<Impl>(minimumDepthConfidence, minimumSegmentationConfidence, maximumDepth))
+{
+}
+
+bool HumanPerceptionPipeline::submit(uint64_t frameId, CVPixelBufferRef depthMap, CVPixelBufferRef confidenceMap, CVPixelBufferRef segmentationMap)
+{
+    Impl::FrameSlot *slot = nullptr;
+    {
+        std::lock_guard<std::mutex> lock(_impl->mutex);
+        _impl->numSubmitted += 1;
+        for (Impl::FrameSlot &candidate: _impl->slots)
+        {
+            if (!candidate.busy)
+            {
+                slot = &candidate;
+                break;
+            }
+        }
+        if (!slot)
+        {
+            _impl->numDropped += 1;
+            return false;
+        }
+        slot->busy = true;
+    }
+
+    slot->frameId = frameId;
+    slot->depthMap = CVPixelBufferRetain(depthMap);
+    slot->confidenceMap = CVPixelBufferRetain(confidenceMap);
+    slot->segmentationMap = CVPixelBufferRetain(segmentationMap);
+    slot->submitTime = Clock::now();
+    slot->pendingFirstStages = 2;
+
+    Impl *impl = _impl.get();
+    impl->pool.enqueue([impl, slot]() { impl->filterDepth(slot); });
+    impl->pool.enqueue([impl, slot]() { impl->instanceHumans(slot); });
+    return true;
+}
+
+bool HumanPerceptionPipeline::takeLatestResult(HumanPerceptionResult *result)
+{
+    std::lock_guard<std::mutex> lock(_impl->mutex);
+    if (!_impl->hasNewResult)
+    {
+        return false;
+    }
+    *result = _impl->latest;
+    _impl->hasNewResult = false;
+    return true;
+}
+
+void HumanPerceptionPipeline::waitUntilIdle()
+{
+    _impl->waitUntilIdle();
+}
+
+uint64_t HumanPerceptionPipeline::submittedFrames() const
+{
+    std::lock_guard<std::mutex> lock(_impl->mutex);
+    return _impl->numSubmitted;
+}
+
+uint64_t HumanPerceptionPipeline::droppedFrames() const
+{
+    std::lock_guard<std::mutex> lock(_impl->mutex);
+    return _impl->numDropped;
+}
+
+uint64_t HumanPerceptionPipeline::completedFrames() const
+{
+    std::lock_guard<std::mutex> lock(_impl->mutex);
+    return _impl->numCompleted;
+}
+
+uint32_t HumanPerceptionPipeline::latencyHistogramCount(PerceptionStage stage, size_t bucket) const
+{
+    if (bucket >= numLatencyBuckets)
+    {
+        return 0;
+    }
+    std::lock_guard<std::mutex> lock(_impl->mutex);
+    return _impl->histograms[size_t(stage)][bucket];
+}
+
+float HumanPerceptionPipeline::latencyPercentile(PerceptionStage stage, float percentile) const
+{
+    std::lock_guard<std::mutex> lock(_impl->mutex);
+    const uint32_t *histogram = _impl->histograms[size_t(stage)];
+    uint64_t total = 0;
+    for (size_t i = 0; i < numLatencyBuckets; i++)
+    {
+        total += histogram[i];
+    }
+    if (total == 0)
+    {
+        return 0;
+    }
+
+    uint64_t rank = uint64_t(std::clamp(percentile, 0.0f, 100.0f) * 1e-2f * float(total - 1));
+    uint64_t cumulativeCount = 0;
+    size_t bucket = 0;
+    for (; bucket < numLatencyBuckets - 1; bucket++)
+    {
+        cumulativeCount += histogram[bucket];
+        if (cumulativeCount > rank)
+        {
+            break;
+        }
+    }
+    return float(bucket + 1) * latencyBucketMilliseconds;
+}
+
+void HumanPerceptionPipeline::resetStatistics()
+{
+    std::lock_guard<std::mutex> lock(_impl->mutex);
+    _impl->numSubmitted = 0;
+    _impl->numDropped = 0;
+    _impl->numCompleted = 0;
+    std::fill(&_impl->histograms[0][0], &_impl->histograms[0][0] + Impl::numStages * numLatencyBuckets, 0);
+}
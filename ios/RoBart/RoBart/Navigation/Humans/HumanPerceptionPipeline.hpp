@@ -0,0 +1,96 @@
+//
+//  HumanPerceptionPipeline.hpp
+//  RoBart
+//
+//  Created by Bart Trzynadlowski on 10/16/26.
+//
+//  This file is part of RoBart.
+//
+//  RoBart is free software: you can redistribute it and/or modify it under the
+//  terms of the GNU General Public License as published by the Free Software
+//  Foundation, either version 3 of the License, or (at your option) any later
+//  version.
+//
+//  RoBart is distributed in the hope that it will be useful, but WITHOUT
+//  ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+//  FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+//  more details.
+//
+//  You should have received a copy of the GNU General Public License along
+//  with RoBart. If not, see <http://www.gnu.org/licenses/>.
+//
+
+#ifndef HumanPerceptionPipeline_hpp
+#define HumanPerceptionPipeline_hpp
+
+#include "BoxDepth.hpp"
+#include <CoreVideo/CoreVideo.h>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+enum class PerceptionStage
+{
+    FilterDepth,
+    FindHumans,
+    BoxDepth,
+    Total
+};
+
+struct HumanPerceptionResult
+{
+    uint64_t frameId = 0;
+    std::vector<Box2D> boxes;
+
+    /// Depth of each box, or -1 if unknown.
+    std::vector<float> depths;
+};
+
+/// Runs the per-frame human perception stages (depth filtering, human instancing from the
+/// segmentation mask, and per-box depth estimation) on a small thread pool. Depth filtering and
+/// instancing of a frame run concurrently, and two frame slots allow box depth estimation of one
+/// frame to overlap with the first stages of the next. Frames submitted while both slots are busy
+/// are dropped rather than queued, so results never fall behind the camera.
+///
+/// Copies share the same underlying pipeline.
+class HumanPerceptionPipeline
+{
+public:
+    static constexpr size_t numLatencyBuckets = 64;
+    static constexpr float latencyBucketMilliseconds = 0.5f;
+
+    HumanPerceptionPipeline(uint8_t minimumDepthConfidence, uint8_t minimumSegmentationConfidence, float maximumDepth);
+
+    /// Submits a frame for processing. The buffers are retained until processing finishes. The
+    /// depth map is filtered in place.
+    /// - Parameter segmentationMap: Person segmentation mask at depth map resolution.
+    /// - Returns: False if the frame was dropped because the pipeline is full.
+    bool submit(uint64_t frameId, CVPixelBufferRef depthMap, CVPixelBufferRef confidenceMap, CVPixelBufferRef segmentationMap);
+
+    /// Retrieves the most recently completed result if it has not been retrieved already.
+    /// - Returns: True if a new result was written.
+    bool takeLatestResult(HumanPerceptionResult *result);
+
+    /// Blocks until all submitted frames have been processed.
+    void waitUntilIdle();
+
+    uint64_t submittedFrames() const;
+    uint64_t droppedFrames() const;
+    uint64_t completedFrames() const;
+
+    /// Number of latency samples of a stage in a histogram bucket. Each bucket spans
+    /// latencyBucketMilliseconds and the last one also collects everything beyond.
+    uint32_t latencyHistogramCount(PerceptionStage stage, size_t bucket) const;
+
+    /// Latency percentile of a stage estimated from its histogram (upper bucket edge, in ms).
+    float latencyPercentile(PerceptionStage stage, float percentile) const;
+
+    void resetStatistics();
+
+private:
+    struct Impl;
+    std::shared_ptr<Impl> _impl;
+};
+
+#endif /* HumanPerceptionPipeline_hpp */
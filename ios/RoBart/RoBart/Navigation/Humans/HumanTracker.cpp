@@ -0,0 +1,235 @@
+//
+//  HumanTracker.cpp
+//  RoBart
+//
+//  Created by Bart Trzynadlowski on 10/16/26.
+//
+//  This file is part of RoBart.
+//
+//  RoBart is free software: you can redistribute it and/or modify it under the
+//  terms of the GNU General Public License as published by the Free Software
+//  Foundation, either version 3 of the License, or (at your option) any later
+//  version.
+//
+//  RoBart is distributed in the hope that it will be useful, but WITHOUT
+//  ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+//  FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+//  more details.
+//
+//  You should have received a copy of the GNU General Public License along
+//  with RoBart. If not, see <http://www.gnu.org/licenses/>.
+//
+
+#include "HumanTracker.hpp"
+#include <algorithm>
+#include <cmath>
+
+// Filter noise parameters. Box centers are in pixels and depth in meters.
+static constexpr float pixelMeasurementVariance = 4.0f;
+static constexpr float pixelAccelerationVariance = 400.0f;
+static constexpr float pixelVelocityVariance = 1e4f;
+static constexpr float depthMeasurementVariance = 0.01f;
+static constexpr float depthAccelerationVariance = 1.0f;
+static constexpr float depthVelocityVariance = 1.0f;
+
+// Weight of the newest measurement in the exponential smoothing of box dimensions
+static constexpr float sizeSmoothing = 0.5f;
+
+static float intersectionOverUnion(const Box2D &a, const Box2D &b)
+{
+    int x1 = std::max(a.x, b.x);
+    int y1 = std::max(a.y, b.y);
+    int x2 = std::min(a.x + a.width, b.x + b.width);
+    int y2 = std::min(a.y + a.height, b.y + b.height);
+    if (x2 <= x1 || y2 <= y1)
+    {
+        return 0;
+    }
+    float intersection = float(x2 - x1) * float(y2 - y1);
+    float unionArea = float(a.width) * float(a.height) + float(b.width) * float(b.height) - intersection;
+    return intersection / unionArea;
+}
+
+void HumanTracker::AxisFilter::initialize(float measurement, float measurementVariance, float velocityVariance)
+{
+    position = measurement;
+    velocity = 0;
+    p00 = measurementVariance;
+    p01 = 0;
+    p11 = velocityVariance;
+}
+
+void HumanTracker::AxisFilter::predict(float deltaTime, float accelerationVariance)
+{
+    // x' = F x, P' = F P F^T + Q, with F = [1 dt; 0 1] and Q from white noise acceleration
+    float dt = deltaTime;
+    float dt2 = dt * dt;
+    position += velocity * dt;
+    p00 += 2 * dt * p01 + dt2 * p11 + 0.25f * dt2 * dt2 * accelerationVariance;
+    p01 += dt * p11 + 0.5f * dt2 * dt * accelerationVariance;
+    p11 += dt2 * accelerationVariance;
+}
+
+void HumanTracker::AxisFilter::correct(float measurement, float measurementVariance)
+{
+    // Only position is measured: H = [1 0]
+    float s = p00 + measurementVariance;
+    float k0 = p00 / s;
+    float k1 = p01 / s;
+    float residual = measurement - position;
+    position += k0 * residual;
+    velocity += k1 * residual;
+    float newP00 = (1 - k0) * p00;
+    float newP01 = (1 - k0) * p01;
+    float newP11 = p11 - k1 * p01;
+    p00 = newP00;
+    p01 = newP01;
+    p11 = newP11;
+}
+
+HumanTracker::HumanTracker(float minimumIoU, float maximumDepthChange, int maximumFramesMissing, size_t maximumTracks)
+    : _minimumIoU(minimumIoU),
+      _maximumDepthChange(maximumDepthChange),
+      _maximumFramesMissing(maximumFramesMissing),
+      _maximumTracks(maximumTracks)
+{
+    _tracks.reserve(maximumTracks);
+    _trackMatched.reserve(maximumTracks);
+}
+
+std::vector<TrackedHuman> HumanTracker::update(const Box2D *boxes, const float *depths, size_t count, float deltaTime)
+{
+    // Predict
+    for (Track &track: _tracks)
+    {
+        track.centerX.predict(deltaTime, pixelAccelerationVariance);
+        track.centerY.predict(deltaTime, pixelAccelerationVariance);
+        if (track.hasDepth)
+        {
+            track.depth.predict(deltaTime, depthAccelerationVariance);
+        }
+    }
+
+    // Score every plausible (track, detection) pair. Pairs with too little overlap or whose depth
+    // disagrees are not candidates.
+    _candidates.clear();
+    for (size_t t = 0; t < _tracks.size(); t++)
+    {
+        const Track &track = _tracks[t];
+        Box2D predicted = predictedBox(track);
+        for (size_t d = 0; d < count; d++)
+        {
+            float iou = intersectionOverUnion(predicted, boxes[d]);
+            if (iou < _minimumIoU)
+            {
+                continue;
+            }
+            if (track.hasDepth && depths[d] > 0 && std::abs(track.depth.position - depths[d]) > _maximumDepthChange)
+            {
+                continue;
+            }
+            _candidates.emplace_back(Candidate{ .iou = iou, .trackIdx = uint32_t(t), .detectionIdx = uint32_t(d) });
+        }
+    }
+
+    // Greedy assignment, best overlap first
+    std::sort(_candidates.begin(), _candidates.end(), [](const Candidate &a, const Candidate &b) { return a.iou > b.iou; });
+    _trackMatched.assign(_tracks.size(), false);
+    _detectionTrack.assign(count, -1);
+    for (const Candidate &candidate: _candidates)
+    {
+        if (!_trackMatched[candidate.trackIdx] && _detectionTrack[candidate.detectionIdx] < 0)
+        {
+            _trackMatched[candidate.trackIdx] = true;
+            _detectionTrack[candidate.detectionIdx] = int(candidate.trackIdx);
+        }
+    }
+
+    // Correct matched tracks
+    for (size_t d = 0; d < count; d++)
+    {
+        if (_detectionTrack[d] < 0)
+        {
+            continue;
+        }
+        Track &track = _tracks[_detectionTrack[d]];
+        const Box2D &box = boxes[d];
+        track.centerX.correct(float(box.x) + 0.5f * float(box.width), pixelMeasurementVariance);
+        track.centerY.correct(float(box.y) + 0.5f * float(box.height), pixelMeasurementVariance);
+        if (depths[d] > 0)
+        {
+            if (track.hasDepth)
+            {
+                track.depth.correct(depths[d], depthMeasurementVariance);
+            }
+            else
+            {
+                track.depth.initialize(depths[d], depthMeasurementVariance, depthVelocityVariance);
+                track.hasDepth = true;
+            }
+        }
+        track.width += sizeSmoothing * (float(box.width) - track.width);
+        track.height += sizeSmoothing * (float(box.height) - track.height);
+        track.hits += 1;
+        track.framesMissing = 0;
+    }
+
+    // Age out unmatched tracks (in place, preserving order)
+    size_t numTracks = 0;
+    for (size_t t = 0; t < _tracks.size(); t++)
+    {
+        if (!_trackMatched[t])
+        {
+            _tracks[t].framesMissing += 1;
+        }
+        if (_tracks[t].framesMissing <= _maximumFramesMissing)
+        {
+            _tracks[numTracks++] = _tracks[t];
+        }
+    }
+    _tracks.resize(numTracks);
+
+    std::vector<TrackedHuman> tracked;
+    for (const Track &track: _tracks)
+    {
+        if (track.framesMissing == 0)
+        {
+            tracked.emplace_back(TrackedHuman{ .id = track.id, .box = predictedBox(track), .depth = track.hasDepth ? track.depth.position : -1, .hits = track.hits });
+        }
+    }
+
+    // Unmatched detections start new tracks while there is room
+    for (size_t d = 0; d < count && _tracks.size() < _maximumTracks; d++)
+    {
+        if (_detectionTrack[d] >= 0)
+        {
+            continue;
+        }
+        const Box2D &box = boxes[d];
+        Track track{ .id = _nextId++, .hasDepth = depths[d] > 0, .width = float(box.width), .height = float(box.height), .hits = 1, .framesMissing = 0 };
+        track.centerX.initialize(float(box.x) + 0.5f * float(box.width), pixelMeasurementVariance, pixelVelocityVariance);
+        track.centerY.initialize(float(box.y) + 0.5f * float(box.height), pixelMeasurementVariance, pixelVelocityVariance);
+        if (track.hasDepth)
+        {
+            track.depth.initialize(depths[d], depthMeasurementVariance, depthVelocityVariance);
+        }
+        _tracks.emplace_back(track);
+        tracked.emplace_back(TrackedHuman{ .id = track.id, .box = box, .depth = track.hasDepth ? depths[d] : -1, .hits = 1 });
+    }
+
+    return tracked;
+}
+
+void HumanTracker::reset()
+{
+    _tracks.clear();
+}
+
+Box2D HumanTracker::predictedBox(const Track &track) const
+{
+    int width = std::max(1, int(std::lround(track.width)));
+    int height = std::max(1, int(std::lround(track.height)));
+    int x = int(std::lround(track.centerX.position - 0.5f * float(width)));
+    int y = int(std::lround(track.centerY.position - 0.5f * float(height)));
+    return Box2D{ .x = x, .y = y, .width = width, .height = height };
+}
@@ -0,0 +1,111 @@
+//
+//  HumanTracker.hpp
+//  RoBart
+//
+//  Created by Bart Trzynadlowski on 10/16/26.
+//
+//  This file is part of RoBart.
+//
+//  RoBart is free software: you can redistribute it and/or modify it under the
+//  terms of the GNU General Public License as published by the Free Software
+//  Foundation, either version 3 of the License, or (at your option) any later
+//  version.
+//
+//  RoBart is distributed in the hope that it will be useful, but WITHOUT
+//  ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+//  FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+//  more details.
+//
+//  You should have received a copy of the GNU General Public License along
+//  with RoBart. If not, see <http://www.gnu.org/licenses/>.
+//
+
+#ifndef HumanTracker_hpp
+#define HumanTracker_hpp
+
+#include "BoxDepth.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+struct TrackedHuman
+{
+    uint32_t id;
+
+    /// Filtered bounding box and depth (-1 if depth has never been observed).
+    Box2D box;
+    float depth;
+
+    /// Number of frames in which the track has been matched to a detection.
+    int hits;
+};
+
+/// Tracks humans across frames so that each one keeps a stable ID. Each track runs a constant
+/// velocity Kalman filter on its box center and depth, and detections are assigned to the
+/// predicted tracks greedily in order of decreasing IoU. Tracks that go unmatched for too many
+/// frames are dropped.
+class HumanTracker
+{
+public:
+    HumanTracker(float minimumIoU = 0.1f, float maximumDepthChange = 0.75f, int maximumFramesMissing = 5, size_t maximumTracks = 50);
+
+    /// Consumes the detections of a new frame.
+    /// - Parameter boxes: Detected boxes.
+    /// - Parameter depths: Depth of each box, or a non-positive value if unknown.
+    /// - Parameter count: Number of detections.
+    /// - Parameter deltaTime: Time elapsed since the previous update (sec).
+    /// - Returns: Tracks that were matched to a detection this frame, with their filtered state.
+    std::vector<TrackedHuman> update(const Box2D *boxes, const float *depths, size_t count, float deltaTime);
+
+    void reset();
+
+private:
+    // State and covariance of a 1D constant velocity Kalman filter
+    struct AxisFilter
+    {
+        float position = 0;
+        float velocity = 0;
+        float p00 = 0;
+        float p01 = 0;
+        float p11 = 0;
+
+        void initialize(float measurement, float measurementVariance, float velocityVariance);
+        void predict(float deltaTime, float accelerationVariance);
+        void correct(float measurement, float measurementVariance);
+    };
+
+    struct Track
+    {
+        uint32_t id;
+        AxisFilter centerX;
+        AxisFilter centerY;
+        AxisFilter depth;
+        bool hasDepth;
+        float width;
+        float height;
+        int hits;
+        int framesMissing;
+    };
+
+    Box2D predictedBox(const Track &track) const;
+
+    float _minimumIoU;
+    float _maximumDepthChange;
+    int _maximumFramesMissing;
+    size_t _maximumTracks;
+    uint32_t _nextId = 0;
+    std::vector<Track> _tracks;
+
+    // Scratch buffers reused across frames to avoid per-frame allocation
+    struct Candidate
+    {
+        float iou;
+        uint32_t trackIdx;
+        uint32_t detectionIdx;
+    };
+    std::vector<Candidate> _candidates;
+    std::vector<int> _detectionTrack;
+    std::vector<bool> _trackMatched;
+};
+
+#endif /* HumanTracker_hpp */
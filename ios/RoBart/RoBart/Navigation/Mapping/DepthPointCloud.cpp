@@ -0,0 +1,132 @@
+//
+//  DepthPointCloud.cpp
+//  RoBart
+//
+//  Created by Bart Trzynadlowski on 10/16/26.
+//
+//  This file is part of RoBart.
+//
+//  RoBart is free software: you can redistribute it and/or modify it under the
+//  terms of the GNU General Public License as published by the Free Software
+//  Foundation, either version 3 of the License, or (at your option) any later
+//  version.
+//
+//  RoBart is distributed in the hope that it will be useful, but WITHOUT
+//  ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+//  FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+//  more details.
+//
+//  You should have received a copy of the GNU General Public License along
+//  with RoBart. If not, see <http://www.gnu.org/licenses/>.
+//
+
+
+#include "DepthPointCloud.hpp"
+#include <algorithm>
+#include <cmath>
+
+// Upper bound on the pixel stride, so that distant surfaces are not thinned to nothing
+static constexpr size_t maximumStride = 16;
+
+DepthCamera::DepthCamera(simd_float2 depthResolution, simd_float3x3 intrinsics, simd_float2 rgbResolution, simd_float4x4 viewMatrix)
+{
+    // Get depth intrinsic parameters by scaling by (depthResolution / rgbResolution)
+    simd_float2 scale = depthResolution / rgbResolution;
+    invF = (1.0f / scale) * simd_make_float2(1.0f / intrinsics.columns[0].x, 1.0f / intrinsics.columns[1].y);
+    c = scale * simd_make_float2(intrinsics.columns[2].x, intrinsics.columns[2].y);
+
+    // Create a depth camera to world matrix. The depth image coordinate system happens to be
+    // almost the same as the ARKit camera system, except y is flipped (everything rotated 180
+    // degrees about the x axis, which points down in portrait orientation).
+    simd_float4x4 rotateDepthToARKit = {
+        simd_make_float4(1, 0, 0, 0),
+        simd_make_float4(0, -1, 0, 0),
+        simd_make_float4(0, 0, -1, 0),
+        simd_make_float4(0, 0, 0, 1)
+    };
+    cameraToWorld = simd_mul(viewMatrix, rotateDepthToARKit);
+}
+
+DepthPointCloud::DepthPointCloud()
+    : _state(std::make_shared<State>())
+{
+}
+
+void DepthPointCloud::update(
+    CVPixelBufferRef depthMap,
+    simd_float3x3 intrinsics,
+    simd_float2 rgbResolution,
+    simd_float4x4 viewMatrix,
+    float minDepth,
+    float maxDepth,
+    float minSpacing
+)
+{
+    assert(CVPixelBufferGetPixelFormatType(depthMap) == kCVPixelFormatType_DepthFloat32);
+
+    CVPixelBufferLockBaseAddress(depthMap, kCVPixelBufferLock_ReadOnly);
+
+    size_t depthWidth = CVPixelBufferGetWidth(depthMap);
+    size_t depthHeight = CVPixelBufferGetHeight(depthMap);
+    DepthCamera camera(simd_make_float2(depthWidth, depthHeight), intrinsics, rgbResolution, viewMatrix);
+    const uint8_t *base = reinterpret_cast<const uint8_t *>(CVPixelBufferGetBaseAddress(depthMap));
+    size_t bytesPerRow = CVPixelBufferGetBytesPerRow(depthMap);
+
+    // Footprint of a pixel is depth * invF. The finer axis is used for both so that strides are
+    // square and weights are simply stride^2.
+    float metersPerPixelPerMeter = std::min(camera.invF.x, camera.invF.y);
+
+    std::vector<simd_float4> &points = _state->points;
+    points.clear();
+    _state->cameraPosition = camera.position();
+
+    size_t y = 0;
+    while (y < depthHeight)
+    {
+        const float *depthValues = reinterpret_cast<const float *>(base + y * bytesPerRow);
+
+        // Nearest valid depth determines the finest footprint in this row
+        float nearestDepth = INFINITY;
+        for (size_t x = 0; x < depthWidth; x++)
+        {
+            float depth = depthValues[x];
+            if (depth >= minDepth && depth <= maxDepth)
+            {
+                nearestDepth = std::min(nearestDepth, depth);
+            }
+        }
+        if (nearestDepth == INFINITY)
+        {
+            y++;
+            continue;
+        }
+
+        size_t stride = 1;
+        if (minSpacing > 0)
+        {
+            float footprint = nearestDepth * metersPerPixelPerMeter;
+            stride = std::clamp(size_t(minSpacing / footprint), size_t(1), maximumStride);
+        }
+        float weight = float(stride * stride);
+
+        for (size_t x = 0; x < depthWidth; x += stride)
+        {
+            float depth = depthValues[x];
+            if (depth < minDepth || depth > maxDepth)
+            {
+                continue;
+            }
+            simd_float3 worldPos = camera.unproject(simd_make_float2(x, y), depth);
+            points.push_back(simd_make_float4(worldPos, weight));
+        }
+
+        y += stride;
+    }
+
+    CVPixelBufferUnlockBaseAddress(depthMap, kCVPixelBufferLock_ReadOnly);
+}
+
+void DepthPointCloud::clear()
+{
+    _state->points.clear();
+}
@@ -0,0 +1,117 @@
+//
+//  DepthPointCloud.hpp
+//  RoBart
+//
+//  Created by Bart Trzynadlowski on 10/16/26.
+//
+//  This file is part of RoBart.
+//
+//  RoBart is free software: you can redistribute it and/or modify it under the
+//  terms of the GNU General Public License as published by the Free Software
+//  Foundation, either version 3 of the License, or (at your option) any later
+//  version.
+//
+//  RoBart is distributed in the hope that it will be useful, but WITHOUT
+//  ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+//  FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+//  more details.
+//
+//  You should have received a copy of the GNU General Public License along
+//  with RoBart. If not, see <http://www.gnu.org/licenses/>.
+//
+
+
+#ifndef DepthPointCloud_hpp
+#define DepthPointCloud_hpp
+
+#include <CoreVideo/CoreVideo.h>
+#include <simd/simd.h>
+#include <memory>
+#include <vector>
+
+/// Intrinsics and pose of the LiDAR depth camera for a single frame, used to unproject depth map
+/// pixels into world space.
+struct DepthCamera
+{
+    simd_float2 invF;               // 1/(scale_x*fx), 1/(scale_y*fy)
+    simd_float2 c;                  // scale_x*cx, scale_y*cy
+    simd_float4x4 cameraToWorld;
+
+    /// - Parameter depthResolution: Size of the depth map (pixels).
+    /// - Parameter intrinsics: Intrinsics of the RGB camera.
+    /// - Parameter rgbResolution: Size of the RGB image (pixels).
+    /// - Parameter viewMatrix: Camera transform.
+    DepthCamera(simd_float2 depthResolution, simd_float3x3 intrinsics, simd_float2 rgbResolution, simd_float4x4 viewMatrix);
+
+    /// World-space position of a depth map pixel with the given depth (m).
+    inline simd_float3 unproject(simd_float2 pixel, float depth) const
+    {
+        simd_float2 cameraSpacePosXY = (pixel - c) * (depth * invF);    // (x: depth*(x-cx)/fx, y: depth*(y-cy)/fy)
+        simd_float4 worldPos = simd_mul(cameraToWorld, simd_make_float4(cameraSpacePosXY.x, cameraSpacePosXY.y, depth, 1.0f));
+        return worldPos.xyz;
+    }
+
+    inline simd_float3 position() const
+    {
+        return cameraToWorld.columns[3].xyz;
+    }
+};
+
+/// World-space points unprojected from a depth frame, shared by consumers (occupancy, elevation)
+/// so that each frame is unprojected only once. Pixels may be skipped when their footprint is
+/// much smaller than the spacing consumers need; each retained point then stands in for the
+/// pixels skipped around it and carries their count as a weight.
+///
+/// Copies share the same points.
+class DepthPointCloud
+{
+public:
+    DepthPointCloud();
+
+    /// Replaces the points with those of a depth frame.
+    /// - Parameter minDepth: Samples nearer than this (m) are discarded.
+    /// - Parameter maxDepth: Samples farther than this (m) are discarded.
+    /// - Parameter minSpacing: Approximate world-space distance (m) between retained samples,
+    /// typically a fraction of the consumers' cell size. The pixel stride is chosen per row from
+    /// the nearest depth in it, so that no part of the row is sampled more coarsely than this. Zero
+    /// retains every pixel.
+    void update(
+        CVPixelBufferRef depthMap,
+        simd_float3x3 intrinsics,
+        simd_float2 rgbResolution,
+        simd_float4x4 viewMatrix,
+        float minDepth,
+        float maxDepth,
+        float minSpacing
+    );
+
+    void clear();
+
+    size_t size() const
+    {
+        return _state->points.size();
+    }
+
+    /// World-space position of each point in xyz and, in w, the number of pixels it represents.
+    const simd_float4 *points() const
+    {
+        return _state->points.data();
+    }
+
+    /// Position of the camera that the points were captured from.
+    simd_float3 cameraPosition() const
+    {
+        return _state->cameraPosition;
+    }
+
+private:
+    struct State
+    {
+        std::vector<simd_float4> points;
+        simd_float3 cameraPosition = simd_make_float3(0, 0, 0);
+    };
+
+    std::shared_ptr<State> _state;
+};
+
+#endif /* DepthPointCloud_hpp */
@@ -0,0 +1,171 @@
+//
+//  DynamicObstacleMap.cpp
+//  RoBart
+//
+//  Created by Bart Trzynadlowski on 10/16/26.
+//
+//  This file is part of RoBart.
+//
+//  RoBart is free software: you can redistribute it and/or modify it under the
+//  terms of the GNU General Public License as published by the Free Software
+//  Foundation, either version 3 of the License, or (at your option) any later
+//  version.
+//
+//  RoBart is distributed in the hope that it will be useful, but WITHOUT
+//  ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+//  FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+//  more details.
+//
+//  You should have received a copy of the GNU General Public License along
+//  with RoBart. If not, see <http://www.gnu.org/licenses/>.
+//
+
+#include "DynamicObstacleMap.hpp"
+#include "FrameArena.hpp"
+#include <cmath>
+#include <iostream>
+
+// Largest footprint extent (m) accepted for a single human, guarding against bad depth estimates
+// smearing an obstacle across the map
+static constexpr float maximumFootprintSide = 2.0f;
+
+DynamicObstacleMap::DynamicObstacleMap(const OccupancyMap &occupancy, float decaySeconds)
+    : _geometry(occupancy),
+      _decaySeconds(decaySeconds),
+      _expiresAt(occupancy.numCells(), -INFINITY),
+      _isStamped(occupancy.numCells(), false),
+      _combined(occupancy.width(), occupancy.depth(), occupancy.cellSide(), occupancy.centerPoint())
+{
+}
+
+void DynamicObstacleMap::stampHumans(
+    const Box2D *boxes,
+    const float *depths,
+    size_t count,
+    simd_float2 depthResolution,
+    simd_float3x3 intrinsics,
+    simd_float2 rgbResolution,
+    simd_float4x4 viewMatrix,
+    float margin,
+    double timestamp
+)
+{
+    pruneExpiredCells(timestamp);
+
+    DepthCamera camera(depthResolution, intrinsics, rgbResolution, viewMatrix);
+
+    for (size_t i = 0; i < count; i++)
+    {
+        float depth = depths[i];
+        if (depth <= 0)
+        {
+            continue;
+        }
+
+        // Unproject the box corners at the detected depth and take their xz extent
+        const Box2D &box = boxes[i];
+        simd_float2 corners[4] = {
+            simd_make_float2(box.x, box.y),
+            simd_make_float2(box.x + box.width, box.y),
+            simd_make_float2(box.x, box.y + box.height),
+            simd_make_float2(box.x + box.width, box.y + box.height)
+        };
+        simd_float2 minCorner = simd_make_float2(INFINITY, INFINITY);
+        simd_float2 maxCorner = simd_make_float2(-INFINITY, -INFINITY);
+        for (simd_float2 corner: corners)
+        {
+            simd_float3 worldPos = camera.unproject(corner, depth);
+            simd_float2 xz = simd_make_float2(worldPos.x, worldPos.z);
+            minCorner = simd_min(minCorner, xz);
+            maxCorner = simd_max(maxCorner, xz);
+        }
+
+        simd_float2 center = 0.5f * (minCorner + maxCorner);
+        simd_float2 halfExtent = simd_min(0.5f * (maxCorner - minCorner) + margin, 0.5f * maximumFootprintSide);
+        stampRectangle(center - halfExtent, center + halfExtent, timestamp);
+    }
+}
+
+void DynamicObstacleMap::stampRectangle(simd_float2 minCorner, simd_float2 maxCorner, double timestamp)
+{
+    OccupancyMap::CellIndices cell1 = _geometry.positionToCell(simd_make_float3(minCorner.x, 0, minCorner.y));
+    OccupancyMap::CellIndices cell2 = _geometry.positionToCell(simd_make_float3(maxCorner.x, 0, maxCorner.y));
+    size_t cellsWide = _geometry.cellsWide();
+    double expiresAt = timestamp + _decaySeconds;
+    for (size_t z = std::min(cell1.cellZ, cell2.cellZ); z <= std::max(cell1.cellZ, cell2.cellZ); z++)
+    {
+        for (size_t x = std::min(cell1.cellX, cell2.cellX); x <= std::max(cell1.cellX, cell2.cellX); x++)
+        {
+            size_t idx = z * cellsWide + x;
+            _expiresAt[idx] = std::max(_expiresAt[idx], expiresAt);
+            if (!_isStamped[idx])
+            {
+                _isStamped[idx] = true;
+                _stampedCells.push_back(uint32_t(idx));
+            }
+        }
+    }
+}
+
+bool DynamicObstacleMap::isOccupied(OccupancyMap::CellIndices cell, double timestamp) const
+{
+    return timestamp < _expiresAt[cell.cellZ * _geometry.cellsWide() + cell.cellX];
+}
+
+OccupancyMap DynamicObstacleMap::overlay(const OccupancyMap &occupancy, double timestamp)
+{
+    if (occupancy.numCells() != _expiresAt.size())
+    {
+        std::cout << "[DynamicObstacleMap] Error: Occupancy map dimensions do not match" << std::endl;
+        return occupancy;
+    }
+    if (_stampedCells.empty())
+    {
+        return occupancy;
+    }
+
+    FrameArena &arena = FrameArena::local();
+    FrameArena::Scope scope(arena);
+    uint32_t *activeCells = arena.allocate<uint32_t>(_stampedCells.size());
+    size_t numActive = 0;
+    size_t cellsWide = _geometry.cellsWide();
+    for (uint32_t idx: _stampedCells)
+    {
+        if (timestamp < _expiresAt[idx])
+        {
+            activeCells[numActive++] = uint32_t(occupancy.linearIndex(idx % cellsWide, idx / cellsWide));
+        }
+    }
+    if (numActive == 0)
+    {
+        return occupancy;
+    }
+
+    _combined.copyOccupancyFrom(occupancy);
+    _combined.addToCells(activeCells, numActive, 1.0f);
+    return _combined;
+}
+
+void DynamicObstacleMap::pruneExpiredCells(double timestamp)
+{
+    size_t numKept = 0;
+    for (uint32_t idx: _stampedCells)
+    {
+        if (timestamp < _expiresAt[idx])
+        {
+            _stampedCells[numKept++] = idx;
+        }
+        else
+        {
+            _isStamped[idx] = false;
+        }
+    }
+    _stampedCells.resize(numKept);
+}
+
+void DynamicObstacleMap::clear()
+{
+    std::fill(_expiresAt.begin(), _expiresAt.end(), -INFINITY);
+    std::fill(_isStamped.begin(), _isStamped.end(), false);
+    _stampedCells.clear();
+}
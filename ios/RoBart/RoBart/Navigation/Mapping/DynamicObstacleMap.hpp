@@ -0,0 +1,97 @@
+//
+//  DynamicObstacleMap.hpp
+//  RoBart
+//
+//  Created by Bart Trzynadlowski on 10/16/26.
+//
+//  This file is part of RoBart.
+//
+//  RoBart is free software: you can redistribute it and/or modify it under the
+//  terms of the GNU General Public License as published by the Free Software
+//  Foundation, either version 3 of the License, or (at your option) any later
+//  version.
+//
+//  RoBart is distributed in the hope that it will be useful, but WITHOUT
+//  ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+//  FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+//  more details.
+//
+//  You should have received a copy of the GNU General Public License along
+//  with RoBart. If not, see <http://www.gnu.org/licenses/>.
+//
+
+#ifndef DynamicObstacleMap_hpp
+#define DynamicObstacleMap_hpp
+
+#include "BoxDepth.hpp"
+#include "OccupancyMap.hpp"
+#include <simd/simd.h>
+#include <vector>
+
+/// Short-lived obstacles, such as people, kept in a layer separate from the static occupancy map
+/// so that they never pollute it. Each cell stores the time at which it stops being an obstacle,
+/// so stamping is proportional to the footprint and decay costs nothing.
+class DynamicObstacleMap
+{
+public:
+    /// - Parameter occupancy: Static map whose geometry this layer shares.
+    /// - Parameter decaySeconds: How long a stamped cell remains an obstacle.
+    DynamicObstacleMap(const OccupancyMap &occupancy, float decaySeconds);
+
+    /// Unprojects human bounding boxes detected in a depth image and stamps their footprints. The
+    /// footprint of each human is the xz extent of its box unprojected at the detected depth,
+    /// grown by a margin.
+    /// - Parameter boxes: Bounding boxes in depth image coordinates.
+    /// - Parameter depths: Depth of each box. Boxes with non-positive depth are skipped.
+    /// - Parameter count: Number of boxes.
+    /// - Parameter depthResolution: Depth image dimensions, which the RGB intrinsics are scaled to.
+    /// - Parameter intrinsics: RGB camera intrinsics.
+    /// - Parameter rgbResolution: RGB image dimensions.
+    /// - Parameter viewMatrix: Camera transform.
+    /// - Parameter margin: Distance (m) by which to grow each footprint.
+    /// - Parameter timestamp: Time of the observation (sec).
+    void stampHumans(
+        const Box2D *boxes,
+        const float *depths,
+        size_t count,
+        simd_float2 depthResolution,
+        simd_float3x3 intrinsics,
+        simd_float2 rgbResolution,
+        simd_float4x4 viewMatrix,
+        float margin,
+        double timestamp
+    );
+
+    /// Marks all cells overlapping an axis-aligned xz rectangle as obstacles.
+    void stampRectangle(simd_float2 minCorner, simd_float2 maxCorner, double timestamp);
+
+    bool isOccupied(OccupancyMap::CellIndices cell, double timestamp) const;
+
+    /// Combines the static map with the obstacles active at the given time, suitable for passing
+    /// to the pathfinders. When no obstacles are active, the static map itself is returned.
+    /// Otherwise, its values are copied into a map owned by this layer, allocated once, and the
+    /// active cells are added to it. Either way the result shares memory and must not be modified,
+    /// and a combined map is only valid until the next call. Only the cells stamped since they
+    /// last expired are visited.
+    OccupancyMap overlay(const OccupancyMap &occupancy, double timestamp);
+
+    void clear();
+
+private:
+    OccupancyMap _geometry;
+    float _decaySeconds;
+
+    // Time at which each cell expires, indexed by z * cellsWide + x
+    std::vector<double> _expiresAt;
+
+    // Indices of cells that have been stamped and not yet pruned, and whether each cell is listed
+    std::vector<uint32_t> _stampedCells;
+    std::vector<bool> _isStamped;
+
+    // Static map plus active obstacles, returned by overlay()
+    OccupancyMap _combined;
+
+    void pruneExpiredCells(double timestamp);
+};
+
+#endif /* DynamicObstacleMap_hpp */
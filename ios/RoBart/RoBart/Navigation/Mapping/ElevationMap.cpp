@@ -0,0 +1,211 @@
+//
+//  ElevationMap.cpp
+//  RoBart
+//
+//  Created by Bart Trzynadlowski on 10/16/26.
+//
+//  This file is part of RoBart.
+//
+//  RoBart is free software: you can redistribute it and/or modify it under the
+//  terms of the GNU General Public License as published by the Free Software
+//  Foundation, either version 3 of the License, or (at your option) any later
+//  version.
+//
+//  RoBart is distributed in the hope that it will be useful, but WITHOUT
+//  ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+//  FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+//  more details.
+//
+//  You should have received a copy of the GNU General Public License along
+//  with RoBart. If not, see <http://www.gnu.org/licenses/>.
+//
+
+#include "ElevationMap.hpp"
+#include "FrameArena.hpp"
+#include "ThreadPool.hpp"
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+#include <vector>
+
+ElevationMap::ElevationMap(const OccupancyMap &occupancy, float minSampleHeight, float maxSampleHeight)
+    : _geometry(occupancy),
+      _minSampleHeight(minSampleHeight),
+      _maxSampleHeight(maxSampleHeight),
+      _minHeight(std::make_shared<float[]>(occupancy.numCells())),
+      _maxHeight(std::make_shared<float[]>(occupancy.numCells()))
+{
+    clear();
+}
+
+void ElevationMap::clear()
+{
+    std::fill(_minHeight.get(), _minHeight.get() + _geometry.numCells(), INFINITY);
+    std::fill(_maxHeight.get(), _maxHeight.get() + _geometry.numCells(), -INFINITY);
+}
+
+size_t ElevationMap::numSlices() const
+{
+    return ThreadPool::shared().numThreads() + 1;
+}
+
+void ElevationMap::integrateDepth(
+    CVPixelBufferRef depthMap,
+    simd_float3x3 intrinsics,
+    simd_float2 rgbResolution,
+    simd_float4x4 viewMatrix,
+    float minDepth,
+    float maxDepth
+)
+{
+    assert(CVPixelBufferGetPixelFormatType(depthMap) == kCVPixelFormatType_DepthFloat32);
+
+    CVPixelBufferLockBaseAddress(depthMap, kCVPixelBufferLock_ReadOnly);
+
+    size_t depthWidth = CVPixelBufferGetWidth(depthMap);
+    size_t depthHeight = CVPixelBufferGetHeight(depthMap);
+    DepthCamera camera(simd_make_float2(depthWidth, depthHeight), intrinsics, rgbResolution, viewMatrix);
+
+    const uint8_t *base = reinterpret_cast<const uint8_t *>(CVPixelBufferGetBaseAddress(depthMap));
+    size_t bytesPerRow = CVPixelBufferGetBytesPerRow(depthMap);
+
+    // Each slice of rows reduces into its own grids
+    size_t numCells = _geometry.numCells();
+    size_t slices = numSlices();
+    FrameArena &arena = FrameArena::local();
+    FrameArena::Scope scope(arena);
+    float *sliceMin = arena.allocate<float>(slices * numCells, INFINITY);
+    float *sliceMax = arena.allocate<float>(slices * numCells, -INFINITY);
+    ThreadPool::shared().parallelFor(slices, [&](size_t slice)
+    {
+        float *minHeight = &sliceMin[slice * numCells];
+        float *maxHeight = &sliceMax[slice * numCells];
+        size_t yStart = slice * depthHeight / slices;
+        size_t yEnd = (slice + 1) * depthHeight / slices;
+        for (size_t y = yStart; y < yEnd; y++)
+        {
+            const float *depthValues = reinterpret_cast<const float *>(base + y * bytesPerRow);
+            for (size_t x = 0; x < depthWidth; x++)
+            {
+                float depth = depthValues[x];
+                if (depth < minDepth || depth > maxDepth)
+                {
+                    continue;
+                }
+
+                simd_float3 worldPos = camera.unproject(simd_make_float2(x, y), depth);
+                if (worldPos.y < _minSampleHeight || worldPos.y > _maxSampleHeight)
+                {
+                    continue;
+                }
+
+                size_t idx = _geometry.linearIndex(_geometry.positionToCell(worldPos));
+                minHeight[idx] = std::min(minHeight[idx], worldPos.y);
+                maxHeight[idx] = std::max(maxHeight[idx], worldPos.y);
+            }
+        }
+    });
+
+    CVPixelBufferUnlockBaseAddress(depthMap, kCVPixelBufferLock_ReadOnly);
+
+    mergeFromThreads(slices, sliceMin, sliceMax);
+}
+
+void ElevationMap::integratePoints(const DepthPointCloud &points)
+{
+    // Extremes do not depend on how many pixels a point represents, so weights are ignored
+    const simd_float4 *point = points.points();
+    for (size_t i = 0; i < points.size(); i++, point++)
+    {
+        if (point->y < _minSampleHeight || point->y > _maxSampleHeight)
+        {
+            continue;
+        }
+
+        size_t idx = _geometry.linearIndex(_geometry.positionToCell(point->xyz));
+        _minHeight[idx] = std::min(_minHeight[idx], point->y);
+        _maxHeight[idx] = std::max(_maxHeight[idx], point->y);
+    }
+}
+
+void ElevationMap::integrateMeshes(const MeshVertexSpan *meshes, size_t numMeshes)
+{
+    // Meshes are dealt out to slices round-robin and each slice reduces into its own grids
+    size_t numCells = _geometry.numCells();
+    size_t slices = std::min(numSlices(), std::max(numMeshes, size_t(1)));
+    FrameArena &arena = FrameArena::local();
+    FrameArena::Scope scope(arena);
+    float *sliceMin = arena.allocate<float>(slices * numCells, INFINITY);
+    float *sliceMax = arena.allocate<float>(slices * numCells, -INFINITY);
+    ThreadPool::shared().parallelFor(slices, [&](size_t slice)
+    {
+        float *minHeight = &sliceMin[slice * numCells];
+        float *maxHeight = &sliceMax[slice * numCells];
+        for (size_t meshIdx = slice; meshIdx < numMeshes; meshIdx += slices)
+        {
+            _geometry.getMeshTriangleHeights(meshes[meshIdx], _minSampleHeight, _maxSampleHeight, minHeight, maxHeight);
+        }
+    });
+
+    mergeFromThreads(slices, sliceMin, sliceMax);
+}
+
+void ElevationMap::mergeFromThreads(size_t numSlices, const float *sliceMin, const float *sliceMax)
+{
+    size_t numCells = _geometry.numCells();
+    for (size_t slice = 0; slice < numSlices; slice++)
+    {
+        const float *minHeight = &sliceMin[slice * numCells];
+        const float *maxHeight = &sliceMax[slice * numCells];
+        for (size_t i = 0; i < numCells; i++)
+        {
+            _minHeight[i] = std::min(_minHeight[i], minHeight[i]);
+            _maxHeight[i] = std::max(_maxHeight[i], maxHeight[i]);
+        }
+    }
+}
+
+bool ElevationMap::isObserved(OccupancyMap::CellIndices cell) const
+{
+    size_t idx = _geometry.linearIndex(cell);
+    return _maxHeight[idx] >= _minHeight[idx];
+}
+
+float ElevationMap::minHeight(OccupancyMap::CellIndices cell) const
+{
+    return _minHeight[_geometry.linearIndex(cell)];
+}
+
+float ElevationMap::maxHeight(OccupancyMap::CellIndices cell) const
+{
+    return _maxHeight[_geometry.linearIndex(cell)];
+}
+
+void ElevationMap::getMaxHeightArray(float *heights, size_t size, float unobservedValue) const
+{
+    if (size != _geometry.numCells())
+    {
+        std::cout << "[ElevationMap] Error: Array dimensions do not match elevation map" << std::endl;
+        return;
+    }
+
+    for (size_t i = 0; i < size; i++)
+    {
+        heights[i] = std::isinf(_maxHeight[i]) ? unobservedValue : _maxHeight[i];
+    }
+}
+
+void ElevationMap::getObstacleArray(float *occupied, size_t size, float clearanceHeight) const
+{
+    if (size != _geometry.numCells())
+    {
+        std::cout << "[ElevationMap] Error: Array dimensions do not match elevation map" << std::endl;
+        return;
+    }
+
+    for (size_t i = 0; i < size; i++)
+    {
+        // Unobserved cells have a min height of +infinity and so are never marked
+        occupied[i] = _minHeight[i] < clearanceHeight ? 1.0f : 0.0f;
+    }
+}
@@ -0,0 +1,98 @@
+//
+//  ElevationMap.hpp
+//  RoBart
+//
+//  Created by Bart Trzynadlowski on 10/16/26.
+//
+//  This file is part of RoBart.
+//
+//  RoBart is free software: you can redistribute it and/or modify it under the
+//  terms of the GNU General Public License as published by the Free Software
+//  Foundation, either version 3 of the License, or (at your option) any later
+//  version.
+//
+//  RoBart is distributed in the hope that it will be useful, but WITHOUT
+//  ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+//  FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+//  more details.
+//
+//  You should have received a copy of the GNU General Public License along
+//  with RoBart. If not, see <http://www.gnu.org/licenses/>.
+//
+
+#ifndef ElevationMap_hpp
+#define ElevationMap_hpp
+
+#include "OccupancyMap.hpp"
+#include <CoreVideo/CoreVideo.h>
+#include <simd/simd.h>
+#include <memory>
+
+/// 2.5D map recording, for each cell, the lowest and highest world-space heights observed within a
+/// vertical band. With the band starting just above the floor, the lowest height is the clearance
+/// under whatever occupies the cell (e.g., a table top) and the highest is its top, so
+/// traversability can be re-thresholded without revisiting raw geometry.
+///
+/// Integration is split across threads that each reduce into their own min/max grids, which are
+/// merged at the end, so no atomics are needed. Copies share the same underlying memory.
+class ElevationMap
+{
+public:
+    /// - Parameter occupancy: Map whose geometry this one shares.
+    /// - Parameter minSampleHeight: Samples below this world-space height (e.g., the floor and
+    /// anything low enough to drive over) are ignored.
+    /// - Parameter maxSampleHeight: Samples above this world-space height are ignored.
+    ElevationMap(const OccupancyMap &occupancy, float minSampleHeight, float maxSampleHeight);
+
+    void clear();
+
+    /// Accumulates the points of a depth frame. Inputs are as for OccupancyMap::updateCellCounts().
+    void integrateDepth(
+        CVPixelBufferRef depthMap,
+        simd_float3x3 intrinsics,
+        simd_float2 rgbResolution,
+        simd_float4x4 viewMatrix,
+        float minDepth,
+        float maxDepth
+    );
+
+    /// Accumulates the points of a depth frame that has already been unprojected.
+    void integratePoints(const DepthPointCloud &points);
+
+    /// Accumulates the triangles of scene meshes, rasterized as for
+    /// OccupancyMap::updateOccupancyFromMeshTriangles() so that large triangles leave no gaps.
+    void integrateMeshes(const MeshVertexSpan *meshes, size_t numMeshes);
+
+    /// Whether any sample has landed in the cell since the map was last cleared.
+    bool isObserved(OccupancyMap::CellIndices cell) const;
+
+    /// Lowest sample height in the cell, or +infinity if unobserved.
+    float minHeight(OccupancyMap::CellIndices cell) const;
+
+    /// Highest sample height in the cell, or -infinity if unobserved.
+    float maxHeight(OccupancyMap::CellIndices cell) const;
+
+    /// Copies the highest sample height of each cell, with unobserved cells set to
+    /// `unobservedValue`, in OccupancyMap order. Suitable for
+    /// OccupancyMap::updateOccupancyFromHeightMap().
+    void getMaxHeightArray(float *heights, size_t size, float unobservedValue) const;
+
+    /// Thresholds traversability: sets each cell to 1 where an observed surface lies lower than
+    /// `clearanceHeight`, which is normally the top of the robot, and to 0 elsewhere (including
+    /// under a high table), in OccupancyMap order. The shared occupancy map holds reference counts
+    /// maintained by MeshOccupancyCache, so the result is meant for a map of its own.
+    void getObstacleArray(float *occupied, size_t size, float clearanceHeight) const;
+
+private:
+    void mergeFromThreads(size_t numSlices, const float *sliceMin, const float *sliceMax);
+    size_t numSlices() const;
+
+    OccupancyMap _geometry;
+    float _minSampleHeight;
+    float _maxSampleHeight;
+
+    std::shared_ptr<float[]> _minHeight;
+    std::shared_ptr<float[]> _maxHeight;
+};
+
+#endif /* ElevationMap_hpp */
@@ -0,0 +1,203 @@
+//
+//  FrameArena.cpp
+//  RoBart
+//
+//  Created by Bart Trzynadlowski on 10/16/26.
+//
+//  This file is part of RoBart.
+//
+//  RoBart is free software: you can redistribute it and/or modify it under the
+//  terms of the GNU General Public License as published by the Free Software
+//  Foundation, either version 3 of the License, or (at your option) any later
+//  version.
+//
+//  RoBart is distributed in the hope that it will be useful, but WITHOUT
+//  ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+//  FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+//  more details.
+//
+//  You should have received a copy of the GNU General Public License along
+//  with RoBart. If not, see <http://www.gnu.org/licenses/>.
+//
+
+
+#include "FrameArena.hpp"
+#include <algorithm>
+#include <atomic>
+#include <cstdlib>
+
+// Large enough for the per-thread grids of a 20x20 m map at 0.1 m cells on a 6-core phone
+static constexpr size_t initialLocalArenaBytes = 2 * 1024 * 1024;
+
+// Allocations are aligned at least this much, which suffices for simd types
+static constexpr size_t minimumAlignment = 16;
+
+static std::atomic<size_t> s_heapAllocations(0);
+
+FrameArena::FrameArena(size_t initialBytes)
+{
+    addBlock(std::max(initialBytes, size_t(minimumAlignment)));
+}
+
+FrameArena &FrameArena::local()
+{
+    static thread_local FrameArena arena(initialLocalArenaBytes);
+    return arena;
+}
+
+void FrameArena::addBlock(size_t size)
+{
+    _blocks.push_back(Block{ std::unique_ptr<uint8_t[]>(new uint8_t[size]), size });
+    s_heapAllocations.fetch_add(1, std::memory_order_relaxed);
+}
+
+void *FrameArena::allocateBytes(size_t numBytes, size_t alignment)
+{
+    alignment = std::max(alignment, minimumAlignment);
+    while (true)
+    {
+        // Align the address itself: block bases are only as aligned as operator new[] makes them,
+        // which is less than some types ask for
+        Block &block = _blocks[_blockIdx];
+        uintptr_t base = reinterpret_cast<uintptr_t>(block.memory.get());
+        size_t start = ((base + _offset + alignment - 1) & ~uintptr_t(alignment - 1)) - base;
+        if (start + numBytes <= block.size)
+        {
+            _offset = start + numBytes;
+            return block.memory.get() + start;
+        }
+
+        // Move on to the next block, creating one at least twice as large as the last if needed
+        if (_blockIdx + 1 == _blocks.size())
+        {
+            addBlock(std::max(2 * _blocks.back().size, numBytes + alignment));
+        }
+        _blockIdx++;
+        _offset = 0;
+    }
+}
+
+void FrameArena::rewind(size_t blockIdx, size_t offset)
+{
+    if (blockIdx == 0 && offset == 0)
+    {
+        reset();
+        return;
+    }
+    _blockIdx = blockIdx;
+    _offset = offset;
+}
+
+void FrameArena::reset()
+{
+    if (_blocks.size() > 1)
+    {
+        size_t totalSize = capacity();
+        _blocks.clear();
+        addBlock(totalSize);
+    }
+    _blockIdx = 0;
+    _offset = 0;
+}
+
+size_t FrameArena::capacity() const
+{
+    size_t totalSize = 0;
+    for (const Block &block: _blocks)
+    {
+        totalSize += block.size;
+    }
+    return totalSize;
+}
+
+size_t FrameArena::totalHeapAllocations()
+{
+    return s_heapAllocations.load(std::memory_order_relaxed);
+}
+
+size_t getFrameArenaHeapAllocations()
+{
+    return FrameArena::totalHeapAllocations();
+}
+
+#if defined(DEBUG)
+
+// Replacements for the global allocation functions that count every allocation. The remaining
+// forms (nothrow, sized delete) are implemented by the standard library in terms of these.
+
+static std::atomic<size_t> s_operatorNewCalls(0);
+
+static void *countedAllocate(size_t size, size_t alignment)
+{
+    s_operatorNewCalls.fetch_add(1, std::memory_order_relaxed);
+    void *memory = nullptr;
+    if (posix_memalign(&memory, std::max(alignment, sizeof(void *)), std::max(size, size_t(1))) != 0)
+    {
+        throw std::bad_alloc();
+    }
+    return memory;
+}
+
+void *operator new(size_t size)
+{
+    return countedAllocate(size, __STDCPP_DEFAULT_NEW_ALIGNMENT__);
+}
+
+void *operator new[](size_t size)
+{
+    return countedAllocate(size, __STDCPP_DEFAULT_NEW_ALIGNMENT__);
+}
+
+void *operator new(size_t size, std::align_val_t alignment)
+{
+    return countedAllocate(size, size_t(alignment));
+}
+
+void *operator new[](size_t size, std::align_val_t alignment)
+{
+    return countedAllocate(size, size_t(alignment));
+}
+
+void operator delete(void *memory) noexcept
+{
+    free(memory);
+}
+
+void operator delete[](void *memory) noexcept
+{
+    free(memory);
+}
+
+void operator delete(void *memory, std::align_val_t) noexcept
+{
+    free(memory);
+}
+
+void operator delete[](void *memory, std::align_val_t) noexcept
+{
+    free(memory);
+}
+
+size_t getHeapAllocationCount()
+{
+    return s_operatorNewCalls.load(std::memory_order_relaxed);
+}
+
+bool isHeapAllocationCountingEnabled()
+{
+    return true;
+}
+
+#else
+
+size_t getHeapAllocationCount()
+{
+    return 0;
+}
+
+bool isHeapAllocationCountingEnabled()
+{
+    return false;
+}
+
+#endif
@@ -0,0 +1,132 @@
+//
+//  FrameArena.hpp
+//  RoBart
+//
+//  Created by Bart Trzynadlowski on 10/16/26.
+//
+//  This file is part of RoBart.
+//
+//  RoBart is free software: you can redistribute it and/or modify it under the
+//  terms of the GNU General Public License as published by the Free Software
+//  Foundation, either version 3 of the License, or (at your option) any later
+//  version.
+//
+//  RoBart is distributed in the hope that it will be useful, but WITHOUT
+//  ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+//  FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+//  more details.
+//
+//  You should have received a copy of the GNU General Public License along
+//  with RoBart. If not, see <http://www.gnu.org/licenses/>.
+//
+
+
+#ifndef FrameArena_hpp
+#define FrameArena_hpp
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <vector>
+
+/// Bump allocator for the transient buffers that mapping stages need while processing a frame
+/// (per-thread reduction grids, occupancy copies, triangle bins). Stages open a Scope, allocate,
+/// and everything is released when the scope closes. Memory is retained: when the outermost scope
+/// closes after a frame overflowed the arena, its blocks are merged into one large enough for the
+/// whole frame, so that once frame sizes stop growing the heap is no longer touched.
+///
+/// Not thread-safe. Each thread has its own arena (local()); buffers allocated by the calling
+/// thread may be shared with the workers of a parallelFor().
+class FrameArena
+{
+public:
+    FrameArena(size_t initialBytes);
+
+    FrameArena(const FrameArena &) = delete;
+    FrameArena &operator=(const FrameArena &) = delete;
+
+    /// Arena of the calling thread.
+    static FrameArena &local();
+
+    /// Uninitialized storage for `count` objects of a trivially destructible type.
+    template <typename T>
+    T *allocate(size_t count)
+    {
+        static_assert(std::is_trivially_destructible<T>::value, "Arena objects are never destroyed");
+        return reinterpret_cast<T *>(allocateBytes(count * sizeof(T), alignof(T)));
+    }
+
+    /// Storage for `count` copies of `value`.
+    template <typename T>
+    T *allocate(size_t count, T value)
+    {
+        T *objects = allocate<T>(count);
+        for (size_t i = 0; i < count; i++)
+        {
+            new (&objects[i]) T(value);
+        }
+        return objects;
+    }
+
+    /// Releases all allocations, merging overflow blocks as described above.
+    void reset();
+
+    /// Allocations made within the lifetime of a scope are released when it ends. Scopes nest.
+    class Scope
+    {
+    public:
+        Scope(FrameArena &arena)
+            : _arena(arena),
+              _blockIdx(arena._blockIdx),
+              _offset(arena._offset)
+        {
+        }
+
+        ~Scope()
+        {
+            _arena.rewind(_blockIdx, _offset);
+        }
+
+        Scope(const Scope &) = delete;
+        Scope &operator=(const Scope &) = delete;
+
+    private:
+        FrameArena &_arena;
+        size_t _blockIdx;
+        size_t _offset;
+    };
+
+    size_t capacity() const;
+
+    /// Number of times any arena has had to obtain memory from the heap, across all threads.
+    static size_t totalHeapAllocations();
+
+private:
+    struct Block
+    {
+        std::unique_ptr<uint8_t[]> memory;
+        size_t size;
+    };
+
+    void *allocateBytes(size_t numBytes, size_t alignment);
+    void rewind(size_t blockIdx, size_t offset);
+    void addBlock(size_t size);
+
+    std::vector<Block> _blocks;
+    size_t _blockIdx = 0;
+    size_t _offset = 0;
+};
+
+/// Swift-visible FrameArena::totalHeapAllocations(), for checking that steady-state frames do not
+/// allocate.
+extern size_t getFrameArenaHeapAllocations();
+
+/// Swift-visible number of allocations made through the global operator new on any thread since
+/// launch, including those of standard containers and shared pointers. Debug builds (DEBUG
+/// defined) replace operator new to count them; otherwise nothing is counted.
+extern size_t getHeapAllocationCount();
+extern bool isHeapAllocationCountingEnabled();
+
+#endif /* FrameArena_hpp */
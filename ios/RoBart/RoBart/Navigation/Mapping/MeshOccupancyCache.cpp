@@ -0,0 +1,162 @@
+//
+//  MeshOccupancyCache.cpp
+//  RoBart
+//
+//  Created by Bart Trzynadlowski on 10/16/26.
+//
+//  This file is part of RoBart.
+//
+//  RoBart is free software: you can redistribute it and/or modify it under the
+//  terms of the GNU General Public License as published by the Free Software
+//  Foundation, either version 3 of the License, or (at your option) any later
+//  version.
+//
+//  RoBart is distributed in the hope that it will be useful, but WITHOUT
+//  ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+//  FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+//  more details.
+//
+//  You should have received a copy of the GNU General Public License along
+//  with RoBart. If not, see <http://www.gnu.org/licenses/>.
+//
+
+#include "MeshOccupancyCache.hpp"
+#include "FrameArena.hpp"
+#include "ThreadPool.hpp"
+#include <cstring>
+
+// FNV-1a over 32-bit words. Vertices are hashed component-wise to skip simd_float3 padding.
+static uint64_t hashMesh(const MeshVertexSpan &mesh)
+{
+    constexpr uint64_t prime = 0x100000001b3ULL;
+    uint64_t hash = 0xcbf29ce484222325ULL;
+    auto mix = [&](float value)
+    {
+        uint32_t bits;
+        memcpy(&bits, &value, sizeof(bits));
+        hash = (hash ^ bits) * prime;
+    };
+
+    for (int column = 0; column < 4; column++)
+    {
+        for (int row = 0; row < 4; row++)
+        {
+            mix(mesh.transform.columns[column][row]);
+        }
+    }
+    for (size_t i = 0; i < mesh.numVertices; i++)
+    {
+        mix(mesh.vertices[i].x);
+        mix(mesh.vertices[i].y);
+        mix(mesh.vertices[i].z);
+    }
+    for (size_t i = 0; i < 3 * mesh.numTriangles; i++)
+    {
+        hash = (hash ^ mesh.triangleIndices[i]) * prime;
+    }
+    return hash;
+}
+
+size_t MeshOccupancyCache::update(
+    OccupancyMap &occupancy,
+    const MeshVertexSpan *meshes,
+    const MeshAnchorID *ids,
+    size_t numMeshes,
+    float minOccupiedHeight,
+    float maxOccupiedHeight,
+    ElevationMap *observed
+)
+{
+    _generation++;
+    bool heightRangeChanged = minOccupiedHeight != _minOccupiedHeight || maxOccupiedHeight != _maxOccupiedHeight;
+    _minOccupiedHeight = minOccupiedHeight;
+    _maxOccupiedHeight = maxOccupiedHeight;
+
+    // Hash only anchors that are new or have been updated since their contributions were computed
+    _hashes.resize(numMeshes);
+    _hashed.clear();
+    for (size_t i = 0; i < numMeshes; i++)
+    {
+        const Contribution &contribution = _contributions[ids[i]];
+        if (contribution.generation == 0 || contribution.version != meshes[i].version)
+        {
+            _hashed.push_back(i);
+        }
+    }
+    ThreadPool::shared().parallelFor(_hashed.size(), [&](size_t i)
+    {
+        _hashes[_hashed[i]] = hashMesh(meshes[_hashed[i]]);
+    });
+
+    // Find anchors that are new or whose content has changed
+    _changed.clear();
+    for (size_t i = 0; i < numMeshes; i++)
+    {
+        Contribution &contribution = _contributions[ids[i]];
+        bool isNew = contribution.generation == 0;
+        bool wasUpdated = contribution.version != meshes[i].version;
+        if (heightRangeChanged || isNew || (wasUpdated && contribution.hash != _hashes[i]))
+        {
+            _changed.push_back(i);
+        }
+        if (isNew || wasUpdated)
+        {
+            contribution.hash = _hashes[i];
+            contribution.version = meshes[i].version;
+        }
+        contribution.generation = _generation;
+    }
+
+    // Rasterize changed anchors in parallel
+    if (_changedCells.size() < _changed.size())
+    {
+        _changedCells.resize(_changed.size());
+    }
+    ThreadPool::shared().parallelFor(_changed.size(), [&](size_t i)
+    {
+        occupancy.getMeshTriangleCells(meshes[_changed[i]], minOccupiedHeight, maxOccupiedHeight, &_changedCells[i]);
+    });
+
+    if (observed != nullptr && !_changed.empty())
+    {
+        FrameArena &arena = FrameArena::local();
+        FrameArena::Scope scope(arena);
+        MeshVertexSpan *changedMeshes = arena.allocate<MeshVertexSpan>(_changed.size());
+        for (size_t i = 0; i < _changed.size(); i++)
+        {
+            changedMeshes[i] = meshes[_changed[i]];
+        }
+        observed->integrateMeshes(changedMeshes, _changed.size());
+    }
+
+    // Swap in the new contributions
+    for (size_t i = 0; i < _changed.size(); i++)
+    {
+        Contribution &contribution = _contributions[ids[_changed[i]]];
+        occupancy.addToCells(contribution.cells.data(), contribution.cells.size(), -1.0f);
+        contribution.cells.swap(_changedCells[i]);
+        occupancy.addToCells(contribution.cells.data(), contribution.cells.size(), 1.0f);
+    }
+
+    // Remove anchors that have disappeared
+    for (auto it = _contributions.begin(); it != _contributions.end(); )
+    {
+        if (it->second.generation != _generation)
+        {
+            occupancy.addToCells(it->second.cells.data(), it->second.cells.size(), -1.0f);
+            it = _contributions.erase(it);
+        }
+        else
+        {
+            ++it;
+        }
+    }
+
+    return _changed.size();
+}
+
+void MeshOccupancyCache::reset()
+{
+    _contributions.clear();
+    _generation = 0;
+}
@@ -0,0 +1,113 @@
+//
+//  MeshOccupancyCache.hpp
+//  RoBart
+//
+//  Created by Bart Trzynadlowski on 10/16/26.
+//
+//  This file is part of RoBart.
+//
+//  RoBart is free software: you can redistribute it and/or modify it under the
+//  terms of the GNU General Public License as published by the Free Software
+//  Foundation, either version 3 of the License, or (at your option) any later
+//  version.
+//
+//  RoBart is distributed in the hope that it will be useful, but WITHOUT
+//  ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+//  FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+//  more details.
+//
+//  You should have received a copy of the GNU General Public License along
+//  with RoBart. If not, see <http://www.gnu.org/licenses/>.
+//
+
+#ifndef MeshOccupancyCache_hpp
+#define MeshOccupancyCache_hpp
+
+#include "ElevationMap.hpp"
+#include "OccupancyMap.hpp"
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+/// Identifies an ARKit mesh anchor. Holds the two halves of the anchor's UUID.
+struct MeshAnchorID
+{
+    uint64_t high;
+    uint64_t low;
+
+    bool operator==(const MeshAnchorID &rhs) const
+    {
+        return high == rhs.high && low == rhs.low;
+    }
+
+    struct Hash
+    {
+        std::size_t operator()(const MeshAnchorID &key) const
+        {
+            // UUIDs are already well mixed
+            return std::size_t(key.high ^ key.low);
+        }
+    };
+};
+
+/// Maintains an occupancy map built from scene mesh anchors incrementally. Each anchor's
+/// contribution (the cells its triangles cover) is remembered along with the anchor's version
+/// (MeshVertexSpan::version) and a hash of its geometry and transform. Cells hold reference counts
+/// rather than 0/1, so when an anchor changes its old contribution can be subtracted and its new
+/// one added. Anchors whose version is unchanged cost only a lookup; only those ARKit reported as
+/// updated are hashed, so that updates that left the geometry as it was are not re-rasterized.
+///
+/// A cache must always be used with the same occupancy map, which must not otherwise be modified.
+class MeshOccupancyCache
+{
+public:
+    /// Brings the occupancy map up to date with the current set of mesh anchors. Anchors no
+    /// longer present have their contributions removed. Changing the height range re-rasterizes
+    /// every anchor.
+    /// - Parameter meshes: Geometry and version of each anchor.
+    /// - Parameter ids: Identifier of each anchor.
+    /// - Parameter numMeshes: Number of anchors.
+    /// - Parameter observed: If not null, the triangles of recomputed anchors are also integrated
+    /// into it, so that it records which cells have been observed at all. Observations are never
+    /// removed, even when their anchor disappears.
+    /// - Returns: Number of anchors whose contributions were recomputed.
+    size_t update(
+        OccupancyMap &occupancy,
+        const MeshVertexSpan *meshes,
+        const MeshAnchorID *ids,
+        size_t numMeshes,
+        float minOccupiedHeight,
+        float maxOccupiedHeight,
+        ElevationMap *observed
+    );
+
+    /// Forgets all contributions. The occupancy map should be cleared as well.
+    void reset();
+
+    size_t numAnchors() const
+    {
+        return _contributions.size();
+    }
+
+private:
+    struct Contribution
+    {
+        uint64_t version = 0;
+        uint64_t hash = 0;
+        uint32_t generation = 0;
+        std::vector<uint32_t> cells;
+    };
+
+    std::unordered_map<MeshAnchorID, Contribution, MeshAnchorID::Hash> _contributions;
+    uint32_t _generation = 0;
+    float _minOccupiedHeight = 0;
+    float _maxOccupiedHeight = 0;
+
+    // Scratch buffers reused across updates
+    std::vector<uint64_t> _hashes;
+    std::vector<size_t> _hashed;
+    std::vector<size_t> _changed;
+    std::vector<std::vector<uint32_t>> _changedCells;
+};
+
+#endif /* MeshOccupancyCache_hpp */
@@ -21,11 +21,15 @@
 //
 
 #include "OccupancyMap.hpp"
+#include "FrameArena.hpp"
+#include "ThreadPool.hpp"
 #include <algorithm>
+#include <atomic>
 #include <cmath>
 #include <cstdlib>
 #include <iostream>
 #include <memory>
+#include <vector>
 
 OccupancyMap::OccupancyMap(float width, float depth, float cellSide, simd_float3 centerPoint)
 {
@@ -69,6 +73,21 @@ OccupancyMap::OccupancyMap(const OccupancyMap &rhs)
 {
 }
 
+void OccupancyMap::copyOccupancyFrom(const OccupancyMap &other)
+{
+    if (other.numCells() != numCells())
+    {
+        std::cout << "[OccupancyMap] Error: Occupancy map dimensions do not match" << std::endl;
+        return;
+    }
+    memcpy(_occupancy.get(), other._occupancy.get(), sizeof(float) * numCells());
+}
+
+void OccupancyMap::clear()
+{
+    memset(_occupancy.get(), 0, sizeof(float) * numCells());
+}
+
 OccupancyMap::CellIndices OccupancyMap::centerCell() const
 {
     size_t cellX = size_t(round(float(_cellsWide) * 0.5));
@@ -127,28 +146,9 @@ void OccupancyMap::updateCellCounts(
 
     CVPixelBufferLockBaseAddress(depthMap, 0);
 
-    // Get depth intrinsic parameters by scaling by (depthResolution / rgbResolution)
     size_t depthWidth = CVPixelBufferGetWidth(depthMap);
     size_t depthHeight = CVPixelBufferGetHeight(depthMap);
-    simd_float2 depthResolution = simd_make_float2(depthWidth, depthHeight);
-    simd_float2 scale = depthResolution / rgbResolution;
-    simd_float2 invF = (1.0f / scale) * simd_make_float2(1.0f / intrinsics.columns[0].x, 1.0f / intrinsics.columns[1].y);    // 1/(scale_x*fx), 1/(scale_y*fy)
-    simd_float2 c = scale * simd_make_float2(intrinsics.columns[2].x, intrinsics.columns[2].y);                     // scale_x*cx, scale_y*cy
-
-    // Create a depth camera to world matrix. The depth image coordinate system happens to be
-    // almost the same as the ARKit camera system, except y is flipped (everything rotated 180
-    // degrees about the x axis, which points down in portrait orientation).
-    simd_float4x4 rotateDepthToARKit = {
-        simd_make_float4(1, 0, 0, 0),
-        simd_make_float4(0, 1, 0, 0),
-        simd_make_float4(0, 0, 1, 0),
-        simd_make_float4(0, 0, 0, 1)
-    };
-    rotateDepthToARKit.columns[1].y = -1.0; // cos(180)
-    rotateDepthToARKit.columns[1].z = 0.0;  // sin(180)
-    rotateDepthToARKit.columns[2].y = 0.0;  // -sin(180)
-    rotateDepthToARKit.columns[2].z = -1.0; // cos(180)
-    simd_float4x4 cameraToWorld = simd_mul(viewMatrix, rotateDepthToARKit);
+    DepthCamera camera(simd_make_float2(depthWidth, depthHeight), intrinsics, rgbResolution, viewMatrix);
 
     // Decay existing
     for (size_t i = 0; i < numCells(); i++)
@@ -174,13 +174,7 @@ void OccupancyMap::updateCellCounts(
             }
 
             // Compute world position
-            simd_float2 xy = simd_make_float2(x, y);
-            simd_float2 offset = xy - c;                        // (x: x-cx, y: y-cy)
-            simd_float2 depthDivF = depth * invF;               // (x: depth/fx, y: depth/fy)
-            simd_float2 cameraSpacePosXY = offset * depthDivF;  // (x: depth*(x-cx)/fx, y: depth*(y-cy)/fy)
-            simd_float4 cameraSpacePos = simd_make_float4(cameraSpacePosXY.x, cameraSpacePosXY.y, depth, 1.0f);
-            simd_float4 worldPos4 = simd_mul(cameraToWorld, cameraSpacePos);
-            simd_float3 worldPos = simd_make_float3(worldPos4);
+            simd_float3 worldPos = camera.unproject(simd_make_float2(x, y), depth);
 
             // Ignore floor and ceiling; constrain to some horizontal slice
             if (worldPos.y < minHeight || worldPos.y > maxHeight)
@@ -208,6 +202,404 @@ void OccupancyMap::updateCellCounts(
     CVPixelBufferUnlockBaseAddress(depthMap, 0);
 }
 
+void OccupancyMap::updateCellCountsFromPoints(
+    const DepthPointCloud &points,
+    float minHeight,
+    float maxHeight,
+    float incomingSampleWeight,
+    float previousWeight
+)
+{
+    // Decay existing
+    for (size_t i = 0; i < numCells(); i++)
+    {
+        _occupancy[i] *= previousWeight;
+    }
+
+    // Each point counts once for every depth pixel it stands in for
+    const simd_float4 *point = points.points();
+    for (size_t i = 0; i < points.size(); i++, point++)
+    {
+        if (point->y < minHeight || point->y > maxHeight)
+        {
+            continue;
+        }
+        size_t idx = linearIndex(positionToCell(point->xyz));
+        _occupancy[idx] += point->w * incomingSampleWeight;
+    }
+}
+
+void OccupancyMap::updateOccupancyFromMeshes(const MeshVertexSpan *meshes, size_t numMeshes, float minOccupiedHeight, float maxOccupiedHeight)
+{
+    // Threads may mark the same cell, so they write to an atomic mask that is merged afterwards
+    FrameArena &arena = FrameArena::local();
+    FrameArena::Scope scope(arena);
+    std::atomic<uint8_t> *marked = arena.allocate<std::atomic<uint8_t>>(numCells());
+    for (size_t i = 0; i < numCells(); i++)
+    {
+        new (&marked[i]) std::atomic<uint8_t>(0);
+    }
+
+    // Cell lookup as in positionToCell(), hoisted out of the vertex loop
+    CellIndices center = centerCell();
+    simd_float2 gridCenterPoint = _worldPosition[centerIndex()].xz;
+    simd_float2 offset = simd_make_float2(float(center.cellX), float(center.cellZ)) + 0.5f;
+    simd_float2 maxCell = simd_make_float2(float(_cellsWide - 1), float(_cellsDeep - 1));
+    float invCellSide = 1.0f / _cellSide;
+
+    ThreadPool::shared().parallelFor(numMeshes, [&](size_t meshIdx)
+    {
+        const MeshVertexSpan &mesh = meshes[meshIdx];
+        const simd_float4x4 &m = mesh.transform;
+        for (size_t i = 0; i < mesh.numVertices; i++)
+        {
+            simd_float4 worldPos = simd_mul(m, simd_make_float4(mesh.vertices[i], 1.0f));
+            if (worldPos.y < minOccupiedHeight || worldPos.y > maxOccupiedHeight)
+            {
+                continue;
+            }
+
+            simd_float2 cell = simd_floor((worldPos.xz - gridCenterPoint) * invCellSide + offset);
+            cell = simd_clamp(cell, simd_make_float2(0, 0), maxCell);
+            marked[linearIndex(size_t(cell.x), size_t(cell.y))].store(1, std::memory_order_relaxed);
+        }
+    });
+
+    for (size_t i = 0; i < numCells(); i++)
+    {
+        if (marked[i].load(std::memory_order_relaxed))
+        {
+            _occupancy[i] = 1.0f;
+        }
+    }
+}
+
+// Triangle clipped to the height slab and projected onto the xz plane, in fractional cell units
+struct ClippedTriangle
+{
+    simd_float2 points[5];
+    int numPoints;
+    float minHeight;
+    float maxHeight;
+    long minCellX;
+    long maxCellX;
+    long minCellZ;
+    long maxCellZ;
+};
+
+// Sutherland-Hodgman clip of a convex polygon against the half-space sign * (y - limit) >= 0
+static int clipAgainstHeight(const simd_float3 *in, int numIn, simd_float3 *out, float limit, float sign)
+{
+    int numOut = 0;
+    for (int i = 0; i < numIn; i++)
+    {
+        simd_float3 a = in[i];
+        simd_float3 b = in[(i + 1) % numIn];
+        float da = sign * (a.y - limit);
+        float db = sign * (b.y - limit);
+        if (da >= 0)
+        {
+            out[numOut++] = a;
+        }
+        if ((da >= 0) != (db >= 0))
+        {
+            out[numOut++] = a + (b - a) * (da / (da - db));
+        }
+    }
+    return numOut;
+}
+
+// Cell containing a fractional cell coordinate, clamped to the map
+static long clampCell(float fractionalIndex, long numCells)
+{
+    return std::min(numCells - 1, std::max(0L, long(floor(fractionalIndex + 0.5f))));
+}
+
+// Conservative triangle scan conversion shared by the triangle rasterizers. Cell (x, z) covers
+// fractional indices [x - 0.5, x + 0.5) x [z - 0.5, z + 0.5). Geometry beyond the map is clamped to
+// the outer cells, as positionToCell() does for points.
+struct TriangleRasterizer
+{
+    simd_float2 gridCenterPoint;
+    simd_float2 centerCell;
+    float invCellSide;
+    long cellsWide;
+    long cellsDeep;
+    float minHeight;
+    float maxHeight;
+
+    // Transforms a mesh triangle, clips it to the height slab, and projects it. Returns false if
+    // nothing remains.
+    bool clip(const MeshVertexSpan &mesh, size_t triangleIdx, ClippedTriangle *tri) const
+    {
+        simd_float3 triangle[3];
+        for (int i = 0; i < 3; i++)
+        {
+            uint32_t idx = mesh.triangleIndices[3 * triangleIdx + i];
+            triangle[i] = simd_mul(mesh.transform, simd_make_float4(mesh.vertices[idx], 1.0f)).xyz;
+        }
+
+        simd_float3 aboveMin[4];
+        simd_float3 slab[5];
+        int numAboveMin = clipAgainstHeight(triangle, 3, aboveMin, minHeight, 1.0f);
+        int numPoints = clipAgainstHeight(aboveMin, numAboveMin, slab, maxHeight, -1.0f);
+        if (numPoints == 0)
+        {
+            return false;
+        }
+
+        tri->numPoints = numPoints;
+        tri->minHeight = INFINITY;
+        tri->maxHeight = -INFINITY;
+        simd_float2 minPoint = simd_make_float2(INFINITY, INFINITY);
+        simd_float2 maxPoint = simd_make_float2(-INFINITY, -INFINITY);
+        for (int i = 0; i < numPoints; i++)
+        {
+            tri->minHeight = std::min(tri->minHeight, slab[i].y);
+            tri->maxHeight = std::max(tri->maxHeight, slab[i].y);
+            tri->points[i] = (slab[i].xz - gridCenterPoint) * invCellSide + centerCell;
+            minPoint = simd_min(minPoint, tri->points[i]);
+            maxPoint = simd_max(maxPoint, tri->points[i]);
+        }
+        tri->minCellX = clampCell(minPoint.x, cellsWide);
+        tri->minCellZ = clampCell(minPoint.y, cellsDeep);
+        tri->maxCellX = clampCell(maxPoint.x, cellsWide);
+        tri->maxCellZ = clampCell(maxPoint.y, cellsDeep);
+        return true;
+    }
+
+    // Finds the cells in row z overlapped by the convex polygon. Its x extent within the row's z
+    // band is given by the parts of its edges lying in the band. Returns false if there are none.
+    bool rowSpan(const ClippedTriangle &tri, long z, long *xStart, long *xEnd) const
+    {
+        // Cells at the map edge absorb everything beyond it
+        float bandLow = z == 0 ? -INFINITY : float(z) - 0.5f;
+        float bandHigh = z == cellsDeep - 1 ? INFINITY : float(z) + 0.5f;
+        float minX = INFINITY;
+        float maxX = -INFINITY;
+        for (int i = 0; i < tri.numPoints; i++)
+        {
+            simd_float2 a = tri.points[i];
+            simd_float2 b = tri.points[(i + 1) % tri.numPoints];
+            float t0 = 0;
+            float t1 = 1;
+            float dz = b.y - a.y;
+            if (dz == 0)
+            {
+                if (a.y < bandLow || a.y > bandHigh)
+                {
+                    continue;
+                }
+            }
+            else
+            {
+                float tLow = (bandLow - a.y) / dz;
+                float tHigh = (bandHigh - a.y) / dz;
+                t0 = std::max(t0, std::min(tLow, tHigh));
+                t1 = std::min(t1, std::max(tLow, tHigh));
+                if (t0 > t1)
+                {
+                    continue;
+                }
+            }
+            float x0 = a.x + t0 * (b.x - a.x);
+            float x1 = a.x + t1 * (b.x - a.x);
+            minX = std::min(minX, std::min(x0, x1));
+            maxX = std::max(maxX, std::max(x0, x1));
+        }
+        if (minX > maxX)
+        {
+            return false;
+        }
+        *xStart = clampCell(minX, cellsWide);
+        *xEnd = clampCell(maxX, cellsWide);
+        return true;
+    }
+};
+
+static constexpr long rasterTileSide = 16;
+
+TriangleRasterizer OccupancyMap::makeTriangleRasterizer(float minOccupiedHeight, float maxOccupiedHeight) const
+{
+    CellIndices center = centerCell();
+    TriangleRasterizer rasterizer;
+    rasterizer.gridCenterPoint = _worldPosition[centerIndex()].xz;
+    rasterizer.centerCell = simd_make_float2(float(center.cellX), float(center.cellZ));
+    rasterizer.invCellSide = 1.0f / _cellSide;
+    rasterizer.cellsWide = long(_cellsWide);
+    rasterizer.cellsDeep = long(_cellsDeep);
+    rasterizer.minHeight = minOccupiedHeight;
+    rasterizer.maxHeight = maxOccupiedHeight;
+    return rasterizer;
+}
+
+void OccupancyMap::updateOccupancyFromMeshTriangles(const MeshVertexSpan *meshes, size_t numMeshes, float minOccupiedHeight, float maxOccupiedHeight)
+{
+    TriangleRasterizer rasterizer = makeTriangleRasterizer(minOccupiedHeight, maxOccupiedHeight);
+    long tilesWide = (rasterizer.cellsWide + rasterTileSide - 1) / rasterTileSide;
+    long tilesDeep = (rasterizer.cellsDeep + rasterTileSide - 1) / rasterTileSide;
+
+    FrameArena &arena = FrameArena::local();
+    FrameArena::Scope scope(arena);
+
+    // Clip and project each mesh's triangles independently. Each mesh gets room for all of its
+    // triangles; pages of the arena that are never written cost nothing.
+    size_t *meshStart = arena.allocate<size_t>(numMeshes + 1);
+    meshStart[0] = 0;
+    for (size_t meshIdx = 0; meshIdx < numMeshes; meshIdx++)
+    {
+        meshStart[meshIdx + 1] = meshStart[meshIdx] + meshes[meshIdx].numTriangles;
+    }
+    ClippedTriangle *clipped = arena.allocate<ClippedTriangle>(meshStart[numMeshes]);
+    size_t *numClipped = arena.allocate<size_t>(numMeshes);
+    ThreadPool::shared().parallelFor(numMeshes, [&](size_t meshIdx)
+    {
+        const MeshVertexSpan &mesh = meshes[meshIdx];
+        ClippedTriangle *out = &clipped[meshStart[meshIdx]];
+        size_t count = 0;
+        for (size_t t = 0; t < mesh.numTriangles; t++)
+        {
+            if (rasterizer.clip(mesh, t, &out[count]))
+            {
+                count++;
+            }
+        }
+        numClipped[meshIdx] = count;
+    });
+
+    // Bin triangles into every tile their cell bounds overlap: count, then fill each tile's range
+    size_t numTiles = size_t(tilesWide * tilesDeep);
+    size_t *binStart = arena.allocate<size_t>(numTiles + 1, 0);
+    auto forEachBinnedTile = [&](auto &&fn)
+    {
+        for (size_t meshIdx = 0; meshIdx < numMeshes; meshIdx++)
+        {
+            const ClippedTriangle *tris = &clipped[meshStart[meshIdx]];
+            for (size_t i = 0; i < numClipped[meshIdx]; i++)
+            {
+                const ClippedTriangle &tri = tris[i];
+                for (long tz = tri.minCellZ / rasterTileSide; tz <= tri.maxCellZ / rasterTileSide; tz++)
+                {
+                    for (long tx = tri.minCellX / rasterTileSide; tx <= tri.maxCellX / rasterTileSide; tx++)
+                    {
+                        fn(size_t(tz * tilesWide + tx), &tri);
+                    }
+                }
+            }
+        }
+    };
+    forEachBinnedTile([&](size_t tileIdx, const ClippedTriangle *)
+    {
+        binStart[tileIdx + 1]++;
+    });
+    for (size_t tileIdx = 0; tileIdx < numTiles; tileIdx++)
+    {
+        binStart[tileIdx + 1] += binStart[tileIdx];
+    }
+    const ClippedTriangle **binned = arena.allocate<const ClippedTriangle *>(binStart[numTiles]);
+    size_t *binFill = arena.allocate<size_t>(numTiles);
+    std::copy(binStart, binStart + numTiles, binFill);
+    forEachBinnedTile([&](size_t tileIdx, const ClippedTriangle *tri)
+    {
+        binned[binFill[tileIdx]++] = tri;
+    });
+
+    // Scan-convert each tile. Tiles cover disjoint cells, so they can write the map directly.
+    ThreadPool::shared().parallelFor(numTiles, [&](size_t tileIdx)
+    {
+        long tileMinX = long(tileIdx % tilesWide) * rasterTileSide;
+        long tileMinZ = long(tileIdx / tilesWide) * rasterTileSide;
+        long tileMaxX = std::min(tileMinX + rasterTileSide, rasterizer.cellsWide) - 1;
+        long tileMaxZ = std::min(tileMinZ + rasterTileSide, rasterizer.cellsDeep) - 1;
+        for (size_t i = binStart[tileIdx]; i < binStart[tileIdx + 1]; i++)
+        {
+            const ClippedTriangle *tri = binned[i];
+            long zStart = std::max(tileMinZ, tri->minCellZ);
+            long zEnd = std::min(tileMaxZ, tri->maxCellZ);
+            for (long z = zStart; z <= zEnd; z++)
+            {
+                long xStart;
+                long xEnd;
+                if (!rasterizer.rowSpan(*tri, z, &xStart, &xEnd))
+                {
+                    continue;
+                }
+                for (long x = std::max(tileMinX, xStart); x <= std::min(tileMaxX, xEnd); x++)
+                {
+                    _occupancy[linearIndex(size_t(x), size_t(z))] = 1.0f;
+                }
+            }
+        }
+    });
+}
+
+void OccupancyMap::getMeshTriangleCells(const MeshVertexSpan &mesh, float minOccupiedHeight, float maxOccupiedHeight, std::vector<uint32_t> *cells) const
+{
+    TriangleRasterizer rasterizer = makeTriangleRasterizer(minOccupiedHeight, maxOccupiedHeight);
+    cells->clear();
+    ClippedTriangle tri;
+    for (size_t t = 0; t < mesh.numTriangles; t++)
+    {
+        if (!rasterizer.clip(mesh, t, &tri))
+        {
+            continue;
+        }
+        for (long z = tri.minCellZ; z <= tri.maxCellZ; z++)
+        {
+            long xStart;
+            long xEnd;
+            if (!rasterizer.rowSpan(tri, z, &xStart, &xEnd))
+            {
+                continue;
+            }
+            for (long x = xStart; x <= xEnd; x++)
+            {
+                cells->push_back(uint32_t(linearIndex(size_t(x), size_t(z))));
+            }
+        }
+    }
+
+    // Neighboring triangles share cells
+    std::sort(cells->begin(), cells->end());
+    cells->erase(std::unique(cells->begin(), cells->end()), cells->end());
+}
+
+void OccupancyMap::getMeshTriangleHeights(const MeshVertexSpan &mesh, float minHeight, float maxHeight, float *cellMinHeight, float *cellMaxHeight) const
+{
+    TriangleRasterizer rasterizer = makeTriangleRasterizer(minHeight, maxHeight);
+    ClippedTriangle tri;
+    for (size_t t = 0; t < mesh.numTriangles; t++)
+    {
+        if (!rasterizer.clip(mesh, t, &tri))
+        {
+            continue;
+        }
+        for (long z = tri.minCellZ; z <= tri.maxCellZ; z++)
+        {
+            long xStart;
+            long xEnd;
+            if (!rasterizer.rowSpan(tri, z, &xStart, &xEnd))
+            {
+                continue;
+            }
+            for (long x = xStart; x <= xEnd; x++)
+            {
+                size_t idx = linearIndex(size_t(x), size_t(z));
+                cellMinHeight[idx] = std::min(cellMinHeight[idx], tri.minHeight);
+                cellMaxHeight[idx] = std::max(cellMaxHeight[idx], tri.maxHeight);
+            }
+        }
+    }
+}
+
+void OccupancyMap::addToCells(const uint32_t *cells, size_t count, float amount)
+{
+    for (size_t i = 0; i < count; i++)
+    {
+        _occupancy[cells[i]] += amount;
+    }
+}
+
 void OccupancyMap::updateOccupancyFromCounts(const OccupancyMap &counts, float thresholdAmount)
 {
     assert(counts.numCells() == numCells());
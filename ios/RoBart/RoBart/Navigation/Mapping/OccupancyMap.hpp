@@ -23,10 +23,26 @@
 #ifndef OccupancyMap_hpp
 #define OccupancyMap_hpp
 
+#include "DepthPointCloud.hpp"
 #include <CoreVideo/CoreVideo.h>
 #include <simd/simd.h>
 #include <algorithm>
 #include <memory>
+#include <vector>
+
+struct TriangleRasterizer;
+
+/// Vertices and triangles of a single scene mesh, in the mesh's local space, and the transform to
+/// world space. The arrays are not owned.
+struct MeshVertexSpan
+{
+    const simd_float3 *vertices;
+    size_t numVertices;
+    const uint32_t *triangleIndices;    // 3 vertex indices per triangle
+    size_t numTriangles;
+    simd_float4x4 transform;
+    uint64_t version;                   // changes whenever the anchor's geometry or transform is updated
+};
 
 class OccupancyMap
 {
@@ -84,6 +100,9 @@ public:
     /// modifications to the new occupancy map will also affect the original object.
     OccupancyMap(const OccupancyMap &rhs);
 
+    /// Overwrites the cell values with those of a map of the same dimensions.
+    void copyOccupancyFrom(const OccupancyMap &other);
+
     void clear();
 
     void updateCellCounts(
@@ -99,6 +118,43 @@ public:
         float previousWeight
     );
 
+    /// Equivalent of updateCellCounts() for a point cloud that has already been unprojected (and
+    /// possibly downsampled). Each point adds its pixel count, so counts are comparable to those
+    /// obtained from the full depth map.
+    void updateCellCountsFromPoints(
+        const DepthPointCloud &points,
+        float minHeight,
+        float maxHeight,
+        float incomingSampleWeight,
+        float previousWeight
+    );
+
+    /// CPU equivalent of the processVerticesAndUpdateOccupancy compute shader. Marks each cell
+    /// containing a mesh vertex whose world-space height is within [ minOccupiedHeight,
+    /// maxOccupiedHeight ] as occupied. Meshes are processed in parallel. Does not clear the map
+    /// beforehand.
+    void updateOccupancyFromMeshes(const MeshVertexSpan *meshes, size_t numMeshes, float minOccupiedHeight, float maxOccupiedHeight);
+
+    /// Marks each cell overlapped by the part of a mesh triangle lying within [ minOccupiedHeight,
+    /// maxOccupiedHeight ] as occupied. Unlike updateOccupancyFromMeshes(), large triangles leave no
+    /// gaps between their vertices. Triangles are clipped and binned into tiles in parallel per mesh,
+    /// then tiles are scan-converted in parallel. Does not clear the map beforehand.
+    void updateOccupancyFromMeshTriangles(const MeshVertexSpan *meshes, size_t numMeshes, float minOccupiedHeight, float maxOccupiedHeight);
+
+    /// Finds the cells that updateOccupancyFromMeshTriangles() would mark for a single mesh.
+    /// - Parameter cells: Receives the sorted, unique linear indices of the cells.
+    void getMeshTriangleCells(const MeshVertexSpan &mesh, float minOccupiedHeight, float maxOccupiedHeight, std::vector<uint32_t> *cells) const;
+
+    /// Rasterizes the triangles of a single mesh as getMeshTriangleCells() does and, for each cell
+    /// overlapped, lowers `cellMinHeight` and raises `cellMaxHeight` (both in linear index order) to
+    /// the height range of the part of the triangle within [ minHeight, maxHeight ]. Scene mesh
+    /// triangles are much smaller than a cell, so this range closely bounds the surface in the cell.
+    void getMeshTriangleHeights(const MeshVertexSpan &mesh, float minHeight, float maxHeight, float *cellMinHeight, float *cellMaxHeight) const;
+
+    /// Adds `amount` to each of the given cells, identified by linear index. Used to maintain
+    /// per-cell reference counts.
+    void addToCells(const uint32_t *cells, size_t count, float amount);
+
     void updateOccupancyFromCounts(const OccupancyMap &counts, float thresholdAmount);
     void updateOccupancyFromHeightMap(const float *heights, size_t size, float occupancyHeightThreshold);
     void updateOccupancyFromArray(const float *occupied, size_t size);
@@ -191,6 +247,7 @@ public:
     };
 
 private:
+    TriangleRasterizer makeTriangleRasterizer(float minOccupiedHeight, float maxOccupiedHeight) const;
     CellIndices centerCell() const;
     size_t centerIndex() const;
 
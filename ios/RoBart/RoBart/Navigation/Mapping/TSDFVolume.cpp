@@ -0,0 +1,272 @@
+//
+//  TSDFVolume.cpp
+//  RoBart
+//
+//  Created by Bart Trzynadlowski on 10/16/26.
+//
+//  This file is part of RoBart.
+//
+//  RoBart is free software: you can redistribute it and/or modify it under the
+//  terms of the GNU General Public License as published by the Free Software
+//  Foundation, either version 3 of the License, or (at your option) any later
+//  version.
+//
+//  RoBart is distributed in the hope that it will be useful, but WITHOUT
+//  ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+//  FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+//  more details.
+//
+//  You should have received a copy of the GNU General Public License along
+//  with RoBart. If not, see <http://www.gnu.org/licenses/>.
+//
+
+
+#include "TSDFVolume.hpp"
+#include "FrameArena.hpp"
+#include "ThreadPool.hpp"
+#include <algorithm>
+#include <cmath>
+#include <iterator>
+
+void TSDFVolume::Block::reset()
+{
+    std::fill(std::begin(sdf), std::end(sdf), 1.0f);
+    std::fill(std::begin(weight), std::end(weight), 0.0f);
+    locked.store(false, std::memory_order_relaxed);
+}
+
+void TSDFVolume::Block::lock()
+{
+    // Contention is rare because neighboring rays mostly land in different blocks at any instant
+    while (locked.exchange(true, std::memory_order_acquire))
+    {
+        while (locked.load(std::memory_order_relaxed))
+        {
+        }
+    }
+}
+
+void TSDFVolume::Block::unlock()
+{
+    locked.store(false, std::memory_order_release);
+}
+
+TSDFVolume::TSDFVolume(float voxelSide, float truncationDistance, float maxWeight)
+    : _voxelSide(voxelSide),
+      _invVoxelSide(1.0f / voxelSide),
+      _truncationDistance(std::max(truncationDistance, voxelSide)),
+      _maxWeight(std::max(maxWeight, 1.0f)),
+      _state(std::make_shared<State>())
+{
+}
+
+void TSDFVolume::clear()
+{
+    _state->blocks.clear();
+}
+
+static inline simd_int3 toVoxel(simd_float3 position, float invVoxelSide)
+{
+    simd_float3 v = simd_floor(position * invVoxelSide);
+    return simd_make_int3(int32_t(v.x), int32_t(v.y), int32_t(v.z));
+}
+
+void TSDFVolume::integrateDepth(
+    CVPixelBufferRef depthMap,
+    simd_float3x3 intrinsics,
+    simd_float2 rgbResolution,
+    simd_float4x4 viewMatrix,
+    float minDepth,
+    float maxDepth
+)
+{
+    assert(CVPixelBufferGetPixelFormatType(depthMap) == kCVPixelFormatType_DepthFloat32);
+
+    CVPixelBufferLockBaseAddress(depthMap, kCVPixelBufferLock_ReadOnly);
+
+    size_t depthWidth = CVPixelBufferGetWidth(depthMap);
+    size_t depthHeight = CVPixelBufferGetHeight(depthMap);
+    DepthCamera camera(simd_make_float2(depthWidth, depthHeight), intrinsics, rgbResolution, viewMatrix);
+    simd_float3 origin = camera.position();
+
+    const uint8_t *base = reinterpret_cast<const uint8_t *>(CVPixelBufferGetBaseAddress(depthMap));
+    size_t bytesPerRow = CVPixelBufferGetBytesPerRow(depthMap);
+
+    // Each ray updates the voxels it passes through within the truncation band around its
+    // surface point, sampled at voxel-side intervals. Both passes below walk the same samples.
+    float truncation = _truncationDistance;
+    float invTruncation = 1.0f / truncation;
+    float voxelSide = _voxelSide;
+    float invVoxelSide = _invVoxelSide;
+    int numSteps = int(ceil(2.0f * truncation * invVoxelSide)) + 1;
+    auto forEachRay = [=](size_t row, auto &&fn)
+    {
+        const float *depthValues = reinterpret_cast<const float *>(base + row * bytesPerRow);
+        for (size_t x = 0; x < depthWidth; x++)
+        {
+            float depth = depthValues[x];
+            if (depth < minDepth || depth > maxDepth)
+            {
+                continue;
+            }
+
+            simd_float3 toSurface = camera.unproject(simd_make_float2(x, row), depth) - origin;
+            float distance = simd_length(toSurface);
+            simd_float3 direction = toSurface / distance;
+            fn(distance, direction);
+        }
+    };
+
+    ThreadPool &pool = ThreadPool::shared();
+    size_t numSlices = std::min(pool.numThreads() + 1, depthHeight);
+    size_t rowsPerSlice = (depthHeight + numSlices - 1) / numSlices;
+    _state->touchedKeys.resize(numSlices);
+
+    // Pass 1: gather the blocks touched by each slice of rows. Consecutive samples along a ray
+    // and adjacent rays mostly fall in the same block, so only changes of block are recorded.
+    pool.parallelFor(numSlices, [&](size_t slice)
+    {
+        std::vector<uint64_t> &keys = _state->touchedKeys[slice];
+        keys.clear();
+        uint64_t lastKey = ~uint64_t(0);
+        size_t endRow = std::min(depthHeight, (slice + 1) * rowsPerSlice);
+        for (size_t row = slice * rowsPerSlice; row < endRow; row++)
+        {
+            forEachRay(row, [&](float distance, simd_float3 direction)
+            {
+                float t = distance - truncation;
+                for (int step = 0; step < numSteps; step++, t += voxelSide)
+                {
+                    simd_int3 voxel = toVoxel(origin + t * direction, invVoxelSide);
+                    uint64_t key = VoxelBlockHash<Block>::packKey(voxel.x >> 3, voxel.y >> 3, voxel.z >> 3);
+                    if (key != lastKey)
+                    {
+                        keys.push_back(key);
+                        lastKey = key;
+                    }
+                }
+            });
+        }
+    });
+
+    // Allocation is serial so that lookups in the next pass need no synchronization
+    for (const std::vector<uint64_t> &keys : _state->touchedKeys)
+    {
+        for (uint64_t key : keys)
+        {
+            _state->blocks.findOrAllocate(key);
+        }
+    }
+
+    // Pass 2: fuse the projective distance into each sampled voxel. A block's lock is held for
+    // as long as consecutive samples stay within it.
+    const VoxelBlockHash<Block> &blocks = _state->blocks;
+    float maxWeight = _maxWeight;
+    pool.parallelFor(numSlices, [&](size_t slice)
+    {
+        uint64_t heldKey = ~uint64_t(0);
+        Block *heldBlock = nullptr;
+        size_t endRow = std::min(depthHeight, (slice + 1) * rowsPerSlice);
+        for (size_t row = slice * rowsPerSlice; row < endRow; row++)
+        {
+            forEachRay(row, [&](float distance, simd_float3 direction)
+            {
+                int lastVoxelIdx = -1;
+                float t = distance - truncation;
+                for (int step = 0; step < numSteps; step++, t += voxelSide)
+                {
+                    simd_int3 voxel = toVoxel(origin + t * direction, invVoxelSide);
+                    uint64_t key = VoxelBlockHash<Block>::packKey(voxel.x >> 3, voxel.y >> 3, voxel.z >> 3);
+                    if (key != heldKey)
+                    {
+                        if (heldBlock)
+                        {
+                            heldBlock->unlock();
+                        }
+                        heldBlock = blocks.find(key);
+                        heldBlock->lock();
+                        heldKey = key;
+                        lastVoxelIdx = -1;
+                    }
+
+                    // Samples are closer together than voxels along diagonals; update each once
+                    int voxelIdx = ((voxel.y & 7) * blockSide + (voxel.z & 7)) * blockSide + (voxel.x & 7);
+                    if (voxelIdx == lastVoxelIdx)
+                    {
+                        continue;
+                    }
+                    lastVoxelIdx = voxelIdx;
+
+                    // Distance from voxel center to surface, measured along the ray
+                    simd_float3 center = (simd_make_float3(voxel.x, voxel.y, voxel.z) + 0.5f) * voxelSide;
+                    float sdf = distance - simd_dot(center - origin, direction);
+                    if (sdf < -truncation)
+                    {
+                        continue;
+                    }
+                    float tsdf = std::min(sdf * invTruncation, 1.0f);
+
+                    float &weight = heldBlock->weight[voxelIdx];
+                    float &value = heldBlock->sdf[voxelIdx];
+                    value = (value * weight + tsdf) / (weight + 1.0f);
+                    weight = std::min(weight + 1.0f, maxWeight);
+                }
+            });
+        }
+        if (heldBlock)
+        {
+            heldBlock->unlock();
+        }
+    });
+
+    CVPixelBufferUnlockBaseAddress(depthMap, kCVPixelBufferLock_ReadOnly);
+}
+
+void TSDFVolume::extractSlice(OccupancyMap &slice, float minHeight, float maxHeight, float minWeight) const
+{
+    FrameArena &arena = FrameArena::local();
+    FrameArena::Scope scope(arena);
+    float *occupied = arena.allocate<float>(slice.numCells(), 0.0f);
+
+    // Range of voxel y indices whose centers lie within the slab
+    int32_t minVoxelY = int32_t(ceil(minHeight * _invVoxelSide - 0.5f));
+    int32_t maxVoxelY = int32_t(floor(maxHeight * _invVoxelSide - 0.5f));
+    float maxSurfaceDistance = _voxelSide / _truncationDistance;
+
+    const VoxelBlockHash<Block> &blocks = _state->blocks;
+    for (size_t blockIdx = 0; blockIdx < blocks.size(); blockIdx++)
+    {
+        simd_int3 blockCoords = VoxelBlockHash<Block>::unpackKey(blocks.keyAt(blockIdx));
+        int32_t blockMinY = blockCoords.y * blockSide;
+        int32_t lo = std::max(minVoxelY - blockMinY, 0);
+        int32_t hi = std::min(maxVoxelY - blockMinY, blockSide - 1);
+        if (lo > hi)
+        {
+            continue;
+        }
+
+        const Block &block = blocks.blockAt(blockIdx);
+        for (int z = 0; z < blockSide; z++)
+        {
+            for (int x = 0; x < blockSide; x++)
+            {
+                for (int y = lo; y <= hi; y++)
+                {
+                    int voxelIdx = (y * blockSide + z) * blockSide + x;
+                    if (block.weight[voxelIdx] >= minWeight && fabs(block.sdf[voxelIdx]) < maxSurfaceDistance)
+                    {
+                        simd_float3 columnCenter = simd_make_float3(
+                            (float(blockCoords.x * blockSide + x) + 0.5f) * _voxelSide,
+                            0,
+                            (float(blockCoords.z * blockSide + z) + 0.5f) * _voxelSide
+                        );
+                        occupied[slice.linearIndex(slice.positionToCell(columnCenter))] = 1.0f;
+                        break;
+                    }
+                }
+            }
+        }
+    }
+
+    slice.updateOccupancyFromArray(occupied, slice.numCells());
+}
@@ -0,0 +1,116 @@
+//
+//  TSDFVolume.hpp
+//  RoBart
+//
+//  Created by Bart Trzynadlowski on 10/16/26.
+//
+//  This file is part of RoBart.
+//
+//  RoBart is free software: you can redistribute it and/or modify it under the
+//  terms of the GNU General Public License as published by the Free Software
+//  Foundation, either version 3 of the License, or (at your option) any later
+//  version.
+//
+//  RoBart is distributed in the hope that it will be useful, but WITHOUT
+//  ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+//  FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+//  more details.
+//
+//  You should have received a copy of the GNU General Public License along
+//  with RoBart. If not, see <http://www.gnu.org/licenses/>.
+//
+
+
+#ifndef TSDFVolume_hpp
+#define TSDFVolume_hpp
+
+#include "OccupancyMap.hpp"
+#include "VoxelBlockHash.hpp"
+#include <CoreVideo/CoreVideo.h>
+#include <simd/simd.h>
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+/// Truncated signed distance field over sparse 8x8x8-voxel blocks. Each voxel holds a weighted
+/// running average of its distance to the nearest observed surface along the camera ray,
+/// normalized by the truncation distance so that it lies in [-1, 1] (positive in free space in
+/// front of the surface). Unlike VoxelMap, depth noise averages out over frames and surfaces are
+/// located to within a fraction of a voxel.
+///
+/// Copies share the same volume.
+class TSDFVolume
+{
+public:
+    /// - Parameter voxelSide: Side length of a voxel (m).
+    /// - Parameter truncationDistance: Distance either side of a surface that is updated (m).
+    /// Typically a few voxel sides.
+    /// - Parameter maxWeight: Upper bound on accumulated weight, which determines how quickly the
+    /// volume adapts to changes in the scene.
+    TSDFVolume(float voxelSide, float truncationDistance, float maxWeight);
+
+    /// Removes all voxels. Pool memory is retained for reuse.
+    void clear();
+
+    /// Fuses a depth frame into the volume. Inputs are as for OccupancyMap::updateCellCounts().
+    /// Rows of the depth map are processed in parallel on the shared thread pool.
+    void integrateDepth(
+        CVPixelBufferRef depthMap,
+        simd_float3x3 intrinsics,
+        simd_float2 rgbResolution,
+        simd_float4x4 viewMatrix,
+        float minDepth,
+        float maxDepth
+    );
+
+    /// Overwrites `slice` so that a cell is occupied if it contains the center of a surface voxel
+    /// whose center height lies within [ minHeight, maxHeight ]. Surface voxels are those with at
+    /// least `minWeight` of observations and a distance to the zero crossing of less than one voxel
+    /// side. The map is owned by the caller and should be reused from frame to frame.
+    void extractSlice(OccupancyMap &slice, float minHeight, float maxHeight, float minWeight) const;
+
+    size_t numBlocks() const
+    {
+        return _state->blocks.size();
+    }
+
+    float voxelSide() const
+    {
+        return _voxelSide;
+    }
+
+private:
+    static constexpr int blockSide = 8;
+
+    struct Block
+    {
+        // Normalized distance and weight of each voxel, indexed by (y * 8 + z) * 8 + x
+        float sdf[blockSide * blockSide * blockSide];
+        float weight[blockSide * blockSide * blockSide];
+
+        // Held by the integrating thread while it updates the block
+        std::atomic<bool> locked;
+
+        void reset();
+        void lock();
+        void unlock();
+    };
+
+    float _voxelSide;
+    float _invVoxelSide;
+    float _truncationDistance;
+    float _maxWeight;
+
+    struct State
+    {
+        VoxelBlockHash<Block> blocks;
+
+        // Per-slice block keys touched by the current frame
+        std::vector<std::vector<uint64_t>> touchedKeys;
+    };
+
+    std::shared_ptr<State> _state;
+};
+
+#endif /* TSDFVolume_hpp */
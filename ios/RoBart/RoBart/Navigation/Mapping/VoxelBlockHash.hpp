@@ -0,0 +1,174 @@
+//
+//  VoxelBlockHash.hpp
+//  RoBart
+//
+//  Created by Bart Trzynadlowski on 10/16/26.
+//
+//  This file is part of RoBart.
+//
+//  RoBart is free software: you can redistribute it and/or modify it under the
+//  terms of the GNU General Public License as published by the Free Software
+//  Foundation, either version 3 of the License, or (at your option) any later
+//  version.
+//
+//  RoBart is distributed in the hope that it will be useful, but WITHOUT
+//  ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+//  FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+//  more details.
+//
+//  You should have received a copy of the GNU General Public License along
+//  with RoBart. If not, see <http://www.gnu.org/licenses/>.
+//
+
+#ifndef VoxelBlockHash_hpp
+#define VoxelBlockHash_hpp
+
+#include <simd/simd.h>
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+/// Sparse storage for blocks of voxels, located through an open-addressing hash table (linear
+/// probing, power-of-two capacity) keyed on packed block coordinates. Blocks are allocated from a
+/// pool of fixed-size chunks that is never freed, so blocks have stable addresses and are reused
+/// after clear(). `Block` must provide a reset() method that puts it in its initial state.
+///
+/// Lookups may run concurrently with each other but not with allocation.
+template <typename Block>
+class VoxelBlockHash
+{
+public:
+    VoxelBlockHash()
+        : _slots(initialSlots, Slot{ emptyKey, 0 })
+    {
+    }
+
+    static uint64_t packKey(int32_t bx, int32_t by, int32_t bz)
+    {
+        // Block coordinates are packed as 21-bit unsigned values
+        return ((uint64_t(bx) + keyBias) & keyMask) | (((uint64_t(by) + keyBias) & keyMask) << 21) | (((uint64_t(bz) + keyBias) & keyMask) << 42);
+    }
+
+    static simd_int3 unpackKey(uint64_t key)
+    {
+        return simd_make_int3(
+            int32_t(int64_t(key & keyMask) - int64_t(keyBias)),
+            int32_t(int64_t((key >> 21) & keyMask) - int64_t(keyBias)),
+            int32_t(int64_t((key >> 42) & keyMask) - int64_t(keyBias))
+        );
+    }
+
+    void clear()
+    {
+        std::fill(_slots.begin(), _slots.end(), Slot{ emptyKey, 0 });
+        _keys.clear();
+    }
+
+    size_t size() const
+    {
+        return _keys.size();
+    }
+
+    uint64_t keyAt(size_t blockIdx) const
+    {
+        return _keys[blockIdx];
+    }
+
+    Block &blockAt(size_t blockIdx) const
+    {
+        return _chunks[blockIdx / blocksPerChunk][blockIdx % blocksPerChunk];
+    }
+
+    /// - Returns: The block, or nullptr if it has not been allocated.
+    Block *find(uint64_t key) const
+    {
+        size_t mask = _slots.size() - 1;
+        for (size_t i = slotFor(key); ; i = (i + 1) & mask)
+        {
+            const Slot &slot = _slots[i];
+            if (slot.key == key)
+            {
+                return &blockAt(slot.blockIdx);
+            }
+            if (slot.key == emptyKey)
+            {
+                return nullptr;
+            }
+        }
+    }
+
+    Block &findOrAllocate(uint64_t key)
+    {
+        size_t mask = _slots.size() - 1;
+        size_t i = slotFor(key);
+        while (_slots[i].key != emptyKey)
+        {
+            if (_slots[i].key == key)
+            {
+                return blockAt(_slots[i].blockIdx);
+            }
+            i = (i + 1) & mask;
+        }
+
+        // Allocate from the pool, adding a chunk only when every existing block is in use
+        uint32_t blockIdx = uint32_t(_keys.size());
+        if (blockIdx / blocksPerChunk >= _chunks.size())
+        {
+            _chunks.emplace_back(new Block[blocksPerChunk]);
+        }
+        Block &block = blockAt(blockIdx);
+        block.reset();
+        _keys.push_back(key);
+        _slots[i] = Slot{ key, blockIdx };
+
+        // Keep the load factor at or below 1/2
+        if (2 * _keys.size() > _slots.size())
+        {
+            grow();
+        }
+        return block;
+    }
+
+private:
+    static constexpr size_t blocksPerChunk = 256;
+    static constexpr size_t initialSlots = 1024;
+    static constexpr uint64_t emptyKey = ~uint64_t(0);
+    static constexpr uint64_t keyBias = uint64_t(1) << 20;
+    static constexpr uint64_t keyMask = (uint64_t(1) << 21) - 1;
+
+    struct Slot
+    {
+        uint64_t key;
+        uint32_t blockIdx;
+    };
+
+    size_t slotFor(uint64_t key) const
+    {
+        // Fibonacci hashing onto the top log2(capacity) bits
+        int shift = 64 - __builtin_ctzll(_slots.size());
+        return size_t((key * 0x9e3779b97f4a7c15ULL) >> shift);
+    }
+
+    void grow()
+    {
+        _slots.assign(2 * _slots.size(), Slot{ emptyKey, 0 });
+        size_t mask = _slots.size() - 1;
+        for (uint32_t blockIdx = 0; blockIdx < _keys.size(); blockIdx++)
+        {
+            size_t i = slotFor(_keys[blockIdx]);
+            while (_slots[i].key != emptyKey)
+            {
+                i = (i + 1) & mask;
+            }
+            _slots[i] = Slot{ _keys[blockIdx], blockIdx };
+        }
+    }
+
+    std::vector<std::unique_ptr<Block[]>> _chunks;
+    std::vector<uint64_t> _keys;
+    std::vector<Slot> _slots;
+};
+
+#endif /* VoxelBlockHash_hpp */
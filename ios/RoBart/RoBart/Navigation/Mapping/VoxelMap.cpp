@@ -0,0 +1,173 @@
+//
+//  VoxelMap.cpp
+//  RoBart
+//
+//  Created by Bart Trzynadlowski on 10/16/26.
+//
+//  This file is part of RoBart.
+//
+//  RoBart is free software: you can redistribute it and/or modify it under the
+//  terms of the GNU General Public License as published by the Free Software
+//  Foundation, either version 3 of the License, or (at your option) any later
+//  version.
+//
+//  RoBart is distributed in the hope that it will be useful, but WITHOUT
+//  ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+//  FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+//  more details.
+//
+//  You should have received a copy of the GNU General Public License along
+//  with RoBart. If not, see <http://www.gnu.org/licenses/>.
+//
+
+#include "VoxelMap.hpp"
+#include "FrameArena.hpp"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+static constexpr uint64_t everyByte = 0x0101010101010101ULL;
+
+void VoxelMap::Block::reset()
+{
+    memset(hits, 0, sizeof(hits));
+    memset(columns, 0, sizeof(columns));
+}
+
+VoxelMap::VoxelMap(float voxelSide, uint8_t minHits)
+    : _voxelSide(voxelSide),
+      _invVoxelSide(1.0f / voxelSide),
+      _minHits(std::max(minHits, uint8_t(1))),
+      _state(std::make_shared<State>())
+{
+}
+
+void VoxelMap::clear()
+{
+    _state->blocks.clear();
+    _state->lastKey = ~uint64_t(0);
+    _state->lastBlock = nullptr;
+}
+
+void VoxelMap::markVoxel(simd_int3 voxel)
+{
+    // Arithmetic shifts floor negative coordinates correctly
+    uint64_t key = VoxelBlockHash<Block>::packKey(voxel.x >> 3, voxel.y >> 3, voxel.z >> 3);
+    if (key != _state->lastKey)
+    {
+        _state->lastBlock = &_state->blocks.findOrAllocate(key);
+        _state->lastKey = key;
+    }
+
+    int lx = voxel.x & 7;
+    int ly = voxel.y & 7;
+    int lz = voxel.z & 7;
+    uint8_t &hits = _state->lastBlock->hits[(ly * blockSide + lz) * blockSide + lx];
+    if (hits < 255)
+    {
+        hits++;
+    }
+    if (hits == _minHits)
+    {
+        _state->lastBlock->columns[lz * blockSide + lx] |= uint8_t(1 << ly);
+    }
+}
+
+void VoxelMap::integrateDepth(
+    CVPixelBufferRef depthMap,
+    simd_float3x3 intrinsics,
+    simd_float2 rgbResolution,
+    simd_float4x4 viewMatrix,
+    float minDepth,
+    float maxDepth
+)
+{
+    assert(CVPixelBufferGetPixelFormatType(depthMap) == kCVPixelFormatType_DepthFloat32);
+
+    CVPixelBufferLockBaseAddress(depthMap, kCVPixelBufferLock_ReadOnly);
+
+    size_t depthWidth = CVPixelBufferGetWidth(depthMap);
+    size_t depthHeight = CVPixelBufferGetHeight(depthMap);
+    DepthCamera camera(simd_make_float2(depthWidth, depthHeight), intrinsics, rgbResolution, viewMatrix);
+
+    const uint8_t *base = reinterpret_cast<const uint8_t *>(CVPixelBufferGetBaseAddress(depthMap));
+    size_t bytesPerRow = CVPixelBufferGetBytesPerRow(depthMap);
+    for (size_t y = 0; y < depthHeight; y++)
+    {
+        const float *depthValues = reinterpret_cast<const float *>(base + y * bytesPerRow);
+        for (size_t x = 0; x < depthWidth; x++)
+        {
+            float depth = depthValues[x];
+            if (depth < minDepth || depth > maxDepth)
+            {
+                continue;
+            }
+
+            simd_float3 worldPos = camera.unproject(simd_make_float2(x, y), depth);
+            simd_float3 voxel = simd_floor(worldPos * _invVoxelSide);
+            markVoxel(simd_make_int3(int32_t(voxel.x), int32_t(voxel.y), int32_t(voxel.z)));
+        }
+    }
+
+    CVPixelBufferUnlockBaseAddress(depthMap, kCVPixelBufferLock_ReadOnly);
+}
+
+bool VoxelMap::isOccupied(simd_float3 position) const
+{
+    simd_float3 v = simd_floor(position * _invVoxelSide);
+    simd_int3 voxel = simd_make_int3(int32_t(v.x), int32_t(v.y), int32_t(v.z));
+    const Block *block = _state->blocks.find(VoxelBlockHash<Block>::packKey(voxel.x >> 3, voxel.y >> 3, voxel.z >> 3));
+    if (!block)
+    {
+        return false;
+    }
+    return (block->columns[(voxel.z & 7) * blockSide + (voxel.x & 7)] >> (voxel.y & 7)) & 1;
+}
+
+void VoxelMap::project(OccupancyMap &projected, float minHeight, float maxHeight) const
+{
+    FrameArena &arena = FrameArena::local();
+    FrameArena::Scope scope(arena);
+    float *occupied = arena.allocate<float>(projected.numCells(), 0.0f);
+
+    // Range of voxel y indices whose centers lie within the slab
+    int32_t minVoxelY = int32_t(ceil(minHeight * _invVoxelSide - 0.5f));
+    int32_t maxVoxelY = int32_t(floor(maxHeight * _invVoxelSide - 0.5f));
+
+    const VoxelBlockHash<Block> &blocks = _state->blocks;
+    for (size_t blockIdx = 0; blockIdx < blocks.size(); blockIdx++)
+    {
+        simd_int3 blockCoords = VoxelBlockHash<Block>::unpackKey(blocks.keyAt(blockIdx));
+        int32_t blockMinY = blockCoords.y * blockSide;
+        int32_t lo = std::max(minVoxelY - blockMinY, 0);
+        int32_t hi = std::min(maxVoxelY - blockMinY, blockSide - 1);
+        if (lo > hi)
+        {
+            continue;
+        }
+
+        // Test all 64 columns 8 at a time by replicating the slab's y bit mask into every byte
+        uint64_t sliceMask = (uint64_t(0xff) >> (7 - (hi - lo))) << lo;
+        uint64_t wordMask = sliceMask * everyByte;
+        const Block &block = blocks.blockAt(blockIdx);
+        for (int z = 0; z < blockSide; z++)
+        {
+            uint64_t row;
+            memcpy(&row, &block.columns[z * blockSide], sizeof(row));
+            row &= wordMask;
+            while (row)
+            {
+                int x = __builtin_ctzll(row) / 8;
+                row &= ~(uint64_t(0xff) << (8 * x));
+                simd_float3 columnCenter = simd_make_float3(
+                    (float(blockCoords.x * blockSide + x) + 0.5f) * _voxelSide,
+                    0,
+                    (float(blockCoords.z * blockSide + z) + 0.5f) * _voxelSide
+                );
+                occupied[projected.linearIndex(projected.positionToCell(columnCenter))] = 1.0f;
+            }
+        }
+    }
+
+    projected.updateOccupancyFromArray(occupied, projected.numCells());
+}
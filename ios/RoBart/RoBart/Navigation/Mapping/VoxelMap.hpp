@@ -0,0 +1,109 @@
+//
+//  VoxelMap.hpp
+//  RoBart
+//
+//  Created by Bart Trzynadlowski on 10/16/26.
+//
+//  This file is part of RoBart.
+//
+//  RoBart is free software: you can redistribute it and/or modify it under the
+//  terms of the GNU General Public License as published by the Free Software
+//  Foundation, either version 3 of the License, or (at your option) any later
+//  version.
+//
+//  RoBart is distributed in the hope that it will be useful, but WITHOUT
+//  ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+//  FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+//  more details.
+//
+//  You should have received a copy of the GNU General Public License along
+//  with RoBart. If not, see <http://www.gnu.org/licenses/>.
+//
+
+#ifndef VoxelMap_hpp
+#define VoxelMap_hpp
+
+#include "OccupancyMap.hpp"
+#include "VoxelBlockHash.hpp"
+#include <CoreVideo/CoreVideo.h>
+#include <simd/simd.h>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+/// Sparse 3D occupancy volume. Space is divided into 8x8x8-voxel blocks that are allocated only
+/// once a depth sample lands in them (see VoxelBlockHash). A 2D OccupancyMap for any height slab
+/// can be projected on demand, so that e.g. obstacles at base height and overhangs at phone height
+/// can be told apart.
+///
+/// Copies share the same volume.
+class VoxelMap
+{
+public:
+    /// - Parameter voxelSide: Side length of a voxel (m).
+    /// - Parameter minHits: Number of depth samples a voxel must receive to be considered occupied.
+    VoxelMap(float voxelSide, uint8_t minHits);
+
+    /// Removes all voxels. Pool memory is retained for reuse.
+    void clear();
+
+    /// Accumulates the points of a depth frame. Inputs are as for OccupancyMap::updateCellCounts().
+    void integrateDepth(
+        CVPixelBufferRef depthMap,
+        simd_float3x3 intrinsics,
+        simd_float2 rgbResolution,
+        simd_float4x4 viewMatrix,
+        float minDepth,
+        float maxDepth
+    );
+
+    bool isOccupied(simd_float3 position) const;
+
+    /// Overwrites `projected` so that a cell is occupied if it contains the center of an occupied
+    /// voxel whose center height lies within [ minHeight, maxHeight ]. The map is owned by the
+    /// caller and should be reused from frame to frame, so that projecting allocates nothing.
+    void project(OccupancyMap &projected, float minHeight, float maxHeight) const;
+
+    size_t numBlocks() const
+    {
+        return _state->blocks.size();
+    }
+
+    float voxelSide() const
+    {
+        return _voxelSide;
+    }
+
+private:
+    static constexpr int blockSide = 8;
+
+    struct Block
+    {
+        // Sample count of each voxel, indexed by (y * 8 + z) * 8 + x
+        uint8_t hits[blockSide * blockSide * blockSide];
+
+        // Occupied voxels of each column as a bit per y, indexed by z * 8 + x
+        uint8_t columns[blockSide * blockSide];
+
+        void reset();
+    };
+
+    void markVoxel(simd_int3 voxel);
+
+    float _voxelSide;
+    float _invVoxelSide;
+    uint8_t _minHits;
+
+    struct State
+    {
+        VoxelBlockHash<Block> blocks;
+
+        // Block touched by the previous sample, which is usually the same as the next
+        uint64_t lastKey = ~uint64_t(0);
+        Block *lastBlock = nullptr;
+    };
+
+    std::shared_ptr<State> _state;
+};
+
+#endif /* VoxelMap_hpp */
@@ -88,11 +88,23 @@ fileprivate func updatePath(to goal: Vector3, from startPosition: Vector3) async
     timer.start()
     let from = ARSessionManager.shared.transform.position;
     let to = goal
-    let robotRadius = 0.5 * max(Calibration.robotBounds.x, Calibration.robotBounds.z)
-    let pathCells = findPath(NavigationController.shared.occupancy, from, to, robotRadius)
+    let forward = -ARSessionManager.shared.transform.forward.xzProjected
 
-    // Convert path to positions
-    let pathPositions = pathCells.map { NavigationController.shared.occupancy.cellToPosition($0) }
+    // Prefer a path the hoverboard can actually drive smoothly. The lattice planner tests the
+    // rectangular footprint, which can be too strict in tight spaces, so fall back to the grid
+    // planner.
+    let pathPositions = NavigationController.shared.withPlanningOccupancy { occupancy in
+        let latticePlanner = LatticePlanner(occupancy, HoverboardController.shared.latticeMotionModel)
+        var pathCells = latticePlanner.findPath(from, forward, to).map { $0.cell }
+        if pathCells.isEmpty {
+            let robotRadius = 0.5 * max(Calibration.robotBounds.x, Calibration.robotBounds.z)
+            var observed = NavigationController.shared.observedSpace
+            pathCells = Array(findPathWithCost(occupancy, &observed, from, to, robotRadius, PathCostParameters()))
+        }
+
+        // Convert path to positions
+        return pathCells.map { occupancy.cellToPosition($0) }
+    }
     log("Path computed: \(timer.elapsedMilliseconds()) ms")
 
     // Debug: send to handheld phones for visualization
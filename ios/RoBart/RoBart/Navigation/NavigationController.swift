@@ -26,6 +26,7 @@ enum NavigationCommand {
     case navigate(to: Vector3)
     case scan360
     case follow(path: [Vector3])
+    case followHierarchicalPath(through: [Vector3])
 }
 
 class NavigationController {
@@ -36,24 +37,36 @@ class NavigationController {
     private var _nextCommand: NavigationCommand?
     private var _currentTask: Task<Void, Never>?
 
-    private lazy var _occupancyCalculator: GPUOccupancyMap = {
-        return GPUOccupancyMap(
-            width: 20,
-            depth: 20,
-            cellSide: Self.cellSide,
-            centerPoint: ARSessionManager.shared.transform.position
-        )
-    }()
+    /// Per-anchor contributions to `occupancy`, whose cells hold reference counts.
+    private var _meshOccupancyCache = MeshOccupancyCache()
 
     lazy var occupancy: OccupancyMap = {
-        return OccupancyMap(
-            _occupancyCalculator.width,
-            _occupancyCalculator.depth,
-            _occupancyCalculator.cellSide,
-            _occupancyCalculator.centerPoint
-        )
+        return OccupancyMap(20, 20, Self.cellSide, ARSessionManager.shared.transform.position)
+    }()
+
+    /// Which cells of `occupancy` the scene meshes have covered at all, floor included. Planners
+    /// that avoid unexplored space take it as their observed mask (see `findPathWithCost()`).
+    lazy var observedSpace: ElevationMap = {
+        let floorY = ARSessionManager.shared.floorY
+        return ElevationMap(occupancy, floorY - 0.25, floorY + 3)
+    }()
+
+    /// Hierarchical pathfinder over `occupancy`, kept up to date by `updateOccupancy()`. Answers
+    /// long-range queries on large maps much faster than `findPath()`.
+    lazy var hierarchicalPathfinder: HierarchicalPathfinder = {
+        let robotRadius = 0.5 * max(Calibration.robotBounds.x, Calibration.robotBounds.z)
+        return HierarchicalPathfinder(occupancy, robotRadius, 16)
     }()
 
+    /// People and other short-lived obstacles, kept separate from `occupancy` so that they never
+    /// pollute it. Cells expire a few seconds after they were last stamped. Humans are detected and
+    /// paths planned from different tasks, so the layer is only accessed with `_dynamicObstaclesLock`
+    /// held.
+    private lazy var _dynamicObstacles: DynamicObstacleMap = {
+        return DynamicObstacleMap(occupancy, 3)
+    }()
+    private let _dynamicObstaclesLock = NSLock()
+
     fileprivate init() {
     }
 
@@ -79,6 +92,9 @@ class NavigationController {
                     case .follow(path: let path):
                         log("Following path")
                         try await followPath(path)
+                    case .followHierarchicalPath(through: let waypoints):
+                        log("Following hierarchical path")
+                        try await followHierarchicalPath(through: waypoints)
                     }
                 } catch {
                     log("Command interrupted: \(error.localizedDescription)")
@@ -105,46 +121,53 @@ class NavigationController {
         var timer = Util.Stopwatch()
         timer.start()
 
-        // Unbundle all meshes into a linear array of vertices and associate a transform with each
-        var vertices: [Vector3] = []
-        var transforms: [Matrix4x4] = []
-        var transformIdxs: [UInt32] = []
+        // Update occupancy by rasterizing the triangles of scene meshes that changed since the last
+        // update on the CPU, reading each mesh's geometry in place
+        let minHeight = ARSessionManager.shared.floorY + 0.25
+        let maxHeight = ARSessionManager.shared.floorY + Calibration.phoneHeightAboveFloor
         let meshes = ARSessionManager.shared.sceneMeshes
-        var transformIdx: UInt32 = 0
-        for mesh in meshes {
-            transforms.append(mesh.transform)
-            for vertex in mesh.vertices {
-                vertices.append(vertex)
-                transformIdxs.append(transformIdx)
+        let ids = meshes.map { MeshAnchorID($0.identifier) }
+        var observed = observedSpace    // shares memory
+        let numChanged = meshes.withVertexSpans { spans in
+            ids.withUnsafeBufferPointer { idsPtr in
+                _meshOccupancyCache.update(&occupancy, spans, idsPtr.baseAddress, spans.count, minHeight, maxHeight, &observed)
             }
-            transformIdx += 1
         }
+        _ = hierarchicalPathfinder.update()
+        log("Occupancy updated (\(numChanged)/\(meshes.count) meshes changed): \(timer.elapsedMilliseconds()) ms")
 
-        // Calculate occupancy on GPU
-        let minHeight = ARSessionManager.shared.floorY + 0.25
-        let maxHeight = ARSessionManager.shared.floorY + Calibration.phoneHeightAboveFloor
-        _occupancyCalculator.reset(to: 0)
-        guard let _ = await _occupancyCalculator.update(
-            vertices: vertices,
-            transforms: transforms,
-            transformIndices: transformIdxs,
-            minOccupiedHeight: minHeight,
-            maxOccupiedHeight: maxHeight
-        ) else {
-            // Operation failed
-            return false
-        }
+        return true
+    }
 
-        // Update occupancy map from GPU result
-        guard let occupancyArray = _occupancyCalculator.getMapArray() else {
-            return false
-        }
-        occupancyArray.withUnsafeBufferPointer { ptr in
-            occupancy.updateOccupancyFromArray(ptr.baseAddress, occupancyArray.count)
+    /// Stamps the footprints of tracked humans into the dynamic obstacle layer so that planners
+    /// avoid them.
+    func stampHumans(_ footprints: HumanFootprints) {
+        footprints.boxes.withUnsafeBufferPointer { boxesPtr in
+            footprints.depths.withUnsafeBufferPointer { depthsPtr in
+                _dynamicObstaclesLock.lock()
+                _dynamicObstacles.stampHumans(
+                    boxesPtr.baseAddress,
+                    depthsPtr.baseAddress,
+                    footprints.boxes.count,
+                    footprints.depthResolution,
+                    footprints.intrinsics,
+                    footprints.rgbResolution,
+                    footprints.viewMatrix,
+                    0.25,
+                    footprints.timestamp
+                )
+                _dynamicObstaclesLock.unlock()
+            }
         }
-        log("Occupancy updated: \(timer.elapsedMilliseconds()) ms")
+    }
 
-        return true
+    /// Runs `body` with the occupancy map with currently active dynamic obstacles marked as
+    /// occupied, for path planning. The map is `occupancy` itself when there are none and is
+    /// otherwise reused by the next call, so it must not be modified or kept past `body`.
+    func withPlanningOccupancy<T>(_ body: (OccupancyMap) -> T) -> T {
+        _dynamicObstaclesLock.lock()
+        defer { _dynamicObstaclesLock.unlock() }
+        return body(_dynamicObstacles.overlay(occupancy, ProcessInfo.processInfo.systemUptime))
     }
 
     func getOccupancyArray() -> [Float] {
@@ -0,0 +1,71 @@
+//
+//  BucketQueue.hpp
+//  RoBart
+//
+//  Created by Bart Trzynadlowski on 10/16/26.
+//
+//  This file is part of RoBart.
+//
+//  RoBart is free software: you can redistribute it and/or modify it under the
+//  terms of the GNU General Public License as published by the Free Software
+//  Foundation, either version 3 of the License, or (at your option) any later
+//  version.
+//
+//  RoBart is distributed in the hope that it will be useful, but WITHOUT
+//  ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+//  FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+//  more details.
+//
+//  You should have received a copy of the GNU General Public License along
+//  with RoBart. If not, see <http://www.gnu.org/licenses/>.
+//
+
+#ifndef BucketQueue_hpp
+#define BucketQueue_hpp
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+/// Monotone priority queue for integral keys (Dial's algorithm). Each bucket holds the values for a
+/// single key. Keys must never be smaller than the most recently popped key and may not exceed it by
+/// more than `maxKeySpread`, which holds for A* with a consistent heuristic and bounded step costs.
+class BucketQueue
+{
+public:
+    BucketQueue(uint32_t maxKeySpread)
+        : _buckets(maxKeySpread + 1)
+    {
+    }
+
+    bool empty() const
+    {
+        return _size == 0;
+    }
+
+    void push(uint32_t key, uint32_t value)
+    {
+        _buckets[key % _buckets.size()].emplace_back(value);
+        _size += 1;
+    }
+
+    uint32_t pop()
+    {
+        while (_buckets[_currentKey % _buckets.size()].empty())
+        {
+            _currentKey += 1;
+        }
+        std::vector<uint32_t> &bucket = _buckets[_currentKey % _buckets.size()];
+        uint32_t value = bucket.back();
+        bucket.pop_back();
+        _size -= 1;
+        return value;
+    }
+
+private:
+    std::vector<std::vector<uint32_t>> _buckets;
+    uint32_t _currentKey = 0;
+    size_t _size = 0;
+};
+
+#endif /* BucketQueue_hpp */
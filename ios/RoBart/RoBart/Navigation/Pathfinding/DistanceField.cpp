@@ -0,0 +1,155 @@
+//
+//  DistanceField.cpp
+//  RoBart
+//
+//  Created by Bart Trzynadlowski on 10/16/26.
+//
+//  This file is part of RoBart.
+//
+//  RoBart is free software: you can redistribute it and/or modify it under the
+//  terms of the GNU General Public License as published by the Free Software
+//  Foundation, either version 3 of the License, or (at your option) any later
+//  version.
+//
+//  RoBart is distributed in the hope that it will be useful, but WITHOUT
+//  ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+//  FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+//  more details.
+//
+//  You should have received a copy of the GNU General Public License along
+//  with RoBart. If not, see <http://www.gnu.org/licenses/>.
+//
+
+#include "DistanceField.hpp"
+#include "PathUtils.hpp"
+#include <algorithm>
+
+static const long neighborOffsets[4][2] = { { -1, 0 }, { 1, 0 }, { 0, -1 }, { 0, 1 } };
+
+DistanceField::DistanceField(const OccupancyMap &occupancy, simd_float3 from, float robotRadius)
+    : _occupancy(occupancy),
+      _cellsWide(occupancy.cellsWide()),
+      _cellsDeep(occupancy.cellsDeep()),
+      _src(occupancy.positionToCell(from)),
+      _steps(occupancy.numCells(), unreachable)
+{
+    size_t robotFootprintSideLength = computeFootprintSideLengthInCells(occupancy, robotRadius);
+
+    // Flood outwards over safe cells. The starting cell is exempt because the robot is already there.
+    std::vector<uint32_t> frontier;
+    frontier.reserve(occupancy.numCells());
+    _steps[index(_src.cellX, _src.cellZ)] = 0;
+    frontier.emplace_back(uint32_t(index(_src.cellX, _src.cellZ)));
+    for (size_t head = 0; head < frontier.size(); head++)
+    {
+        size_t idx = frontier[head];
+        long x = long(idx % _cellsWide);
+        long z = long(idx / _cellsWide);
+        for (auto &offset: neighborOffsets)
+        {
+            long neighborX = x + offset[0];
+            long neighborZ = z + offset[1];
+            if (neighborX < 0 || neighborZ < 0 || neighborX >= long(_cellsWide) || neighborZ >= long(_cellsDeep))
+            {
+                continue;
+            }
+
+            size_t neighborIdx = index(neighborX, neighborZ);
+            if (_steps[neighborIdx] != unreachable || !isCellSafe(occupancy, OccupancyMap::CellIndices(neighborX, neighborZ), robotFootprintSideLength))
+            {
+                continue;
+            }
+
+            _steps[neighborIdx] = _steps[idx] + 1;
+            frontier.emplace_back(uint32_t(neighborIdx));
+        }
+    }
+}
+
+bool DistanceField::isReachable(simd_float3 position) const
+{
+    OccupancyMap::CellIndices lastFloodedCell;
+    return stepsTo(_occupancy.positionToCell(position), &lastFloodedCell) != unreachable;
+}
+
+float DistanceField::distanceTo(simd_float3 position) const
+{
+    OccupancyMap::CellIndices lastFloodedCell;
+    uint32_t steps = stepsTo(_occupancy.positionToCell(position), &lastFloodedCell);
+    return steps == unreachable ? -1 : float(steps) * _occupancy.cellSide();
+}
+
+std::vector<OccupancyMap::CellIndices> DistanceField::pathTo(simd_float3 position) const
+{
+    OccupancyMap::CellIndices dest = _occupancy.positionToCell(position);
+    OccupancyMap::CellIndices lastFloodedCell;
+    if (stepsTo(dest, &lastFloodedCell) == unreachable)
+    {
+        return {};
+    }
+
+    // Walk downhill from the target back to the source
+    std::vector<OccupancyMap::CellIndices> cells;
+    if (lastFloodedCell != dest)
+    {
+        cells.emplace_back(dest);
+    }
+    OccupancyMap::CellIndices cell = lastFloodedCell;
+    cells.emplace_back(cell);
+    while (cell != _src)
+    {
+        uint32_t steps = _steps[index(cell.cellX, cell.cellZ)];
+        for (auto &offset: neighborOffsets)
+        {
+            long neighborX = long(cell.cellX) + offset[0];
+            long neighborZ = long(cell.cellZ) + offset[1];
+            if (neighborX >= 0 && neighborZ >= 0 && neighborX < long(_cellsWide) && neighborZ < long(_cellsDeep) && _steps[index(neighborX, neighborZ)] == steps - 1)
+            {
+                cell = OccupancyMap::CellIndices(neighborX, neighborZ);
+                break;
+            }
+        }
+        cells.emplace_back(cell);
+    }
+    std::reverse(cells.begin(), cells.end());
+    return removeCollinearCells(cells);
+}
+
+/// Number of steps to a target cell. Targets need not be safe themselves (only unoccupied), so an
+/// unflooded target is reachable if it is adjacent to a flooded cell.
+/// - Parameter cell: The target cell.
+/// - Parameter lastFloodedCell: Set to the target cell if it was flooded, otherwise to the flooded
+/// neighbor it is entered from.
+/// - Returns: The number of steps, or `unreachable`.
+uint32_t DistanceField::stepsTo(OccupancyMap::CellIndices cell, OccupancyMap::CellIndices *lastFloodedCell) const
+{
+    *lastFloodedCell = cell;
+    uint32_t steps = _steps[index(cell.cellX, cell.cellZ)];
+    if (steps != unreachable)
+    {
+        return steps;
+    }
+
+    if (_occupancy.at(cell) != 0)
+    {
+        return unreachable;
+    }
+
+    for (auto &offset: neighborOffsets)
+    {
+        long neighborX = long(cell.cellX) + offset[0];
+        long neighborZ = long(cell.cellZ) + offset[1];
+        if (neighborX < 0 || neighborZ < 0 || neighborX >= long(_cellsWide) || neighborZ >= long(_cellsDeep))
+        {
+            continue;
+        }
+
+        uint32_t neighborSteps = _steps[index(neighborX, neighborZ)];
+        if (neighborSteps != unreachable && (steps == unreachable || neighborSteps + 1 < steps))
+        {
+            steps = neighborSteps + 1;
+            *lastFloodedCell = OccupancyMap::CellIndices(neighborX, neighborZ);
+        }
+    }
+    return steps;
+}
@@ -0,0 +1,65 @@
+//
+//  DistanceField.hpp
+//  RoBart
+//
+//  Created by Bart Trzynadlowski on 10/16/26.
+//
+//  This file is part of RoBart.
+//
+//  RoBart is free software: you can redistribute it and/or modify it under the
+//  terms of the GNU General Public License as published by the Free Software
+//  Foundation, either version 3 of the License, or (at your option) any later
+//  version.
+//
+//  RoBart is distributed in the hope that it will be useful, but WITHOUT
+//  ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+//  FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+//  more details.
+//
+//  You should have received a copy of the GNU General Public License along
+//  with RoBart. If not, see <http://www.gnu.org/licenses/>.
+//
+
+#ifndef DistanceField_hpp
+#define DistanceField_hpp
+
+#include "OccupancyMap.hpp"
+#include <simd/simd.h>
+#include <cstdint>
+#include <vector>
+
+/// Distances from a single starting point to every reachable cell of an occupancy map, computed by
+/// one breadth-first flood. Reachability, distance, and paths to any number of targets can then be
+/// queried without further searching. Moves follow the same rules as findPath(): 4-connected, with
+/// a square robot footprint, and a target need only be unoccupied.
+class DistanceField
+{
+public:
+    DistanceField(const OccupancyMap &occupancy, simd_float3 from, float robotRadius);
+
+    bool isReachable(simd_float3 position) const;
+
+    /// - Returns: Path length in meters (a multiple of the cell side) or -1 if unreachable.
+    float distanceTo(simd_float3 position) const;
+
+    /// - Returns: The same kind of path as findPath(), or an empty vector if unreachable.
+    std::vector<OccupancyMap::CellIndices> pathTo(simd_float3 position) const;
+
+private:
+    static constexpr uint32_t unreachable = UINT32_MAX;
+
+    uint32_t stepsTo(OccupancyMap::CellIndices cell, OccupancyMap::CellIndices *lastFloodedCell) const;
+
+    inline size_t index(size_t cellX, size_t cellZ) const
+    {
+        return cellZ * _cellsWide + cellX;
+    }
+
+    OccupancyMap _occupancy;
+    size_t _cellsWide;
+    size_t _cellsDeep;
+    OccupancyMap::CellIndices _src;
+    std::vector<uint32_t> _steps;
+};
+
+#endif /* DistanceField_hpp */
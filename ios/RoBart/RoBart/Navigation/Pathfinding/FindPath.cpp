@@ -21,58 +21,19 @@
 //
 
 #include "FindPath.hpp"
+#include "BucketQueue.hpp"
+#include "PathUtils.hpp"
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <cstdlib>
 #include <iostream>
+#include <limits>
+#include <mutex>
 #include <queue>
+#include <thread>
 #include <unordered_map>
 
-/// Given a characteristic radius, determines the side length in cells of the rectangular area to assume as the footprint of the robot.
-/// For example, if the cell side length is 0.5 and the radius of the robot's footprint is 0.6, the result should be 3 (a 3x3 area needs
-/// to be checked because the robot will be overlapping up to that many cells).
-/// - Parameter occupancy: The occupancy map.
-/// - Parameter robotRadius: A characteristic robot radius that encompasses the robot's total footprint.
-/// - Returns: The side length of the rectangular region, in cells, to represent the robot with. This will be an odd number of at
-/// least 1.
-static size_t computeFootprintSideLengthInCells(const OccupancyMap &occupancy, float robotRadius)
-{
-    if (occupancy.cellsWide() * occupancy.cellsDeep() <= 1)
-    {
-        // Pathological case of a single-celled map
-        return 1;
-    }
-
-    OccupancyMap::CellIndices center = occupancy.positionToCell(occupancy.centerPoint());
-    OccupancyMap::CellIndices limit = occupancy.positionToCell(occupancy.centerPoint() + simd_make_float3(robotRadius, 0, 0));
-    size_t cellsOut = limit.cellX - center.cellX;
-
-    // Side length is 1 (center cell) plus the number of cells out in either direction
-    return 1 + 2 * cellsOut;
-}
-
-/// Check whether we can move into a cell by overlaying a square approximation of the robot's footprint to ensure there are no collisions with nearby cells.
-/// - Parameter occupancy: The occupancy map.
-/// - Parameter cell: The cell we want to move in; the center of the region that will be checked.
-/// - Parameter robotFootprintSideLength: Side length in cell units of the square region with center at `cell` to check. Must be odd.
-/// - Returns: True if safe, otherwise false.
-static bool isCellSafe(const OccupancyMap &occupancy, OccupancyMap::CellIndices cell, size_t robotFootprintSideLength)
-{
-    long delta = long(robotFootprintSideLength) / 2;    // note that length will be odd, so we can do this to create a [-delta,+delta] range
-    long cellXMin = std::max(long(0), long(cell.cellX) - delta);
-    long cellXMax = std::min(cell.cellX + delta, occupancy.cellsWide() - 1);
-    long cellZMin = std::max(long(0), long(cell.cellZ) - delta);
-    long cellZMax = std::min(cell.cellZ + delta, occupancy.cellsDeep() - 1);
-    for (size_t cellZ = cellZMin; cellZ <= cellZMax; cellZ++)
-    {
-        for (size_t cellX = cellXMin; cellX <= cellXMax; cellX++)
-        {
-            if (occupancy.at(cellX, cellZ) != 0)
-            {
-                return false;
-            }
-        }
-    }
-    return true;
-}
-
 static void getUnoccupiedNeighbors(std::vector<OccupancyMap::CellIndices> *neighbors, const OccupancyMap &occupancy, OccupancyMap::CellIndices cell, size_t robotFootprintSideLength)
 {
     size_t x = cell.cellX;
@@ -221,3 +182,352 @@ foundCompletePath:
     return path;
 }
 
+
+/// Breadth-first search over flat arrays shared by findPathBidirectional() and
+/// findPathUnidirectional(). Each side labels cells with their depth (distance from its start) and
+/// the cell they were reached from, in arrays of its own, so the sides never contend for a cell.
+/// Labeling a cell the other side has already labeled yields a path through it whose length is the
+/// sum of the two depths, and the shortest such path is kept. A shorter path would pass through a
+/// cell within the depths both sides have finished labeling, so once those depths add up to at least
+/// the best length, the path is known to be shortest and the search stops. With `bidirectional` set,
+/// a second thread searches forward from the source; otherwise only the backward search from the
+/// destination runs, and it ends once it has labeled the source. The source cell, like the
+/// destination, is exempt from the footprint test.
+static std::vector<OccupancyMap::CellIndices> findPathOverFlatArrays(const OccupancyMap &occupancy, simd_float3 from, simd_float3 to, float robotRadius, bool bidirectional)
+{
+    std::vector<OccupancyMap::CellIndices> path;
+
+    size_t robotFootprintSideLength = computeFootprintSideLengthInCells(occupancy, robotRadius);
+
+    OccupancyMap::CellIndices dest = occupancy.positionToCell(to);
+    OccupancyMap::CellIndices src = occupancy.positionToCell(from);
+
+    if (occupancy.at(dest) != 0)
+    {
+        // Destination is occupied, no path
+        return path;
+    }
+
+    if (dest == src)
+    {
+        path.emplace_back(src);
+        return path;
+    }
+
+    // Each side stores, per cell, the index of the cell it was reached from plus one (zero meaning
+    // unlabeled) and the depth, which is written first so that it is valid once the parent is seen
+    constexpr uint32_t unbounded = std::numeric_limits<uint32_t>::max();
+    size_t cellsWide = occupancy.cellsWide();
+    size_t cellsDeep = occupancy.cellsDeep();
+    struct Side
+    {
+        std::vector<uint32_t> depth;
+        std::vector<std::atomic<uint32_t>> parent;
+
+        // Every cell up to this depth has been labeled, or unbounded once the side is exhausted
+        std::atomic<uint32_t> labeledDepth;
+
+        Side(size_t numCells)
+            : depth(numCells, 0),
+              parent(numCells),
+              labeledDepth(0)
+        {
+            for (auto &cell: parent)
+            {
+                cell.store(0, std::memory_order_relaxed);
+            }
+        }
+    };
+    Side forward(cellsWide * cellsDeep);
+    Side backward(cellsWide * cellsDeep);
+
+    size_t srcIdx = src.cellZ * cellsWide + src.cellX;
+    size_t destIdx = dest.cellZ * cellsWide + dest.cellX;
+    forward.parent[srcIdx].store(uint32_t(srcIdx + 1), std::memory_order_relaxed);
+    backward.parent[destIdx].store(uint32_t(destIdx + 1), std::memory_order_relaxed);
+
+    // Shortest path found so far passes through meetIdx
+    std::mutex meetMutex;
+    std::atomic<uint32_t> bestLength(unbounded);
+    size_t meetIdx = 0;
+    std::atomic<bool> done(false);
+
+    auto saturatingAdd = [](uint32_t a, uint32_t b) -> uint32_t { return a >= unbounded - b ? unbounded : a + b; };
+
+    auto search = [&](Side &own, const Side &other, size_t startIdx, size_t otherStartIdx)
+    {
+        std::vector<size_t> frontier;
+        std::vector<size_t> nextFrontier;
+        frontier.emplace_back(startIdx);
+        for (uint32_t depth = 1; !done.load(); depth++)
+        {
+            // Both depths are read before the best length, which was updated before they were
+            // published
+            uint32_t labeledDepths = saturatingAdd(own.labeledDepth.load(), other.labeledDepth.load());
+            if (labeledDepths >= bestLength.load())
+            {
+                done = true;
+                return;
+            }
+            if (frontier.empty())
+            {
+                // Every reachable cell is labeled. If the other side's start was among them, the path
+                // has been found; otherwise there is none. Either way the test above now passes.
+                own.labeledDepth = unbounded;
+                continue;
+            }
+
+            nextFrontier.clear();
+            for (size_t idx: frontier)
+            {
+                long x = long(idx % cellsWide);
+                long z = long(idx / cellsWide);
+                const long neighborOffsets[4][2] = { { -1, 0 }, { 1, 0 }, { 0, -1 }, { 0, 1 } };
+                for (auto &offset: neighborOffsets)
+                {
+                    long neighborX = x + offset[0];
+                    long neighborZ = z + offset[1];
+                    if (neighborX < 0 || neighborZ < 0 || neighborX >= long(cellsWide) || neighborZ >= long(cellsDeep))
+                    {
+                        continue;
+                    }
+
+                    size_t neighborIdx = size_t(neighborZ) * cellsWide + size_t(neighborX);
+                    if (own.parent[neighborIdx].load(std::memory_order_relaxed) != 0)
+                    {
+                        continue;
+                    }
+
+                    if (neighborIdx != otherStartIdx && !isCellSafe(occupancy, OccupancyMap::CellIndices(neighborX, neighborZ), robotFootprintSideLength))
+                    {
+                        continue;
+                    }
+
+                    // Label the cell, then look for the other side's label. Both are sequentially
+                    // consistent, so of two sides labeling the same cell at least one sees the other.
+                    own.depth[neighborIdx] = depth;
+                    own.parent[neighborIdx].store(uint32_t(idx + 1));
+                    if (other.parent[neighborIdx].load() != 0)
+                    {
+                        uint32_t length = depth + other.depth[neighborIdx];
+                        std::lock_guard<std::mutex> lock(meetMutex);
+                        if (length < bestLength.load(std::memory_order_relaxed))
+                        {
+                            bestLength = length;
+                            meetIdx = neighborIdx;
+                        }
+                    }
+
+                    // The other side's start is a valid end for a path but is not searched beyond
+                    if (neighborIdx != otherStartIdx)
+                    {
+                        nextFrontier.emplace_back(neighborIdx);
+                    }
+                }
+            }
+            std::swap(frontier, nextFrontier);
+            own.labeledDepth = depth;
+        }
+    };
+
+    if (bidirectional)
+    {
+        std::thread backwardThread(search, std::ref(backward), std::cref(forward), destIdx, srcIdx);
+        search(forward, backward, srcIdx, destIdx);
+        backwardThread.join();
+    }
+    else
+    {
+        search(backward, forward, destIdx, srcIdx);
+    }
+
+    if (bestLength == unbounded)
+    {
+        // No path found. Return empty vector.
+        return path;
+    }
+
+    // Forward half is traced back to src and reversed, backward half leads to dest directly
+    auto parentOf = [](const Side &side, size_t idx) -> size_t { return size_t(side.parent[idx].load(std::memory_order_relaxed)) - 1; };
+    std::vector<OccupancyMap::CellIndices> cells;
+    for (size_t idx = meetIdx; ; idx = parentOf(forward, idx))
+    {
+        cells.emplace_back(idx % cellsWide, idx / cellsWide);
+        if (idx == srcIdx)
+        {
+            break;
+        }
+    }
+    std::reverse(cells.begin(), cells.end());
+    for (size_t idx = meetIdx; idx != destIdx; )
+    {
+        idx = parentOf(backward, idx);
+        cells.emplace_back(idx % cellsWide, idx / cellsWide);
+    }
+    return removeCollinearCells(cells);
+}
+
+/// Finds a shortest path, like findPath(), by searching from both ends at once on two threads.
+std::vector<OccupancyMap::CellIndices> findPathBidirectional(const OccupancyMap &occupancy, simd_float3 from, simd_float3 to, float robotRadius)
+{
+    return findPathOverFlatArrays(occupancy, from, to, robotRadius, true);
+}
+
+/// Single-threaded equivalent of findPathBidirectional() that searches only from the destination,
+/// using the same flat arrays. Mainly serves as the baseline when measuring the benefit of searching
+/// from both ends.
+std::vector<OccupancyMap::CellIndices> findPathUnidirectional(const OccupancyMap &occupancy, simd_float3 from, simd_float3 to, float robotRadius)
+{
+    return findPathOverFlatArrays(occupancy, from, to, robotRadius, false);
+}
+
+/// Finds the cheapest path under `params`, which penalizes passing close to obstacles and through
+/// unknown cells: those that `observed`, which must share the geometry of `occupancy`, has never
+/// seen. If `observed` is null, every cell is treated as observed.
+std::vector<OccupancyMap::CellIndices> findPathWithCost(const OccupancyMap &occupancy, const ElevationMap *observed, simd_float3 from, simd_float3 to, float robotRadius, const PathCostParameters &params)
+{
+    std::vector<OccupancyMap::CellIndices> path;
+
+    OccupancyMap::CellIndices dest = occupancy.positionToCell(to);
+    OccupancyMap::CellIndices src = occupancy.positionToCell(from);
+
+    auto isUnknown = [&](OccupancyMap::CellIndices cell)
+    {
+        return observed != nullptr && !observed->isObserved(cell);
+    };
+
+    bool destIsObstacle = isUnknown(dest) ? !params.unknownIsTraversable : occupancy.at(dest) != 0;
+    if (destIsObstacle)
+    {
+        // Destination is occupied, no path
+        return path;
+    }
+
+    if (dest == src)
+    {
+        path.emplace_back(src);
+        return path;
+    }
+
+    // A cell is safe when its distance to the nearest obstacle exceeds footprintDelta. Closer than
+    // footprintDelta + clearanceCells, it is penalized.
+    uint32_t stepCost = std::max(uint32_t(1), params.stepCost);
+    uint16_t footprintDelta = uint16_t(computeFootprintSideLengthInCells(occupancy, robotRadius) / 2);
+    uint16_t clearanceCells = uint16_t(std::max(0.0f, std::ceil(params.clearanceDistance / occupancy.cellSide())));
+    std::vector<uint16_t> obstacleDistances;
+    computeObstacleDistances(&obstacleDistances, occupancy, params.unknownIsTraversable ? nullptr : observed, footprintDelta + clearanceCells + 1);
+
+    // Cost of entering each cell, or infinity if the robot cannot enter it. The robot is already at
+    // the source so we never test it; the destination need only be unoccupied, as with findPath().
+    constexpr uint32_t impassable = std::numeric_limits<uint32_t>::max();
+    size_t cellsWide = occupancy.cellsWide();
+    size_t cellsDeep = occupancy.cellsDeep();
+    size_t destIdx = dest.cellZ * cellsWide + dest.cellX;
+    auto costToEnter = [&](size_t cellX, size_t cellZ) -> uint32_t
+    {
+        size_t idx = cellZ * cellsWide + cellX;
+        uint16_t distance = obstacleDistances[idx];
+        if (distance <= footprintDelta && idx != destIdx)
+        {
+            return impassable;
+        }
+
+        uint32_t cost = stepCost;
+        uint16_t clearance = distance - footprintDelta;
+        if (clearance <= clearanceCells && idx != destIdx)
+        {
+            cost += params.clearanceCost * (clearanceCells - clearance + 1) / clearanceCells;
+        }
+        if (isUnknown(OccupancyMap::CellIndices(cellX, cellZ)))
+        {
+            cost += params.unknownCost;
+        }
+        return cost;
+    };
+
+    auto heuristic = [&](size_t cellX, size_t cellZ) -> uint32_t
+    {
+        uint32_t manhattanDistance = uint32_t(std::labs(long(cellX) - long(dest.cellX)) + std::labs(long(cellZ) - long(dest.cellZ)));
+        return stepCost * manhattanDistance;
+    };
+
+    // A* from source to destination. Each step changes the heuristic by at most one step cost, so
+    // the f-value of anything pushed is within maxStepCost + stepCost of the current minimum.
+    uint32_t maxStepCost = stepCost + params.clearanceCost + params.unknownCost;
+    BucketQueue frontier(maxStepCost + stepCost);
+    std::vector<uint32_t> costSoFar(cellsWide * cellsDeep, impassable);
+    std::vector<uint32_t> cameFrom(cellsWide * cellsDeep, impassable);
+    std::vector<bool> closed(cellsWide * cellsDeep, false);
+
+    size_t srcIdx = src.cellZ * cellsWide + src.cellX;
+    costSoFar[srcIdx] = 0;
+    cameFrom[srcIdx] = uint32_t(srcIdx);
+    frontier.push(heuristic(src.cellX, src.cellZ), uint32_t(srcIdx));
+
+    bool foundPath = false;
+    while (!frontier.empty())
+    {
+        size_t idx = frontier.pop();
+        if (closed[idx])
+        {
+            // Stale entry for a cell we already reached more cheaply
+            continue;
+        }
+        closed[idx] = true;
+
+        if (idx == destIdx)
+        {
+            foundPath = true;
+            break;
+        }
+
+        size_t x = idx % cellsWide;
+        size_t z = idx / cellsWide;
+        const long neighborOffsets[4][2] = { { -1, 0 }, { 1, 0 }, { 0, -1 }, { 0, 1 } };
+        for (auto &offset: neighborOffsets)
+        {
+            long neighborX = long(x) + offset[0];
+            long neighborZ = long(z) + offset[1];
+            if (neighborX < 0 || neighborZ < 0 || neighborX >= long(cellsWide) || neighborZ >= long(cellsDeep))
+            {
+                continue;
+            }
+
+            size_t neighborIdx = size_t(neighborZ) * cellsWide + size_t(neighborX);
+            if (closed[neighborIdx])
+            {
+                continue;
+            }
+
+            uint32_t cost = costToEnter(neighborX, neighborZ);
+            if (cost == impassable)
+            {
+                continue;
+            }
+
+            uint32_t newCost = costSoFar[idx] + cost;
+            if (newCost < costSoFar[neighborIdx])
+            {
+                costSoFar[neighborIdx] = newCost;
+                cameFrom[neighborIdx] = uint32_t(idx);
+                frontier.push(newCost + heuristic(neighborX, neighborZ), uint32_t(neighborIdx));
+            }
+        }
+    }
+
+    if (!foundPath)
+    {
+        // No path found. Return empty vector.
+        return path;
+    }
+
+    // Trace back from dest to src and then reduce to waypoints where the direction changes
+    std::vector<OccupancyMap::CellIndices> cells;
+    for (size_t idx = destIdx; idx != srcIdx; idx = cameFrom[idx])
+    {
+        cells.emplace_back(idx % cellsWide, idx / cellsWide);
+    }
+    cells.emplace_back(src);
+    std::reverse(cells.begin(), cells.end());
+    return removeCollinearCells(cells);
+}
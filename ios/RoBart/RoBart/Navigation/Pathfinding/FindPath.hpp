@@ -23,10 +23,38 @@
 #ifndef FindPath_hpp
 #define FindPath_hpp
 
+#include "ElevationMap.hpp"
 #include "OccupancyMap.hpp"
 #include <simd/simd.h>
+#include <cstdint>
 #include <vector>
 
+/// Cost function used by findPathWithCost(). All costs are integral so that the search can use a
+/// bucketed priority queue. The cost of a step is the sum of `stepCost` and any penalties incurred
+/// by the cell being entered.
+struct PathCostParameters
+{
+    /// Base cost of moving into an adjacent cell.
+    uint32_t stepCost = 10;
+
+    /// Distance (in meters) beyond the edge of the robot footprint within which cells are penalized
+    /// for being close to an obstacle.
+    float clearanceDistance = 0.5f;
+
+    /// Penalty for a cell directly adjacent to an obstacle (i.e., the robot footprint just fits).
+    /// Falls off linearly to zero at `clearanceDistance`.
+    uint32_t clearanceCost = 40;
+
+    /// Penalty for entering a cell that has never been observed (see ElevationMap::isObserved()).
+    uint32_t unknownCost = 30;
+
+    /// If false, unknown cells are treated as obstacles.
+    bool unknownIsTraversable = true;
+};
+
 extern std::vector<OccupancyMap::CellIndices> findPath(const OccupancyMap &occupancy, simd_float3 from, simd_float3 to, float robotRadius);
+extern std::vector<OccupancyMap::CellIndices> findPathBidirectional(const OccupancyMap &occupancy, simd_float3 from, simd_float3 to, float robotRadius);
+extern std::vector<OccupancyMap::CellIndices> findPathUnidirectional(const OccupancyMap &occupancy, simd_float3 from, simd_float3 to, float robotRadius);
+extern std::vector<OccupancyMap::CellIndices> findPathWithCost(const OccupancyMap &occupancy, const ElevationMap *observed, simd_float3 from, simd_float3 to, float robotRadius, const PathCostParameters &params);
 
 #endif /* FindPath_hpp */
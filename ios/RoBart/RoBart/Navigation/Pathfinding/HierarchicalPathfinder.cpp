@@ -0,0 +1,631 @@
+//
+//  HierarchicalPathfinder.cpp
+//  RoBart
+//
+//  Created by Bart Trzynadlowski on 10/16/26.
+//
+//  This file is part of RoBart.
+//
+//  RoBart is free software: you can redistribute it and/or modify it under the
+//  terms of the GNU General Public License as published by the Free Software
+//  Foundation, either version 3 of the License, or (at your option) any later
+//  version.
+//
+//  RoBart is distributed in the hope that it will be useful, but WITHOUT
+//  ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+//  FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+//  more details.
+//
+//  You should have received a copy of the GNU General Public License along
+//  with RoBart. If not, see <http://www.gnu.org/licenses/>.
+//
+
+#include "HierarchicalPathfinder.hpp"
+#include "PathUtils.hpp"
+#include <algorithm>
+#include <cstdlib>
+#include <queue>
+
+HierarchicalPathfinder::HierarchicalPathfinder(const OccupancyMap &occupancy, float robotRadius, size_t clusterSize)
+    : _occupancy(occupancy)
+{
+    _footprintSideLength = computeFootprintSideLengthInCells(occupancy, robotRadius);
+    _clusterSize = std::max(clusterSize, size_t(2));
+    _clustersWide = (occupancy.cellsWide() + _clusterSize - 1) / _clusterSize;
+    _clustersDeep = (occupancy.cellsDeep() + _clusterSize - 1) / _clusterSize;
+    _safe.assign(occupancy.numCells(), 0);
+    _verticalBorders.resize(_clustersWide * _clustersDeep);
+    _horizontalBorders.resize(_clustersWide * _clustersDeep);
+    _clusterEdges.resize(_clustersWide * _clustersDeep);
+    update();
+}
+
+size_t HierarchicalPathfinder::update()
+{
+    size_t cellsWide = _occupancy.cellsWide();
+    size_t cellsDeep = _occupancy.cellsDeep();
+    size_t numClusters = _clustersWide * _clustersDeep;
+
+    // Find clusters whose occupancy changed since the last update
+    bool firstUpdate = _snapshot.empty();
+    if (firstUpdate)
+    {
+        _snapshot.assign(cellsWide * cellsDeep, 0);
+    }
+    std::vector<bool> changed(numClusters, firstUpdate);
+    for (size_t cellZ = 0; cellZ < cellsDeep; cellZ++)
+    {
+        for (size_t cellX = 0; cellX < cellsWide; cellX++)
+        {
+            // Occupied cells may hold reference counts, so only compare occupied/free
+            float value = _occupancy.at(cellX, cellZ) != 0 ? 1.0f : 0.0f;
+            float &previousValue = _snapshot[cellZ * cellsWide + cellX];
+            if (value != previousValue)
+            {
+                previousValue = value;
+                changed[clusterOf(OccupancyMap::CellIndices(cellX, cellZ))] = true;
+            }
+        }
+    }
+
+    // Safety of a cell depends on occupancy up to half a footprint away, so a change may spill over
+    // into neighboring clusters. Recompute safety and determine which clusters are affected.
+    size_t delta = _footprintSideLength / 2;
+    std::vector<bool> dirty(numClusters, false);
+    for (size_t cluster = 0; cluster < numClusters; cluster++)
+    {
+        if (!changed[cluster])
+        {
+            continue;
+        }
+
+        size_t cellXMin, cellZMin, cellXMax, cellZMax;
+        clusterBounds(cluster, &cellXMin, &cellZMin, &cellXMax, &cellZMax);
+        cellXMin = cellXMin > delta ? cellXMin - delta : 0;
+        cellZMin = cellZMin > delta ? cellZMin - delta : 0;
+        cellXMax = std::min(cellXMax + delta, cellsWide - 1);
+        cellZMax = std::min(cellZMax + delta, cellsDeep - 1);
+        for (size_t cellZ = cellZMin; cellZ <= cellZMax; cellZ++)
+        {
+            for (size_t cellX = cellXMin; cellX <= cellXMax; cellX++)
+            {
+                _safe[cellZ * cellsWide + cellX] = isCellSafe(_occupancy, OccupancyMap::CellIndices(cellX, cellZ), _footprintSideLength);
+            }
+        }
+
+        for (size_t clusterZ = cellZMin / _clusterSize; clusterZ <= cellZMax / _clusterSize; clusterZ++)
+        {
+            for (size_t clusterX = cellXMin / _clusterSize; clusterX <= cellXMax / _clusterSize; clusterX++)
+            {
+                dirty[clusterZ * _clustersWide + clusterX] = true;
+            }
+        }
+    }
+
+    // Rebuild the entrances along every border of a dirty cluster. The clusters on both sides of a
+    // rebuilt border then need their intra-cluster edges recomputed.
+    std::vector<bool> rebuildEdges(numClusters, false);
+    std::vector<bool> verticalBorderRebuilt(numClusters, false);
+    std::vector<bool> horizontalBorderRebuilt(numClusters, false);
+    auto rebuildVerticalBorder = [&](size_t clusterX, size_t clusterZ)
+    {
+        size_t cluster = clusterZ * _clustersWide + clusterX;
+        if (clusterX + 1 >= _clustersWide || verticalBorderRebuilt[cluster])
+        {
+            return;
+        }
+        rebuildBorder(&_verticalBorders[cluster], true, clusterX, clusterZ);
+        verticalBorderRebuilt[cluster] = true;
+        rebuildEdges[cluster] = true;
+        rebuildEdges[cluster + 1] = true;
+    };
+    auto rebuildHorizontalBorder = [&](size_t clusterX, size_t clusterZ)
+    {
+        size_t cluster = clusterZ * _clustersWide + clusterX;
+        if (clusterZ + 1 >= _clustersDeep || horizontalBorderRebuilt[cluster])
+        {
+            return;
+        }
+        rebuildBorder(&_horizontalBorders[cluster], false, clusterX, clusterZ);
+        horizontalBorderRebuilt[cluster] = true;
+        rebuildEdges[cluster] = true;
+        rebuildEdges[cluster + _clustersWide] = true;
+    };
+    for (size_t cluster = 0; cluster < numClusters; cluster++)
+    {
+        if (!dirty[cluster])
+        {
+            continue;
+        }
+        size_t clusterX = cluster % _clustersWide;
+        size_t clusterZ = cluster / _clustersWide;
+        rebuildEdges[cluster] = true;
+        rebuildVerticalBorder(clusterX, clusterZ);
+        rebuildHorizontalBorder(clusterX, clusterZ);
+        if (clusterX > 0)
+        {
+            rebuildVerticalBorder(clusterX - 1, clusterZ);
+        }
+        if (clusterZ > 0)
+        {
+            rebuildHorizontalBorder(clusterX, clusterZ - 1);
+        }
+    }
+
+    size_t numRebuilt = 0;
+    for (size_t cluster = 0; cluster < numClusters; cluster++)
+    {
+        if (rebuildEdges[cluster])
+        {
+            rebuildIntraClusterEdges(cluster);
+            numRebuilt += 1;
+        }
+    }
+
+    if (numRebuilt > 0)
+    {
+        rebuildAdjacency();
+    }
+    return numRebuilt;
+}
+
+std::vector<OccupancyMap::CellIndices> HierarchicalPathfinder::findPath(simd_float3 from, simd_float3 to, bool refineAllSegments) const
+{
+    std::vector<OccupancyMap::CellIndices> path;
+
+    OccupancyMap::CellIndices dest = _occupancy.positionToCell(to);
+    OccupancyMap::CellIndices src = _occupancy.positionToCell(from);
+
+    if (_occupancy.at(dest) != 0)
+    {
+        // Destination is occupied, no path
+        return path;
+    }
+
+    if (dest == src)
+    {
+        path.emplace_back(src);
+        return path;
+    }
+
+    // Connect the source and destination to nearby entrances. The endpoints are exempt from the
+    // footprint test and may only be enterable from a neighboring cluster, so these searches extend
+    // one cluster beyond the endpoint's own. They are also used to refine the first and last segments.
+    RegionSearch srcSearch;
+    RegionSearch destSearch;
+    searchEndpoint(&srcSearch, src, dest);
+    searchEndpoint(&destSearch, dest, src);
+
+    uint32_t srcId = uint32_t(_nodes.size());
+    uint32_t destId = srcId + 1;
+    std::vector<Edge> srcEdges;
+    for (size_t clusterZ = srcSearch.originZ / _clusterSize; clusterZ <= (srcSearch.originZ + srcSearch.depth - 1) / _clusterSize; clusterZ++)
+    {
+        for (size_t clusterX = srcSearch.originX / _clusterSize; clusterX <= (srcSearch.originX + srcSearch.width - 1) / _clusterSize; clusterX++)
+        {
+            for (uint32_t node: nodesInCluster(clusterZ * _clustersWide + clusterX))
+            {
+                uint32_t distance = srcSearch.distance[srcSearch.localIndex(_nodes[node].cell)];
+                if (distance != unreachable)
+                {
+                    srcEdges.emplace_back(Edge{ .to = node, .cost = distance });
+                }
+            }
+        }
+    }
+    if (srcSearch.contains(dest) && srcSearch.distance[srcSearch.localIndex(dest)] != unreachable)
+    {
+        srcEdges.emplace_back(Edge{ .to = destId, .cost = srcSearch.distance[srcSearch.localIndex(dest)] });
+    }
+
+    auto cellOf = [&](uint32_t id) -> OccupancyMap::CellIndices
+    {
+        return id == srcId ? src : (id == destId ? dest : _nodes[id].cell);
+    };
+
+    auto heuristic = [&](uint32_t id) -> uint32_t
+    {
+        OccupancyMap::CellIndices cell = cellOf(id);
+        return uint32_t(std::labs(long(cell.cellX) - long(dest.cellX)) + std::labs(long(cell.cellZ) - long(dest.cellZ)));
+    };
+
+    // A* over the abstract graph
+    std::vector<uint32_t> costSoFar(_nodes.size() + 2, unreachable);
+    std::vector<uint32_t> cameFrom(_nodes.size() + 2, unreachable);
+    using QueueEntry = std::pair<uint32_t, uint32_t>;   // (f, id)
+    std::priority_queue<QueueEntry, std::vector<QueueEntry>, std::greater<QueueEntry>> frontier;
+    costSoFar[srcId] = 0;
+    frontier.push({ heuristic(srcId), srcId });
+
+    auto relax = [&](uint32_t current, uint32_t next, uint32_t cost)
+    {
+        uint32_t newCost = costSoFar[current] + cost;
+        if (newCost < costSoFar[next])
+        {
+            costSoFar[next] = newCost;
+            cameFrom[next] = current;
+            frontier.push({ newCost + heuristic(next), next });
+        }
+    };
+
+    bool foundPath = false;
+    while (!frontier.empty())
+    {
+        auto [f, current] = frontier.top();
+        frontier.pop();
+        if (f > costSoFar[current] + heuristic(current))
+        {
+            // Stale entry
+            continue;
+        }
+
+        if (current == destId)
+        {
+            foundPath = true;
+            break;
+        }
+
+        if (current == srcId)
+        {
+            for (const Edge &edge: srcEdges)
+            {
+                relax(current, edge.to, edge.cost);
+            }
+            continue;
+        }
+
+        for (const Edge &edge: _adjacency[current])
+        {
+            relax(current, edge.to, edge.cost);
+        }
+        if (destSearch.contains(_nodes[current].cell))
+        {
+            uint32_t distance = destSearch.distance[destSearch.localIndex(_nodes[current].cell)];
+            if (distance != unreachable)
+            {
+                relax(current, destId, distance);
+            }
+        }
+    }
+
+    if (!foundPath)
+    {
+        // No path found. Return empty vector.
+        return path;
+    }
+
+    std::vector<uint32_t> abstractPath;
+    for (uint32_t id = destId; id != srcId; id = cameFrom[id])
+    {
+        abstractPath.emplace_back(id);
+    }
+    abstractPath.emplace_back(srcId);
+    std::reverse(abstractPath.begin(), abstractPath.end());
+
+    // Produce cells, refining segments as requested
+    std::vector<OccupancyMap::CellIndices> cells;
+    cells.emplace_back(src);
+    for (size_t i = 0; i + 1 < abstractPath.size(); i++)
+    {
+        uint32_t a = abstractPath[i];
+        uint32_t b = abstractPath[i + 1];
+        bool refine = i == 0 || refineAllSegments;
+        if (!refine)
+        {
+            cells.emplace_back(cellOf(b));
+        }
+        else if (a == srcId)
+        {
+            tracePath(&cells, srcSearch, cellOf(b));
+        }
+        else if (b == destId)
+        {
+            // The destination search is rooted at dest, so following parents from a leads to it
+            size_t idx = destSearch.localIndex(cellOf(a));
+            size_t destIdx = destSearch.localIndex(dest);
+            while (idx != destIdx)
+            {
+                idx = destSearch.parent[idx];
+                cells.emplace_back(destSearch.originX + idx % destSearch.width, destSearch.originZ + idx / destSearch.width);
+            }
+        }
+        else if (_nodes[a].cluster != _nodes[b].cluster)
+        {
+            // Entrances on opposite sides of a border are adjacent
+            cells.emplace_back(cellOf(b));
+        }
+        else
+        {
+            RegionSearch search;
+            searchCluster(&search, _nodes[a].cluster, cellOf(a));
+            tracePath(&cells, search, cellOf(b));
+        }
+    }
+
+    return removeCollinearCells(cells);
+}
+
+size_t HierarchicalPathfinder::clusterOf(OccupancyMap::CellIndices cell) const
+{
+    return (cell.cellZ / _clusterSize) * _clustersWide + (cell.cellX / _clusterSize);
+}
+
+void HierarchicalPathfinder::clusterBounds(size_t cluster, size_t *cellXMin, size_t *cellZMin, size_t *cellXMax, size_t *cellZMax) const
+{
+    size_t clusterX = cluster % _clustersWide;
+    size_t clusterZ = cluster / _clustersWide;
+    *cellXMin = clusterX * _clusterSize;
+    *cellZMin = clusterZ * _clusterSize;
+    *cellXMax = std::min(*cellXMin + _clusterSize, _occupancy.cellsWide()) - 1;
+    *cellZMax = std::min(*cellZMin + _clusterSize, _occupancy.cellsDeep()) - 1;
+}
+
+bool HierarchicalPathfinder::isSafe(size_t cellX, size_t cellZ) const
+{
+    return _safe[cellZ * _occupancy.cellsWide() + cellX] != 0;
+}
+
+uint32_t HierarchicalPathfinder::addNode(OccupancyMap::CellIndices cell)
+{
+    size_t key = cell.cellZ * _occupancy.cellsWide() + cell.cellX;
+    auto it = _nodeByCell.find(key);
+    if (it != _nodeByCell.end())
+    {
+        _nodes[it->second].refCount += 1;
+        return it->second;
+    }
+
+    uint32_t node;
+    if (_freeNodes.empty())
+    {
+        node = uint32_t(_nodes.size());
+        _nodes.emplace_back();
+    }
+    else
+    {
+        node = _freeNodes.back();
+        _freeNodes.pop_back();
+    }
+    _nodes[node] = Node{ .cell = cell, .cluster = clusterOf(cell), .refCount = 1 };
+    _nodeByCell[key] = node;
+    return node;
+}
+
+void HierarchicalPathfinder::releaseNode(uint32_t node)
+{
+    if (--_nodes[node].refCount == 0)
+    {
+        OccupancyMap::CellIndices cell = _nodes[node].cell;
+        _nodeByCell.erase(cell.cellZ * _occupancy.cellsWide() + cell.cellX);
+        _freeNodes.emplace_back(node);
+    }
+}
+
+void HierarchicalPathfinder::rebuildBorder(std::vector<std::pair<uint32_t, uint32_t>> *border, bool vertical, size_t clusterX, size_t clusterZ)
+{
+    for (auto &entrance: *border)
+    {
+        releaseNode(entrance.first);
+        releaseNode(entrance.second);
+    }
+    border->clear();
+
+    // The border runs along the last row or column of the cluster. Cells on either side of it are
+    // (x1,z1) and (x2,z2), parameterized by position t along the border.
+    size_t cellsAlong = vertical ? _occupancy.cellsDeep() : _occupancy.cellsWide();
+    size_t tMin = (vertical ? clusterZ : clusterX) * _clusterSize;
+    size_t tMax = std::min(tMin + _clusterSize, cellsAlong);
+    size_t edge = ((vertical ? clusterX : clusterZ) + 1) * _clusterSize - 1;
+    auto cellAt = [&](size_t t, size_t side) -> OccupancyMap::CellIndices
+    {
+        return vertical ? OccupancyMap::CellIndices(edge + side, t) : OccupancyMap::CellIndices(t, edge + side);
+    };
+    auto placeEntrance = [&](size_t t)
+    {
+        uint32_t first = addNode(cellAt(t, 0));
+        uint32_t second = addNode(cellAt(t, 1));
+        border->emplace_back(first, second);
+    };
+
+    // Each maximal run of cells that are open on both sides becomes an entrance. Short runs get a
+    // single transition in the middle, long ones a transition at either end.
+    constexpr size_t longEntranceLength = 6;
+    size_t runStart = tMin;
+    bool inRun = false;
+    for (size_t t = tMin; t <= tMax; t++)
+    {
+        bool open = false;
+        if (t < tMax)
+        {
+            OccupancyMap::CellIndices a = cellAt(t, 0);
+            OccupancyMap::CellIndices b = cellAt(t, 1);
+            open = isSafe(a.cellX, a.cellZ) && isSafe(b.cellX, b.cellZ);
+        }
+
+        if (open && !inRun)
+        {
+            runStart = t;
+            inRun = true;
+        }
+        else if (!open && inRun)
+        {
+            size_t runLength = t - runStart;
+            if (runLength < longEntranceLength)
+            {
+                placeEntrance(runStart + runLength / 2);
+            }
+            else
+            {
+                placeEntrance(runStart);
+                placeEntrance(t - 1);
+            }
+            inRun = false;
+        }
+    }
+}
+
+void HierarchicalPathfinder::rebuildIntraClusterEdges(size_t cluster)
+{
+    std::vector<ClusterEdge> &edges = _clusterEdges[cluster];
+    edges.clear();
+
+    std::vector<uint32_t> nodes = nodesInCluster(cluster);
+    RegionSearch search;
+    for (size_t i = 0; i < nodes.size(); i++)
+    {
+        searchCluster(&search, cluster, _nodes[nodes[i]].cell);
+        for (size_t j = i + 1; j < nodes.size(); j++)
+        {
+            uint32_t distance = search.distance[search.localIndex(_nodes[nodes[j]].cell)];
+            if (distance != unreachable)
+            {
+                edges.emplace_back(ClusterEdge{ .from = nodes[i], .to = nodes[j], .cost = distance });
+            }
+        }
+    }
+}
+
+void HierarchicalPathfinder::rebuildAdjacency()
+{
+    _adjacency.assign(_nodes.size(), {});
+    for (auto &edges: _clusterEdges)
+    {
+        for (const ClusterEdge &edge: edges)
+        {
+            _adjacency[edge.from].emplace_back(Edge{ .to = edge.to, .cost = edge.cost });
+            _adjacency[edge.to].emplace_back(Edge{ .to = edge.from, .cost = edge.cost });
+        }
+    }
+    for (auto *borders: { &_verticalBorders, &_horizontalBorders })
+    {
+        for (auto &border: *borders)
+        {
+            for (auto &entrance: border)
+            {
+                _adjacency[entrance.first].emplace_back(Edge{ .to = entrance.second, .cost = 1 });
+                _adjacency[entrance.second].emplace_back(Edge{ .to = entrance.first, .cost = 1 });
+            }
+        }
+    }
+}
+
+std::vector<uint32_t> HierarchicalPathfinder::nodesInCluster(size_t cluster) const
+{
+    std::vector<uint32_t> nodes;
+    size_t clusterX = cluster % _clustersWide;
+    size_t clusterZ = cluster / _clustersWide;
+
+    for (auto &entrance: _verticalBorders[cluster])
+    {
+        nodes.emplace_back(entrance.first);
+    }
+    for (auto &entrance: _horizontalBorders[cluster])
+    {
+        nodes.emplace_back(entrance.first);
+    }
+    if (clusterX > 0)
+    {
+        for (auto &entrance: _verticalBorders[cluster - 1])
+        {
+            nodes.emplace_back(entrance.second);
+        }
+    }
+    if (clusterZ > 0)
+    {
+        for (auto &entrance: _horizontalBorders[cluster - _clustersWide])
+        {
+            nodes.emplace_back(entrance.second);
+        }
+    }
+
+    // Cells at the corners of a cluster may be entrances on two borders
+    std::sort(nodes.begin(), nodes.end());
+    nodes.erase(std::unique(nodes.begin(), nodes.end()), nodes.end());
+    return nodes;
+}
+
+void HierarchicalPathfinder::searchCluster(RegionSearch *search, size_t cluster, OccupancyMap::CellIndices start) const
+{
+    size_t cellXMin, cellZMin, cellXMax, cellZMax;
+    clusterBounds(cluster, &cellXMin, &cellZMin, &cellXMax, &cellZMax);
+    searchRegion(search, cellXMin, cellZMin, cellXMax, cellZMax, start, start);
+}
+
+void HierarchicalPathfinder::searchEndpoint(RegionSearch *search, OccupancyMap::CellIndices start, OccupancyMap::CellIndices exempt) const
+{
+    size_t clusterX = start.cellX / _clusterSize;
+    size_t clusterZ = start.cellZ / _clusterSize;
+    size_t cellXMin = clusterX > 0 ? (clusterX - 1) * _clusterSize : 0;
+    size_t cellZMin = clusterZ > 0 ? (clusterZ - 1) * _clusterSize : 0;
+    size_t cellXMax = std::min((clusterX + 2) * _clusterSize, _occupancy.cellsWide()) - 1;
+    size_t cellZMax = std::min((clusterZ + 2) * _clusterSize, _occupancy.cellsDeep()) - 1;
+    searchRegion(search, cellXMin, cellZMin, cellXMax, cellZMax, start, exempt);
+}
+
+void HierarchicalPathfinder::searchRegion(RegionSearch *search, size_t cellXMin, size_t cellZMin, size_t cellXMax, size_t cellZMax, OccupancyMap::CellIndices start, OccupancyMap::CellIndices exempt) const
+{
+    size_t width = cellXMax - cellXMin + 1;
+    size_t depth = cellZMax - cellZMin + 1;
+
+    search->originX = cellXMin;
+    search->originZ = cellZMin;
+    search->width = width;
+    search->depth = depth;
+    search->distance.assign(width * depth, unreachable);
+    search->parent.assign(width * depth, unreachable);
+
+    // Breadth-first search over safe cells. The exempt cell (e.g., the destination) need not be safe.
+    std::vector<uint32_t> frontier;
+    frontier.reserve(width * depth);
+    size_t startIdx = (start.cellZ - cellZMin) * width + (start.cellX - cellXMin);
+    search->distance[startIdx] = 0;
+    search->parent[startIdx] = uint32_t(startIdx);
+    frontier.emplace_back(uint32_t(startIdx));
+    for (size_t head = 0; head < frontier.size(); head++)
+    {
+        size_t idx = frontier[head];
+        long x = long(idx % width);
+        long z = long(idx / width);
+        const long neighborOffsets[4][2] = { { -1, 0 }, { 1, 0 }, { 0, -1 }, { 0, 1 } };
+        for (auto &offset: neighborOffsets)
+        {
+            long neighborX = x + offset[0];
+            long neighborZ = z + offset[1];
+            if (neighborX < 0 || neighborZ < 0 || neighborX >= long(width) || neighborZ >= long(depth))
+            {
+                continue;
+            }
+
+            size_t neighborIdx = size_t(neighborZ) * width + size_t(neighborX);
+            if (search->distance[neighborIdx] != unreachable)
+            {
+                continue;
+            }
+
+            size_t cellX = cellXMin + size_t(neighborX);
+            size_t cellZ = cellZMin + size_t(neighborZ);
+            if (!isSafe(cellX, cellZ) && OccupancyMap::CellIndices(cellX, cellZ) != exempt)
+            {
+                continue;
+            }
+
+            search->distance[neighborIdx] = search->distance[idx] + 1;
+            search->parent[neighborIdx] = uint32_t(idx);
+            frontier.emplace_back(uint32_t(neighborIdx));
+        }
+    }
+}
+
+void HierarchicalPathfinder::tracePath(std::vector<OccupancyMap::CellIndices> *cells, const RegionSearch &search, OccupancyMap::CellIndices to) const
+{
+    // Walk back from the target to the root of the search, then append in forward order (excluding
+    // the root, which the caller already has)
+    size_t firstNew = cells->size();
+    size_t idx = search.localIndex(to);
+    while (search.parent[idx] != idx)
+    {
+        cells->emplace_back(search.originX + idx % search.width, search.originZ + idx / search.width);
+        idx = search.parent[idx];
+    }
+    std::reverse(cells->begin() + firstNew, cells->end());
+}
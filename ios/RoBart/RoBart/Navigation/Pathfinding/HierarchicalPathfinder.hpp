@@ -0,0 +1,143 @@
+//
+//  HierarchicalPathfinder.hpp
+//  RoBart
+//
+//  Created by Bart Trzynadlowski on 10/16/26.
+//
+//  This file is part of RoBart.
+//
+//  RoBart is free software: you can redistribute it and/or modify it under the
+//  terms of the GNU General Public License as published by the Free Software
+//  Foundation, either version 3 of the License, or (at your option) any later
+//  version.
+//
+//  RoBart is distributed in the hope that it will be useful, but WITHOUT
+//  ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+//  FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+//  more details.
+//
+//  You should have received a copy of the GNU General Public License along
+//  with RoBart. If not, see <http://www.gnu.org/licenses/>.
+//
+
+#ifndef HierarchicalPathfinder_hpp
+#define HierarchicalPathfinder_hpp
+
+#include "OccupancyMap.hpp"
+#include <simd/simd.h>
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+/// Hierarchical path planner (HPA*) for large occupancy maps. The map is divided into square
+/// clusters of cells. Entrances are placed along the borders between adjacent clusters and the
+/// shortest distance between every pair of entrances within a cluster is precomputed, producing a
+/// small abstract graph that long-range queries are answered on. Only the clusters whose occupancy
+/// has changed are re-examined by update().
+///
+/// Paths follow the same rules as findPath(): 4-connected moves, a square robot footprint, and the
+/// destination need only be unoccupied.
+class HierarchicalPathfinder
+{
+public:
+    /// Creates a planner over an occupancy map. The occupancy map shares memory with the caller's
+    /// map, so subsequent modifications are seen by update().
+    /// - Parameter occupancy: The occupancy map.
+    /// - Parameter robotRadius: A characteristic robot radius that encompasses the robot's total footprint.
+    /// - Parameter clusterSize: Side length of a cluster, in cells.
+    HierarchicalPathfinder(const OccupancyMap &occupancy, float robotRadius, size_t clusterSize = 16);
+
+    /// Brings the abstract graph up to date with the occupancy map, rebuilding only the clusters
+    /// that changed (and their neighbors, whose borders are shared) since the last call.
+    /// - Returns: The number of clusters that were rebuilt.
+    size_t update();
+
+    /// Finds a path. The first segment (up to the first entrance) is always refined to individual
+    /// cells. Subsequent waypoints are cluster entrances unless `refineAllSegments` is set, in which
+    /// case the entire path is refined. Either way, the result is reduced to the waypoints at which
+    /// the direction changes.
+    /// - Returns: The path from `from` to `to`, or an empty vector if no path exists.
+    std::vector<OccupancyMap::CellIndices> findPath(simd_float3 from, simd_float3 to, bool refineAllSegments) const;
+
+private:
+    struct Node
+    {
+        OccupancyMap::CellIndices cell;
+        size_t cluster = 0;
+        uint32_t refCount = 0;
+    };
+
+    struct Edge
+    {
+        uint32_t to;
+        uint32_t cost;
+    };
+
+    struct ClusterEdge
+    {
+        uint32_t from;
+        uint32_t to;
+        uint32_t cost;
+    };
+
+    /// Results of a breadth-first search confined to a rectangular region, in region-local coordinates.
+    struct RegionSearch
+    {
+        size_t originX;
+        size_t originZ;
+        size_t width;
+        size_t depth;
+        std::vector<uint32_t> distance;
+        std::vector<uint32_t> parent;
+
+        bool contains(OccupancyMap::CellIndices cell) const
+        {
+            return cell.cellX >= originX && cell.cellX < originX + width && cell.cellZ >= originZ && cell.cellZ < originZ + depth;
+        }
+
+        size_t localIndex(OccupancyMap::CellIndices cell) const
+        {
+            return (cell.cellZ - originZ) * width + (cell.cellX - originX);
+        }
+    };
+
+    static constexpr uint32_t unreachable = UINT32_MAX;
+
+    size_t clusterOf(OccupancyMap::CellIndices cell) const;
+    void clusterBounds(size_t cluster, size_t *cellXMin, size_t *cellZMin, size_t *cellXMax, size_t *cellZMax) const;
+    bool isSafe(size_t cellX, size_t cellZ) const;
+    uint32_t addNode(OccupancyMap::CellIndices cell);
+    void releaseNode(uint32_t node);
+    void rebuildBorder(std::vector<std::pair<uint32_t, uint32_t>> *border, bool vertical, size_t clusterX, size_t clusterZ);
+    void rebuildIntraClusterEdges(size_t cluster);
+    void rebuildAdjacency();
+    std::vector<uint32_t> nodesInCluster(size_t cluster) const;
+    void searchCluster(RegionSearch *search, size_t cluster, OccupancyMap::CellIndices start) const;
+    void searchEndpoint(RegionSearch *search, OccupancyMap::CellIndices start, OccupancyMap::CellIndices exempt) const;
+    void searchRegion(RegionSearch *search, size_t cellXMin, size_t cellZMin, size_t cellXMax, size_t cellZMax, OccupancyMap::CellIndices start, OccupancyMap::CellIndices exempt) const;
+    void tracePath(std::vector<OccupancyMap::CellIndices> *cells, const RegionSearch &search, OccupancyMap::CellIndices to) const;
+
+    OccupancyMap _occupancy;
+    std::vector<float> _snapshot;
+    size_t _clusterSize;
+    size_t _clustersWide;
+    size_t _clustersDeep;
+    size_t _footprintSideLength;
+    std::vector<uint8_t> _safe;
+
+    std::vector<Node> _nodes;
+    std::vector<uint32_t> _freeNodes;
+    std::unordered_map<size_t, uint32_t> _nodeByCell;
+
+    // Entrance pairs along the border to the right of (vertical) and below (horizontal) each
+    // cluster. The first node of each pair lies in the cluster, the second in its neighbor.
+    std::vector<std::vector<std::pair<uint32_t, uint32_t>>> _verticalBorders;
+    std::vector<std::vector<std::pair<uint32_t, uint32_t>>> _horizontalBorders;
+
+    // Undirected shortest distances between pairs of entrance nodes within each cluster
+    std::vector<std::vector<ClusterEdge>> _clusterEdges;
+
+    std::vector<std::vector<Edge>> _adjacency;
+};
+
+#endif /* HierarchicalPathfinder_hpp */
@@ -0,0 +1,309 @@
+//
+//  LatticePlanner.cpp
+//  RoBart
+//
+//  Created by Bart Trzynadlowski on 10/16/26.
+//
+//  This file is part of RoBart.
+//
+//  RoBart is free software: you can redistribute it and/or modify it under the
+//  terms of the GNU General Public License as published by the Free Software
+//  Foundation, either version 3 of the License, or (at your option) any later
+//  version.
+//
+//  RoBart is distributed in the hope that it will be useful, but WITHOUT
+//  ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+//  FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+//  more details.
+//
+//  You should have received a copy of the GNU General Public License along
+//  with RoBart. If not, see <http://www.gnu.org/licenses/>.
+//
+
+#include "LatticePlanner.hpp"
+#include <algorithm>
+#include <cmath>
+#include <queue>
+#include <unordered_map>
+
+// Cell step along each lattice heading, counter-clockwise from +x (viewed with +z down)
+static const int headingSteps[8][2] = { { 1, 0 }, { 1, 1 }, { 0, 1 }, { -1, 1 }, { -1, 0 }, { -1, -1 }, { 0, -1 }, { 1, -1 } };
+
+/// Separating axis test between a unit cell centered at (cx, cz) and a rectangle centered at the
+/// origin with half extents (halfWidth, halfLength) whose length axis points along `angle`. All
+/// quantities are in cell units.
+static bool cellOverlapsRectangle(float cx, float cz, float angle, float halfWidth, float halfLength)
+{
+    float ux = std::cos(angle);
+    float uz = std::sin(angle);
+    float vx = -uz;
+    float vz = ux;
+
+    // Axes of the cell
+    float rectExtentX = std::abs(ux) * halfLength + std::abs(vx) * halfWidth;
+    float rectExtentZ = std::abs(uz) * halfLength + std::abs(vz) * halfWidth;
+    if (std::abs(cx) > 0.5f + rectExtentX || std::abs(cz) > 0.5f + rectExtentZ)
+    {
+        return false;
+    }
+
+    // Axes of the rectangle
+    float cellExtentU = 0.5f * (std::abs(ux) + std::abs(uz));
+    float cellExtentV = 0.5f * (std::abs(vx) + std::abs(vz));
+    float centerU = cx * ux + cz * uz;
+    float centerV = cx * vx + cz * vz;
+    return std::abs(centerU) <= halfLength + cellExtentU && std::abs(centerV) <= halfWidth + cellExtentV;
+}
+
+LatticePlanner::LatticePlanner(const OccupancyMap &occupancy, const LatticeMotionModel &model)
+    : _occupancy(occupancy),
+      _model(model)
+{
+    // Rasterize the footprint at each orientation. Slightly shrink the rectangle so that exact
+    // tangency with a neighboring cell does not count as overlap.
+    float halfWidth = 0.5f * model.robotWidth / occupancy.cellSide() - 1e-3f;
+    float halfLength = 0.5f * model.robotLength / occupancy.cellSide() - 1e-3f;
+    int radius = int(std::ceil(std::sqrt(halfWidth * halfWidth + halfLength * halfLength) + 0.5f));
+    for (int orientation = 0; orientation < numOrientations; orientation++)
+    {
+        float angle = float(orientation) * float(M_PI) / float(numHeadings);
+        for (int dz = -radius; dz <= radius; dz++)
+        {
+            for (int dx = -radius; dx <= radius; dx++)
+            {
+                if (cellOverlapsRectangle(float(dx), float(dz), angle, std::max(0.0f, halfWidth), std::max(0.0f, halfLength)))
+                {
+                    _footprints[orientation].emplace_back(dx, dz);
+                }
+            }
+        }
+    }
+}
+
+std::vector<LatticeWaypoint> LatticePlanner::findPath(simd_float3 from, simd_float3 forward, simd_float3 to) const
+{
+    std::vector<LatticeWaypoint> path;
+
+    OccupancyMap::CellIndices src = _occupancy.positionToCell(from);
+    OccupancyMap::CellIndices dest = _occupancy.positionToCell(to);
+    int srcHeading = int(std::lround(std::atan2(forward.z, forward.x) / (0.25 * M_PI)));
+    srcHeading = ((srcHeading % numHeadings) + numHeadings) % numHeadings;
+
+    if (_occupancy.at(dest) != 0)
+    {
+        // Destination is occupied, no path
+        return path;
+    }
+
+    if (src == dest)
+    {
+        path.emplace_back(LatticeWaypoint{ .cell = src, .headingDegrees = 45.0f * srcHeading });
+        return path;
+    }
+
+    // Primitive costs, in seconds
+    float axialStepTime = _occupancy.cellSide() / _model.linearSpeed;
+    float diagonalStepTime = float(M_SQRT2) * axialStepTime;
+    float turnTime = 45.0f / _model.angularSpeed;
+    float rotateInPlaceTime = turnTime + _model.rotateInPlacePenalty;
+
+    size_t cellsWide = _occupancy.cellsWide();
+    size_t cellsDeep = _occupancy.cellsDeep();
+    auto encode = [&](size_t cellX, size_t cellZ, int heading) -> uint64_t
+    {
+        return (uint64_t(cellZ) * cellsWide + cellX) * numHeadings + uint64_t(heading);
+    };
+    auto heuristic = [&](long cellX, long cellZ) -> float
+    {
+        float dx = float(cellX - long(dest.cellX));
+        float dz = float(cellZ - long(dest.cellZ));
+        return std::sqrt(dx * dx + dz * dz) * axialStepTime;
+    };
+
+    struct StateRecord
+    {
+        float cost;
+        uint64_t parent;
+        bool closed;
+    };
+
+    // Collision results are cached per query (the map may change between queries) and states are
+    // only materialized as they are reached, in a hashed closed set
+    std::vector<int8_t> collisionCache(cellsWide * cellsDeep * numOrientations, -1);
+    std::unordered_map<uint64_t, StateRecord> states;
+    using QueueEntry = std::pair<float, uint64_t>;
+    std::priority_queue<QueueEntry, std::vector<QueueEntry>, std::greater<QueueEntry>> frontier;
+
+    uint64_t srcState = encode(src.cellX, src.cellZ, srcHeading);
+    states[srcState] = StateRecord{ .cost = 0, .parent = srcState, .closed = false };
+    frontier.push({ heuristic(src.cellX, src.cellZ), srcState });
+
+    // Source and destination are exempt from footprint tests
+    auto isFree = [&](long cellX, long cellZ, int orientation) -> bool
+    {
+        if (cellX < 0 || cellZ < 0 || cellX >= long(cellsWide) || cellZ >= long(cellsDeep))
+        {
+            return false;
+        }
+        if ((size_t(cellX) == dest.cellX && size_t(cellZ) == dest.cellZ) || (size_t(cellX) == src.cellX && size_t(cellZ) == src.cellZ))
+        {
+            return true;
+        }
+        return isCollisionFree(&collisionCache, cellX, cellZ, orientation);
+    };
+
+    auto relax = [&](uint64_t current, float currentCost, long cellX, long cellZ, int heading, float cost)
+    {
+        uint64_t next = encode(cellX, cellZ, heading);
+        float newCost = currentCost + cost;
+        auto it = states.find(next);
+        if (it == states.end())
+        {
+            states[next] = StateRecord{ .cost = newCost, .parent = current, .closed = false };
+        }
+        else if (!it->second.closed && newCost < it->second.cost)
+        {
+            it->second.cost = newCost;
+            it->second.parent = current;
+        }
+        else
+        {
+            return;
+        }
+        frontier.push({ newCost + heuristic(cellX, cellZ), next });
+    };
+
+    uint64_t goalState = 0;
+    bool foundPath = false;
+    while (!frontier.empty())
+    {
+        uint64_t current = frontier.top().second;
+        frontier.pop();
+        StateRecord &record = states[current];
+        if (record.closed)
+        {
+            continue;
+        }
+        record.closed = true;
+        float currentCost = record.cost;
+
+        int heading = int(current % numHeadings);
+        size_t idx = size_t(current / numHeadings);
+        long x = long(idx % cellsWide);
+        long z = long(idx / cellsWide);
+        if (size_t(x) == dest.cellX && size_t(z) == dest.cellZ)
+        {
+            goalState = current;
+            foundPath = true;
+            break;
+        }
+
+        const int *step = headingSteps[heading];
+        bool isDiagonal = (heading & 1) != 0;
+
+        // Straight ahead. Diagonal moves also sweep the two cells they cut between.
+        long straightX = x + step[0];
+        long straightZ = z + step[1];
+        bool straightIsFree = isFree(straightX, straightZ, 2 * heading) &&
+                              (!isDiagonal || (isFree(x + step[0], z, 2 * heading) && isFree(x, z + step[1], 2 * heading)));
+        if (straightIsFree)
+        {
+            relax(current, currentCost, straightX, straightZ, heading, isDiagonal ? diagonalStepTime : axialStepTime);
+        }
+
+        for (int turn: { -1, 1 })
+        {
+            int newHeading = (heading + turn + numHeadings) % numHeadings;
+            int sweptOrientation = (2 * heading + turn + numOrientations) % numOrientations;
+
+            // Rotate in place
+            if (isFree(x, z, sweptOrientation) && isFree(x, z, 2 * newHeading))
+            {
+                relax(current, currentCost, x, z, newHeading, rotateInPlaceTime);
+            }
+
+            // Arc: one step along the current heading then one along the new heading, turning
+            // throughout
+            if (straightIsFree && isFree(straightX, straightZ, sweptOrientation))
+            {
+                const int *newStep = headingSteps[newHeading];
+                long arcX = straightX + newStep[0];
+                long arcZ = straightZ + newStep[1];
+                if (isFree(arcX, arcZ, 2 * newHeading))
+                {
+                    float arcLengthTime = (isDiagonal ? diagonalStepTime : axialStepTime) + ((newHeading & 1) ? diagonalStepTime : axialStepTime);
+                    relax(current, currentCost, arcX, arcZ, newHeading, std::max(arcLengthTime, turnTime));
+                }
+            }
+        }
+    }
+
+    if (!foundPath)
+    {
+        // No path found. Return empty vector.
+        return path;
+    }
+
+    // Trace back and keep the start, the end, and poses where the heading is about to change.
+    // Consecutive states in the same cell (turning in place) collapse into the last one.
+    std::vector<uint64_t> trace;
+    for (uint64_t state = goalState; state != srcState; state = states[state].parent)
+    {
+        trace.emplace_back(state);
+    }
+    trace.emplace_back(srcState);
+    std::reverse(trace.begin(), trace.end());
+
+    auto waypointOf = [&](uint64_t state) -> LatticeWaypoint
+    {
+        size_t idx = size_t(state / numHeadings);
+        int heading = int(state % numHeadings);
+        return LatticeWaypoint{ .cell = OccupancyMap::CellIndices(idx % cellsWide, idx / cellsWide), .headingDegrees = 45.0f * heading };
+    };
+
+    for (size_t i = 0; i < trace.size(); i++)
+    {
+        LatticeWaypoint waypoint = waypointOf(trace[i]);
+        bool isLast = i + 1 == trace.size();
+        bool headingWillChange = !isLast && (trace[i + 1] % numHeadings) != (trace[i] % numHeadings);
+        if (i != 0 && !isLast && !headingWillChange)
+        {
+            continue;
+        }
+        if (!path.empty() && path.back().cell == waypoint.cell)
+        {
+            path.back() = waypoint;
+        }
+        else
+        {
+            path.emplace_back(waypoint);
+        }
+    }
+    return path;
+}
+
+bool LatticePlanner::isCollisionFree(std::vector<int8_t> *cache, long cellX, long cellZ, int orientation) const
+{
+    size_t cellsWide = _occupancy.cellsWide();
+    size_t cellsDeep = _occupancy.cellsDeep();
+    int8_t &cached = (*cache)[(size_t(cellZ) * cellsWide + size_t(cellX)) * numOrientations + orientation];
+    if (cached >= 0)
+    {
+        return cached != 0;
+    }
+
+    // As with isCellSafe(), the map edges are not obstacles
+    bool free = true;
+    for (auto &offset: _footprints[orientation])
+    {
+        long x = cellX + offset.first;
+        long z = cellZ + offset.second;
+        if (x >= 0 && z >= 0 && x < long(cellsWide) && z < long(cellsDeep) && _occupancy.at(x, z) != 0)
+        {
+            free = false;
+            break;
+        }
+    }
+    cached = free ? 1 : 0;
+    return free;
+}
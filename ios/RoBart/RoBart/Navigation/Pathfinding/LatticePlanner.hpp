@@ -0,0 +1,91 @@
+//
+//  LatticePlanner.hpp
+//  RoBart
+//
+//  Created by Bart Trzynadlowski on 10/16/26.
+//
+//  This file is part of RoBart.
+//
+//  RoBart is free software: you can redistribute it and/or modify it under the
+//  terms of the GNU General Public License as published by the Free Software
+//  Foundation, either version 3 of the License, or (at your option) any later
+//  version.
+//
+//  RoBart is distributed in the hope that it will be useful, but WITHOUT
+//  ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+//  FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+//  more details.
+//
+//  You should have received a copy of the GNU General Public License along
+//  with RoBart. If not, see <http://www.gnu.org/licenses/>.
+//
+
+#ifndef LatticePlanner_hpp
+#define LatticePlanner_hpp
+
+#include "OccupancyMap.hpp"
+#include <simd/simd.h>
+#include <cstdint>
+#include <vector>
+
+/// Kinematics of the differential-drive base, used to derive motion primitive costs (in seconds).
+struct LatticeMotionModel
+{
+    /// Forward driving speed (m/sec). The default is a nominal figure rather than a measurement and
+    /// should be replaced with the speed observed at the throttle limit in use.
+    float linearSpeed = 0.5f;
+
+    /// Angular speed when turning (deg/sec). Should be obtained from the steering calibration data
+    /// at the steering value the controller will actually use.
+    float angularSpeed = 90.0f;
+
+    /// Fixed time penalty (sec) for coming to a stop and turning in place, which is slower to
+    /// execute than its angular speed alone would suggest.
+    float rotateInPlacePenalty = 0.5f;
+
+    /// Robot footprint dimensions (m): across the wheel axis and along the direction of travel.
+    float robotWidth = 0.6f;
+    float robotLength = 0.7f;
+};
+
+struct LatticeWaypoint
+{
+    OccupancyMap::CellIndices cell;
+
+    /// Heading of the robot upon reaching the cell: the angle of its forward direction, measured
+    /// from +x towards +z.
+    float headingDegrees;
+};
+
+/// State lattice planner over (x, z, heading) for a differential-drive robot. Headings are
+/// discretized in 45 degree increments. Motion primitives are driving straight one cell, turning in
+/// place by 45 degrees, and a gentle arc that advances two cells while turning by 45 degrees, each
+/// costed by its execution time. Collision is tested against the rectangular robot footprint
+/// rasterized at each heading (and the in-between headings swept during turns).
+class LatticePlanner
+{
+public:
+    LatticePlanner(const OccupancyMap &occupancy, const LatticeMotionModel &model);
+
+    /// Finds the fastest path from a starting pose to a destination, arriving at any heading.
+    /// - Parameter from: Starting position.
+    /// - Parameter forward: Starting forward direction (only the xz components are used).
+    /// - Parameter to: Destination. As with findPath(), the destination need only be unoccupied.
+    /// - Returns: The poses at the start, the end, and wherever the heading changes, or an empty
+    /// vector if no path exists.
+    std::vector<LatticeWaypoint> findPath(simd_float3 from, simd_float3 forward, simd_float3 to) const;
+
+private:
+    static constexpr int numHeadings = 8;
+    static constexpr int numOrientations = 2 * numHeadings;    // includes in-between orientations swept during turns
+
+    bool isCollisionFree(std::vector<int8_t> *cache, long cellX, long cellZ, int orientation) const;
+
+    OccupancyMap _occupancy;
+    LatticeMotionModel _model;
+
+    // Cells covered by the footprint at each orientation, as offsets from the center cell
+    std::vector<std::pair<int, int>> _footprints[numOrientations];
+};
+
+#endif /* LatticePlanner_hpp */
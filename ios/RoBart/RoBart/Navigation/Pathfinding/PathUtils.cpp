@@ -0,0 +1,155 @@
+//
+//  PathUtils.cpp
+//  RoBart
+//
+//  Created by Bart Trzynadlowski on 10/16/26.
+//
+//  This file is part of RoBart.
+//
+//  RoBart is free software: you can redistribute it and/or modify it under the
+//  terms of the GNU General Public License as published by the Free Software
+//  Foundation, either version 3 of the License, or (at your option) any later
+//  version.
+//
+//  RoBart is distributed in the hope that it will be useful, but WITHOUT
+//  ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+//  FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+//  more details.
+//
+//  You should have received a copy of the GNU General Public License along
+//  with RoBart. If not, see <http://www.gnu.org/licenses/>.
+//
+
+#include "PathUtils.hpp"
+#include <algorithm>
+
+/// Given a characteristic radius, determines the side length in cells of the rectangular area to assume as the footprint of the robot.
+/// For example, if the cell side length is 0.5 and the radius of the robot's footprint is 0.6, the result should be 3 (a 3x3 area needs
+/// to be checked because the robot will be overlapping up to that many cells).
+/// - Parameter occupancy: The occupancy map.
+/// - Parameter robotRadius: A characteristic robot radius that encompasses the robot's total footprint.
+/// - Returns: The side length of the rectangular region, in cells, to represent the robot with. This will be an odd number of at
+/// least 1.
+size_t computeFootprintSideLengthInCells(const OccupancyMap &occupancy, float robotRadius)
+{
+    if (occupancy.cellsWide() * occupancy.cellsDeep() <= 1)
+    {
+        // Pathological case of a single-celled map
+        return 1;
+    }
+
+    OccupancyMap::CellIndices center = occupancy.positionToCell(occupancy.centerPoint());
+    OccupancyMap::CellIndices limit = occupancy.positionToCell(occupancy.centerPoint() + simd_make_float3(robotRadius, 0, 0));
+    size_t cellsOut = limit.cellX - center.cellX;
+
+    // Side length is 1 (center cell) plus the number of cells out in either direction
+    return 1 + 2 * cellsOut;
+}
+
+/// Check whether we can move into a cell by overlaying a square approximation of the robot's footprint to ensure there are no collisions with nearby cells.
+/// - Parameter occupancy: The occupancy map.
+/// - Parameter cell: The cell we want to move in; the center of the region that will be checked.
+/// - Parameter robotFootprintSideLength: Side length in cell units of the square region with center at `cell` to check. Must be odd.
+/// - Returns: True if safe, otherwise false.
+bool isCellSafe(const OccupancyMap &occupancy, OccupancyMap::CellIndices cell, size_t robotFootprintSideLength)
+{
+    long delta = long(robotFootprintSideLength) / 2;    // note that length will be odd, so we can do this to create a [-delta,+delta] range
+    long cellXMin = std::max(long(0), long(cell.cellX) - delta);
+    long cellXMax = std::min(cell.cellX + delta, occupancy.cellsWide() - 1);
+    long cellZMin = std::max(long(0), long(cell.cellZ) - delta);
+    long cellZMax = std::min(cell.cellZ + delta, occupancy.cellsDeep() - 1);
+    for (size_t cellZ = cellZMin; cellZ <= cellZMax; cellZ++)
+    {
+        for (size_t cellX = cellXMin; cellX <= cellXMax; cellX++)
+        {
+            if (occupancy.at(cellX, cellZ) != 0)
+            {
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+/// Computes the Chebyshev distance (in cells) from every cell to the nearest obstacle, saturating at
+/// `maxDistance`. Obstacle cells have a distance of 0. Because the robot footprint is approximated as
+/// a square, a cell is safe exactly when its distance exceeds half the footprint side length, which
+/// turns the test performed by isCellSafe() into a single lookup. Like isCellSafe(), the map edges
+/// are not considered obstacles.
+/// - Parameter distances: Output array, indexed by `cellZ * cellsWide + cellX`.
+/// - Parameter occupancy: The occupancy map.
+/// - Parameter unknownObstacles: If not null, cells it has not observed are obstacles as well.
+/// - Parameter maxDistance: Distance beyond which we do not care to measure.
+void computeObstacleDistances(std::vector<uint16_t> *distances, const OccupancyMap &occupancy, const ElevationMap *unknownObstacles, uint16_t maxDistance)
+{
+    size_t cellsWide = occupancy.cellsWide();
+    size_t cellsDeep = occupancy.cellsDeep();
+    distances->assign(cellsWide * cellsDeep, maxDistance);
+
+    // Brushfire outwards from all obstacles simultaneously
+    std::vector<OccupancyMap::CellIndices> frontier;
+    std::vector<OccupancyMap::CellIndices> nextFrontier;
+    for (size_t cellZ = 0; cellZ < cellsDeep; cellZ++)
+    {
+        for (size_t cellX = 0; cellX < cellsWide; cellX++)
+        {
+            bool isUnknown = unknownObstacles != nullptr && !unknownObstacles->isObserved(OccupancyMap::CellIndices(cellX, cellZ));
+            if (occupancy.at(cellX, cellZ) != 0 || isUnknown)
+            {
+                (*distances)[cellZ * cellsWide + cellX] = 0;
+                frontier.emplace_back(cellX, cellZ);
+            }
+        }
+    }
+
+    for (uint16_t distance = 1; distance < maxDistance && !frontier.empty(); distance++)
+    {
+        nextFrontier.clear();
+        for (auto cell: frontier)
+        {
+            size_t cellXMin = cell.cellX > 0 ? cell.cellX - 1 : 0;
+            size_t cellXMax = std::min(cell.cellX + 1, cellsWide - 1);
+            size_t cellZMin = cell.cellZ > 0 ? cell.cellZ - 1 : 0;
+            size_t cellZMax = std::min(cell.cellZ + 1, cellsDeep - 1);
+            for (size_t cellZ = cellZMin; cellZ <= cellZMax; cellZ++)
+            {
+                for (size_t cellX = cellXMin; cellX <= cellXMax; cellX++)
+                {
+                    uint16_t &neighborDistance = (*distances)[cellZ * cellsWide + cellX];
+                    if (neighborDistance > distance)
+                    {
+                        neighborDistance = distance;
+                        nextFrontier.emplace_back(cellX, cellZ);
+                    }
+                }
+            }
+        }
+        std::swap(frontier, nextFrontier);
+    }
+}
+
+/// Reduces a path of adjacent cells to its end points and the cells at which the direction changes.
+std::vector<OccupancyMap::CellIndices> removeCollinearCells(const std::vector<OccupancyMap::CellIndices> &cells)
+{
+    if (cells.size() <= 2)
+    {
+        return cells;
+    }
+
+    std::vector<OccupancyMap::CellIndices> path;
+    path.emplace_back(cells.front());
+    for (size_t i = 1; i < cells.size() - 1; i++)
+    {
+        const OccupancyMap::CellIndices &prev = cells[i - 1];
+        const OccupancyMap::CellIndices &current = cells[i];
+        const OccupancyMap::CellIndices &next = cells[i + 1];
+        bool dirWillChange = (long(current.cellX) - long(prev.cellX)) != (long(next.cellX) - long(current.cellX)) ||
+                             (long(current.cellZ) - long(prev.cellZ)) != (long(next.cellZ) - long(current.cellZ));
+        if (dirWillChange)
+        {
+            path.emplace_back(current);
+        }
+    }
+    path.emplace_back(cells.back());
+    return path;
+}
@@ -0,0 +1,36 @@
+//
+//  PathUtils.hpp
+//  RoBart
+//
+//  Created by Bart Trzynadlowski on 10/16/26.
+//
+//  This file is part of RoBart.
+//
+//  RoBart is free software: you can redistribute it and/or modify it under the
+//  terms of the GNU General Public License as published by the Free Software
+//  Foundation, either version 3 of the License, or (at your option) any later
+//  version.
+//
+//  RoBart is distributed in the hope that it will be useful, but WITHOUT
+//  ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+//  FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+//  more details.
+//
+//  You should have received a copy of the GNU General Public License along
+//  with RoBart. If not, see <http://www.gnu.org/licenses/>.
+//
+
+#ifndef PathUtils_hpp
+#define PathUtils_hpp
+
+#include "ElevationMap.hpp"
+#include "OccupancyMap.hpp"
+#include <cstdint>
+#include <vector>
+
+extern size_t computeFootprintSideLengthInCells(const OccupancyMap &occupancy, float robotRadius);
+extern bool isCellSafe(const OccupancyMap &occupancy, OccupancyMap::CellIndices cell, size_t robotFootprintSideLength);
+extern void computeObstacleDistances(std::vector<uint16_t> *distances, const OccupancyMap &occupancy, const ElevationMap *unknownObstacles, uint16_t maxDistance);
+extern std::vector<OccupancyMap::CellIndices> removeCollinearCells(const std::vector<OccupancyMap::CellIndices> &cells);
+
+#endif /* PathUtils_hpp */
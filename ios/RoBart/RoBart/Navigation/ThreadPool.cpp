@@ -0,0 +1,191 @@
+//
+//  ThreadPool.cpp
+//  RoBart
+//
+//  Created by Bart Trzynadlowski on 10/16/26.
+//
+//  This file is part of RoBart.
+//
+//  RoBart is free software: you can redistribute it and/or modify it under the
+//  terms of the GNU General Public License as published by the Free Software
+//  Foundation, either version 3 of the License, or (at your option) any later
+//  version.
+//
+//  RoBart is distributed in the hope that it will be useful, but WITHOUT
+//  ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+//  FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+//  more details.
+//
+//  You should have received a copy of the GNU General Public License along
+//  with RoBart. If not, see <http://www.gnu.org/licenses/>.
+//
+
+#include "ThreadPool.hpp"
+#include <algorithm>
+#include <atomic>
+#include <memory>
+
+ThreadPool::ThreadPool(size_t numThreads)
+{
+    for (size_t i = 0; i < numThreads; i++)
+    {
+        _threads.emplace_back([this]() { workerLoop(); });
+    }
+}
+
+ThreadPool::~ThreadPool()
+{
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        _stopping = true;
+    }
+    _taskAvailable.notify_all();
+    for (std::thread &thread: _threads)
+    {
+        thread.join();
+    }
+}
+
+ThreadPool &ThreadPool::shared()
+{
+    static ThreadPool pool(std::max(1u, std::thread::hardware_concurrency()) - 1);
+    return pool;
+}
+
+void ThreadPool::enqueue(std::function<void()> task)
+{
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        pushTask(std::move(task));
+    }
+    _taskAvailable.notify_one();
+}
+
+void ThreadPool::parallelFor(size_t count, void (*invoke)(const void *context, size_t i), const void *context)
+{
+    if (count == 0)
+    {
+        return;
+    }
+
+    // Indices are claimed dynamically so uneven work balances itself. The caller participates,
+    // which also guarantees progress if every worker is busy with other tasks. Helpers are only
+    // enlisted for workers that are idle: any more would start after the loop has finished and
+    // just keep its state alive.
+    Loop *loop = acquireLoop();
+    loop->count = count;
+    loop->invoke = invoke;
+    loop->context = context;
+    loop->nextIndex = 0;
+    loop->numCompleted = 0;
+    size_t numHelpers = 0;
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        size_t numAvailable = _numIdleWorkers > _numTasks ? _numIdleWorkers - _numTasks : 0;
+        numHelpers = std::min(numAvailable, count - 1);
+        loop->numReferences = numHelpers + 1;
+
+        // The task captures only two pointers, which std::function stores without allocating
+        for (size_t i = 0; i < numHelpers; i++)
+        {
+            pushTask([this, loop]() { runLoop(loop); });
+        }
+    }
+    for (size_t i = 0; i < numHelpers; i++)
+    {
+        _taskAvailable.notify_one();
+    }
+
+    // Helpers that start late find no indices left and never touch invoke or context, so returning
+    // once every index has completed is safe
+    size_t numCompletedHere = 0;
+    for (size_t i = loop->nextIndex++; i < count; i = loop->nextIndex++)
+    {
+        invoke(context, i);
+        numCompletedHere++;
+    }
+    loop->numCompleted += numCompletedHere;
+    {
+        std::unique_lock<std::mutex> lock(loop->mutex);
+        loop->done.wait(lock, [&]() { return loop->numCompleted == count; });
+    }
+    releaseLoop(loop);
+}
+
+void ThreadPool::pushTask(std::function<void()> task)
+{
+    if (_numTasks == _tasks.size())
+    {
+        std::vector<std::function<void()>> tasks(std::max(size_t(16), 2 * _tasks.size()));
+        for (size_t i = 0; i < _numTasks; i++)
+        {
+            tasks[i] = std::move(_tasks[(_firstTask + i) % _tasks.size()]);
+        }
+        _tasks.swap(tasks);
+        _firstTask = 0;
+    }
+    _tasks[(_firstTask + _numTasks) % _tasks.size()] = std::move(task);
+    _numTasks++;
+}
+
+ThreadPool::Loop *ThreadPool::acquireLoop()
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+    if (_freeLoops.empty())
+    {
+        _loops.emplace_back(std::make_unique<Loop>());
+        _freeLoops.reserve(_loops.size());
+        return _loops.back().get();
+    }
+    Loop *loop = _freeLoops.back();
+    _freeLoops.pop_back();
+    return loop;
+}
+
+void ThreadPool::runLoop(Loop *loop)
+{
+    size_t numCompletedHere = 0;
+    for (size_t i = loop->nextIndex++; i < loop->count; i = loop->nextIndex++)
+    {
+        loop->invoke(loop->context, i);
+        numCompletedHere++;
+    }
+    if (numCompletedHere > 0 && (loop->numCompleted += numCompletedHere) == loop->count)
+    {
+        std::lock_guard<std::mutex> lock(loop->mutex);
+        loop->done.notify_all();
+    }
+    releaseLoop(loop);
+}
+
+void ThreadPool::releaseLoop(Loop *loop)
+{
+    if (--loop->numReferences == 0)
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        _freeLoops.push_back(loop);
+    }
+}
+
+void ThreadPool::workerLoop()
+{
+    while (true)
+    {
+        std::function<void()> task;
+        {
+            std::unique_lock<std::mutex> lock(_mutex);
+            _numIdleWorkers++;
+            _taskAvailable.wait(lock, [this]() { return _stopping || _numTasks > 0; });
+            _numIdleWorkers--;
+            if (_stopping && _numTasks == 0)
+            {
+                return;
+            }
+            task = std::move(_tasks[_firstTask]);
+            _tasks[_firstTask] = nullptr;
+            _firstTask = (_firstTask + 1) % _tasks.size();
+            _numTasks--;
+        }
+        task();
+    }
+}
@@ -0,0 +1,107 @@
+//
+//  ThreadPool.hpp
+//  RoBart
+//
+//  Created by Bart Trzynadlowski on 10/16/26.
+//
+//  This file is part of RoBart.
+//
+//  RoBart is free software: you can redistribute it and/or modify it under the
+//  terms of the GNU General Public License as published by the Free Software
+//  Foundation, either version 3 of the License, or (at your option) any later
+//  version.
+//
+//  RoBart is distributed in the hope that it will be useful, but WITHOUT
+//  ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+//  FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+//  more details.
+//
+//  You should have received a copy of the GNU General Public License along
+//  with RoBart. If not, see <http://www.gnu.org/licenses/>.
+//
+
+#ifndef ThreadPool_hpp
+#define ThreadPool_hpp
+
+#include <condition_variable>
+#include <cstddef>
+#include <atomic>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/// Fixed set of worker threads consuming a FIFO task queue.
+class ThreadPool
+{
+public:
+    ThreadPool(size_t numThreads);
+    ~ThreadPool();
+
+    ThreadPool(const ThreadPool &) = delete;
+    ThreadPool &operator=(const ThreadPool &) = delete;
+
+    /// Process-wide pool with one worker per additional hardware thread, for data-parallel work
+    /// that is not worth owning a pool for.
+    static ThreadPool &shared();
+
+    void enqueue(std::function<void()> task);
+
+    /// Calls fn(i) for each i in [0, count), distributing indices across the workers and the
+    /// calling thread, and returns when all calls have completed. Does not touch the heap once the
+    /// pool has run as many concurrent loops before, so per-frame stages may use it freely.
+    template <typename Fn>
+    void parallelFor(size_t count, const Fn &fn)
+    {
+        parallelFor(count, [](const void *context, size_t i) { (*static_cast<const Fn *>(context))(i); }, &fn);
+    }
+
+    void parallelFor(size_t count, void (*invoke)(const void *context, size_t i), const void *context);
+
+    size_t numThreads() const
+    {
+        return _threads.size();
+    }
+
+private:
+    // State of a parallelFor() loop, shared by the caller and the helpers it enqueued. Recycled
+    // once all of them have released it, since late helpers may still look at it after the
+    // caller has returned.
+    struct Loop
+    {
+        size_t count = 0;
+        void (*invoke)(const void *context, size_t i) = nullptr;
+        const void *context = nullptr;
+        std::atomic<size_t> nextIndex{ 0 };
+        std::atomic<size_t> numCompleted{ 0 };
+        std::atomic<size_t> numReferences{ 0 };
+        std::mutex mutex;
+        std::condition_variable done;
+    };
+
+    void workerLoop();
+    void pushTask(std::function<void()> task);
+    Loop *acquireLoop();
+    void runLoop(Loop *loop);
+    void releaseLoop(Loop *loop);
+
+    std::vector<std::thread> _threads;
+
+    // Ring buffer of pending tasks, which only grows, so that steady-state queueing does not
+    // allocate (unlike some std::deque implementations)
+    std::vector<std::function<void()>> _tasks;
+    size_t _firstTask = 0;
+    size_t _numTasks = 0;
+
+    std::mutex _mutex;
+    std::condition_variable _taskAvailable;
+    size_t _numIdleWorkers = 0;
+    bool _stopping = false;
+
+    // All loops ever created, and those not currently in use (guarded by _mutex)
+    std::vector<std::unique_ptr<Loop>> _loops;
+    std::vector<Loop *> _freeLoops;
+};
+
+#endif /* ThreadPool_hpp */
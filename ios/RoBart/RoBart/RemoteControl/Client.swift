@@ -244,12 +244,12 @@ class Client: ObservableObject {
                 if !msg.pathFinding {
                     NavigationController.shared.run(.follow(path: path))
                 } else {
-                    // Perform pathfinding between waypoints
+                    // Perform coarse pathfinding between waypoints for display. Segments are
+                    // refined as the robot advances.
                     var computedPath: [Vector3] = []
-                    let robotRadius = 0.5 * max(Calibration.robotBounds.x, Calibration.robotBounds.z)
                     var from = ARSessionManager.shared.transform.position
                     for to in path {
-                        let pathCells = findPath(NavigationController.shared.occupancy, from, to, robotRadius)
+                        let pathCells = NavigationController.shared.hierarchicalPathfinder.findPath(from, to, false)
                         let positions = pathCells.map { NavigationController.shared.occupancy.cellToPosition($0) }
                         computedPath += positions
                         from = to
@@ -271,7 +271,7 @@ class Client: ObservableObject {
                     send(responseMsg)
 
                     // Traverse
-                    NavigationController.shared.run(.follow(path: computedPath))
+                    NavigationController.shared.run(.followHierarchicalPath(through: path))
                 }
             }
 
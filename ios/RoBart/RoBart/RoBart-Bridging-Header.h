@@ -3,6 +3,18 @@
 //
 
 #include "FilterDepthMap.hpp"
+#include "DepthPointCloud.hpp"
 #include "OccupancyMap.hpp"
+#include "DynamicObstacleMap.hpp"
+#include "ElevationMap.hpp"
+#include "MeshOccupancyCache.hpp"
+#include "VoxelMap.hpp"
+#include "TSDFVolume.hpp"
+#include "FrameArena.hpp"
 #include "FindPath.hpp"
+#include "HierarchicalPathfinder.hpp"
+#include "DistanceField.hpp"
+#include "LatticePlanner.hpp"
 #include "HumanInstancing.hpp"
+#include "HumanTracker.hpp"
+#include "HumanPerceptionPipeline.hpp"
@@ -66,6 +66,28 @@ struct ContentView: View {
 //                            Button("Draw", action: { _depthTest.drawPoints() })
 //                                .padding()
 //                            Button("Path", action: { _depthTest.testPath() })
+//                                .padding()
+//                            Button("Bench", action: { _depthTest.benchmarkPathfinding() })
+//                                .padding()
+//                            Button("Humans", action: { _depthTest.benchmarkHumanInstancing() })
+//                                .padding()
+//                            Button("Tracker", action: { _depthTest.benchmarkHumanTracker() })
+//                                .padding()
+//                            Button("Box Depth", action: { _depthTest.benchmarkBoxDepth() })
+//                                .padding()
+//                            Button("Pipeline", action: { _depthTest.benchmarkHumanPerceptionPipeline() })
+//                                .padding()
+//                            Button("Record Meshes", action: { _depthTest.recordSceneMeshes() })
+//                                .padding()
+//                            Button("Mesh Bench", action: { _depthTest.benchmarkMeshOccupancy() })
+//                                .padding()
+//                            Button("Voxels", action: { _depthTest.benchmarkVoxelMap() })
+//                                .padding()
+//                            Button("TSDF", action: { _depthTest.benchmarkTSDF() })
+//                                .padding()
+//                            Button("Points", action: { _depthTest.benchmarkPointCloud() })
+//                                .padding()
+//                            Button("Arena", action: { _depthTest.checkFrameArenaAllocations() })
 //                                .padding()
                             Spacer()
                         }
@@ -879,6 +879,15 @@ void WebRtcSpl_Resample48khzTo8khz(const int16_t* in,
                                    WebRtcSpl_State48khzTo8khz* state,
                                    int32_t* tmpmem);
 
+// Reference implementation of WebRtcSpl_Resample48khzTo8khz(), running each
+// filter stage over the whole frame through `tmpmem` (496 samples).
+// WebRtcSpl_Resample48khzTo8khz() interleaves the stages in a single pass with
+// bit-exact results and doesn't use `tmpmem`.
+void WebRtcSpl_Resample48khzTo8khzC(const int16_t* in,
+                                    int16_t* out,
+                                    WebRtcSpl_State48khzTo8khz* state,
+                                    int32_t* tmpmem);
+
 void WebRtcSpl_ResetResample48khzTo8khz(WebRtcSpl_State48khzTo8khz* state);
 
 typedef struct {
@@ -99,9 +99,9 @@ void WebRtcSpl_ResetResample16khzTo48khz(WebRtcSpl_State16khzTo48khz* state)
 ///// 48 kHz ->  8 kHz /////
 ////////////////////////////
 
-// 48 -> 8 resampler
-void WebRtcSpl_Resample48khzTo8khz(const int16_t* in, int16_t* out,
-                                   WebRtcSpl_State48khzTo8khz* state, int32_t* tmpmem)
+// 48 -> 8 resampler, a stage at a time
+void WebRtcSpl_Resample48khzTo8khzC(const int16_t* in, int16_t* out,
+                                    WebRtcSpl_State48khzTo8khz* state, int32_t* tmpmem)
 {
     ///// 48 --> 24 /////
     // int16_t  in[480]
@@ -131,6 +131,151 @@ void WebRtcSpl_Resample48khzTo8khz(const int16_t* in, int16_t* out,
     WebRtcSpl_DownBy2IntToShort(tmpmem, 160, out, state->S_16_8);
 }
 
+// 48 -> 8 resampler, in a single pass
+//
+// Runs the stages of WebRtcSpl_Resample48khzTo8khzC() interleaved, 12 input
+// samples (two output samples) at a time, with the filter states held in
+// locals rather than in `state` and `tmpmem`. The result, including the state
+// left for the next frame, is bit-exact with the staged version. `tmpmem` is
+// unused.
+void WebRtcSpl_Resample48khzTo8khz(const int16_t* in, int16_t* out,
+                                   WebRtcSpl_State48khzTo8khz* state, int32_t* tmpmem)
+{
+    int32_t s_48_24[2][4];
+    int32_t s_16_8[2][4];
+    // the last 8 low-passed 24 kHz samples, then the 6 of the current block
+    int32_t buf_24[14];
+    int32_t prev_24;
+    int32_t tmp;
+    size_t block;
+    int i, k;
+#if defined(WEBRTC_SPL_VECTOR_RESAMPLER)
+    const WebRtcSpl_Int32x4 coef_24_24[3] = {
+        {kResampleAllpass[1][0], kResampleAllpass[0][0],
+         kResampleAllpass[1][0], kResampleAllpass[0][0]},
+        {kResampleAllpass[1][1], kResampleAllpass[0][1],
+         kResampleAllpass[1][1], kResampleAllpass[0][1]},
+        {kResampleAllpass[1][2], kResampleAllpass[0][2],
+         kResampleAllpass[1][2], kResampleAllpass[0][2]}
+    };
+    WebRtcSpl_Int32x4 s_24_24[4];
+    WebRtcSpl_Int32x4 x, y;
+
+    for (k = 0; k < 4; k++)
+    {
+        for (i = 0; i < 4; i++)
+            s_24_24[i][k] = state->S_24_24[4 * k + i];
+    }
+#else
+    int32_t s_24_24[4][4];
+
+    memcpy(s_24_24, state->S_24_24, 16 * sizeof(int32_t));
+#endif
+    (void)tmpmem;
+
+    memcpy(s_48_24, state->S_48_24, 8 * sizeof(int32_t));
+    memcpy(s_16_8, state->S_16_8, 8 * sizeof(int32_t));
+    memcpy(buf_24, state->S_24_16, 8 * sizeof(int32_t));
+    prev_24 = state->S_24_24[12];
+
+    for (block = 0; block < 40; block++)
+    {
+        int32_t down_24[6];
+        int32_t out_16[4];
+
+        ///// 48 --> 24 /////
+        // lower allpass filter on even, upper on odd input samples
+        for (i = 0; i < 6; i++)
+        {
+            WebRtcSpl_AllpassStep(((int32_t)in[2 * i] << 15) + (1 << 14),
+                                  kResampleAllpass[1], s_48_24[0]);
+            WebRtcSpl_AllpassStep(((int32_t)in[2 * i + 1] << 15) + (1 << 14),
+                                  kResampleAllpass[0], s_48_24[1]);
+            down_24[i] = (int32_t)((uint32_t)(s_48_24[0][3] >> 1) +
+                                   (uint32_t)(s_48_24[1][3] >> 1));
+        }
+        in += 12;
+
+        ///// 24 --> 24(LP) /////
+        // see WebRtcSpl_LPBy2IntToInt()
+        for (i = 0; i < 3; i++)
+        {
+#if defined(WEBRTC_SPL_VECTOR_RESAMPLER)
+            x = (WebRtcSpl_Int32x4){prev_24, down_24[2 * i], down_24[2 * i],
+                                    down_24[2 * i + 1]};
+            WebRtcSpl_AllpassStepX4(x, coef_24_24, s_24_24);
+            y = s_24_24[3] >> 1;
+            buf_24[8 + 2 * i] = (int32_t)((uint32_t)y[0] + (uint32_t)y[1]) >> 15;
+            buf_24[9 + 2 * i] = (int32_t)((uint32_t)y[2] + (uint32_t)y[3]) >> 15;
+#else
+            WebRtcSpl_AllpassStep(prev_24, kResampleAllpass[1],
+                                  s_24_24[0]);
+            WebRtcSpl_AllpassStep(down_24[2 * i], kResampleAllpass[0],
+                                  s_24_24[1]);
+            WebRtcSpl_AllpassStep(down_24[2 * i], kResampleAllpass[1],
+                                  s_24_24[2]);
+            WebRtcSpl_AllpassStep(down_24[2 * i + 1],
+                                  kResampleAllpass[0], s_24_24[3]);
+            buf_24[8 + 2 * i] = (int32_t)((uint32_t)(s_24_24[0][3] >> 1) +
+                                          (uint32_t)(s_24_24[1][3] >> 1)) >> 15;
+            buf_24[9 + 2 * i] = (int32_t)((uint32_t)(s_24_24[2][3] >> 1) +
+                                          (uint32_t)(s_24_24[3][3] >> 1)) >> 15;
+#endif
+            prev_24 = down_24[2 * i + 1];
+        }
+
+        ///// 24 --> 16 /////
+        // see WebRtcSpl_Resample48khzTo32khz()
+        for (i = 0; i < 2; i++)
+        {
+            uint32_t sum0 = 1 << 14;
+            uint32_t sum1 = 1 << 14;
+
+            for (k = 0; k < 8; k++)
+            {
+                sum0 += (uint32_t)(kCoefficients48To32[0][k] *
+                                   buf_24[3 * i + k]);
+                sum1 += (uint32_t)(kCoefficients48To32[1][k] *
+                                   buf_24[3 * i + k + 1]);
+            }
+            out_16[2 * i] = (int32_t)sum0;
+            out_16[2 * i + 1] = (int32_t)sum1;
+        }
+        memmove(buf_24, buf_24 + 6, 8 * sizeof(int32_t));
+
+        ///// 16 --> 8 /////
+        // see WebRtcSpl_DownBy2IntToShort()
+        for (i = 0; i < 2; i++)
+        {
+            WebRtcSpl_AllpassStep(out_16[2 * i], kResampleAllpass[1],
+                                  s_16_8[0]);
+            WebRtcSpl_AllpassStep(out_16[2 * i + 1],
+                                  kResampleAllpass[0], s_16_8[1]);
+            tmp = (int32_t)((uint32_t)(s_16_8[0][3] >> 1) +
+                            (uint32_t)(s_16_8[1][3] >> 1)) >> 15;
+            if (tmp > (int32_t)0x00007FFF)
+                tmp = 0x00007FFF;
+            if (tmp < (int32_t)0xFFFF8000)
+                tmp = 0xFFFF8000;
+            out[i] = (int16_t)tmp;
+        }
+        out += 2;
+    }
+
+    memcpy(state->S_48_24, s_48_24, 8 * sizeof(int32_t));
+    memcpy(state->S_16_8, s_16_8, 8 * sizeof(int32_t));
+    memcpy(state->S_24_16, buf_24, 8 * sizeof(int32_t));
+#if defined(WEBRTC_SPL_VECTOR_RESAMPLER)
+    for (k = 0; k < 4; k++)
+    {
+        for (i = 0; i < 4; i++)
+            state->S_24_24[4 * k + i] = s_24_24[i][k];
+    }
+#else
+    memcpy(state->S_24_24, s_24_24, 16 * sizeof(int32_t));
+#endif
+}
+
 // initialize state of 48 -> 8 resampler
 void WebRtcSpl_ResetResample48khzTo8khz(WebRtcSpl_State48khzTo8khz* state)
 {
@@ -17,12 +17,6 @@
 #include "common_audio/signal_processing/resample_by_2_internal.h"
 #include "rtc_base/sanitizer.h"
 
-// allpass filter coefficients.
-static const int16_t kResampleAllpass[2][3] = {
-        {821, 6110, 12382},
-        {3050, 9368, 15063}
-};
-
 //
 //   decimator
 // input:  int32_t (shifted 15 positions to the left, + offset 16384) OVERWRITTEN!
@@ -557,8 +551,8 @@ void WebRtcSpl_LPBy2ShortToInt(const int16_t* in, int32_t len, int32_t* out,
 // output: int32_t (normalized, not saturated)
 // state:  filter state array; length = 8
 void RTC_NO_SANITIZE("signed-integer-overflow")  // bugs.webrtc.org/5486
-WebRtcSpl_LPBy2IntToInt(const int32_t* in, int32_t len, int32_t* out,
-                        int32_t* state)
+WebRtcSpl_LPBy2IntToIntC(const int32_t* in, int32_t len, int32_t* out,
+                         int32_t* state)
 {
     int32_t tmp0, tmp1, diff;
     int32_t i;
@@ -687,3 +681,62 @@ WebRtcSpl_LPBy2IntToInt(const int32_t* in, int32_t len, int32_t* out,
         out[i << 1] = (out[i << 1] + (state[15] >> 1)) >> 15;
     }
 }
+
+#if defined(WEBRTC_SPL_VECTOR_RESAMPLER)
+//   lowpass filter
+// The four allpass filters of WebRtcSpl_LPBy2IntToIntC() run side by side in
+// vector lanes, lane k holding state[4 * k] to state[4 * k + 3]: lanes 0 and 1
+// make the even output samples, lanes 2 and 3 the odd ones.
+void WebRtcSpl_LPBy2IntToInt(const int32_t* in, int32_t len, int32_t* out,
+                             int32_t* state)
+{
+    const WebRtcSpl_Int32x4 coef[3] = {
+        {kResampleAllpass[1][0], kResampleAllpass[0][0],
+         kResampleAllpass[1][0], kResampleAllpass[0][0]},
+        {kResampleAllpass[1][1], kResampleAllpass[0][1],
+         kResampleAllpass[1][1], kResampleAllpass[0][1]},
+        {kResampleAllpass[1][2], kResampleAllpass[0][2],
+         kResampleAllpass[1][2], kResampleAllpass[0][2]}
+    };
+    WebRtcSpl_Int32x4 lanes[4];
+    WebRtcSpl_Int32x4 x, y;
+    int32_t prev;
+    int32_t i;
+    int k;
+
+    for (k = 0; k < 4; k++)
+    {
+        for (i = 0; i < 4; i++)
+            lanes[i][k] = state[4 * k + i];
+    }
+
+    len >>= 1;
+
+    // the lower filter of the even output samples runs one input behind
+    prev = state[12];
+    for (i = 0; i < len; i++)
+    {
+        x = (WebRtcSpl_Int32x4){prev, in[i << 1], in[i << 1],
+                                in[(i << 1) + 1]};
+        WebRtcSpl_AllpassStepX4(x, coef, lanes);
+        prev = in[(i << 1) + 1];
+
+        // average the two allpass outputs of each output sample
+        y = lanes[3] >> 1;
+        out[i << 1] = (int32_t)((uint32_t)y[0] + (uint32_t)y[1]) >> 15;
+        out[(i << 1) + 1] = (int32_t)((uint32_t)y[2] + (uint32_t)y[3]) >> 15;
+    }
+
+    for (k = 0; k < 4; k++)
+    {
+        for (i = 0; i < 4; i++)
+            state[4 * k + i] = lanes[i][k];
+    }
+}
+#else
+void WebRtcSpl_LPBy2IntToInt(const int32_t* in, int32_t len, int32_t* out,
+                             int32_t* state)
+{
+    WebRtcSpl_LPBy2IntToIntC(in, len, out, state);
+}
+#endif  // defined(WEBRTC_SPL_VECTOR_RESAMPLER)
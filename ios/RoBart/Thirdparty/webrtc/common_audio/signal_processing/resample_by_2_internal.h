@@ -18,6 +18,85 @@
 
 #include <stdint.h>
 
+#if (defined(__GNUC__) || defined(__clang__)) && \
+    !defined(WEBRTC_SPL_DISABLE_VECTOR_RESAMPLER)
+#define WEBRTC_SPL_VECTOR_RESAMPLER
+typedef int32_t WebRtcSpl_Int32x4 __attribute__((vector_size(16)));
+typedef uint32_t WebRtcSpl_Uint32x4 __attribute__((vector_size(16)));
+#endif
+
+// allpass filter coefficients. Defined here rather than extern so that the
+// single pass 48 -> 8 kHz resampler can fold them into its multiplies.
+static const int16_t kResampleAllpass[2][3] = {
+        {821, 6110, 12382},
+        {3050, 9368, 15063}
+};
+
+// interpolation coefficients of WebRtcSpl_Resample48khzTo32khz()
+static const int16_t kCoefficients48To32[2][8] = {
+        {778, -2050, 1087, 23285, 12903, -3783, 441, 222},
+        {222, 441, -3783, 12903, 23285, 1087, -2050, 778}
+};
+
+// Runs one sample `in` through a three-section allpass filter with
+// coefficients `coef` and state `state[4]`, leaving the output in state[3].
+// Arithmetic wraps like the filter loops in resample_by_2_internal.c, so that
+// results are bit-exact with them.
+static __inline void WebRtcSpl_AllpassStep(int32_t in,
+                                           const int16_t* coef,
+                                           int32_t* state) {
+  int32_t diff, tmp0, tmp1;
+
+  // scale down and round
+  diff = (int32_t)((uint32_t)in - (uint32_t)state[1]);
+  diff = (int32_t)((uint32_t)diff + (1 << 13)) >> 14;
+  tmp1 = (int32_t)((uint32_t)state[0] + (uint32_t)(diff * coef[0]));
+  state[0] = in;
+  // scale down and truncate
+  diff = (int32_t)((uint32_t)tmp1 - (uint32_t)state[2]);
+  diff = (diff >> 14) + (int32_t)((uint32_t)diff >> 31);
+  tmp0 = (int32_t)((uint32_t)state[1] + (uint32_t)(diff * coef[1]));
+  state[1] = tmp1;
+  // scale down and truncate
+  diff = (int32_t)((uint32_t)tmp0 - (uint32_t)state[3]);
+  diff = (diff >> 14) + (int32_t)((uint32_t)diff >> 31);
+  state[3] = (int32_t)((uint32_t)state[2] + (uint32_t)(diff * coef[2]));
+  state[2] = tmp0;
+}
+
+#if defined(WEBRTC_SPL_VECTOR_RESAMPLER)
+// WebRtcSpl_AllpassStep() for four independent filters, one per lane.
+// `coef[k]` holds the k-th coefficient of each filter.
+static __inline void WebRtcSpl_AllpassStepX4(WebRtcSpl_Int32x4 in,
+                                             const WebRtcSpl_Int32x4* coef,
+                                             WebRtcSpl_Int32x4* state) {
+  WebRtcSpl_Int32x4 diff, tmp0, tmp1;
+
+  diff = (WebRtcSpl_Int32x4)((WebRtcSpl_Uint32x4)in -
+                             (WebRtcSpl_Uint32x4)state[1]);
+  diff = (WebRtcSpl_Int32x4)((WebRtcSpl_Uint32x4)diff + (1 << 13)) >> 14;
+  tmp1 = (WebRtcSpl_Int32x4)((WebRtcSpl_Uint32x4)state[0] +
+                             (WebRtcSpl_Uint32x4)diff *
+                                 (WebRtcSpl_Uint32x4)coef[0]);
+  state[0] = in;
+  diff = (WebRtcSpl_Int32x4)((WebRtcSpl_Uint32x4)tmp1 -
+                             (WebRtcSpl_Uint32x4)state[2]);
+  // Comparisons yield -1 in true lanes.
+  diff = (diff >> 14) - (diff < 0);
+  tmp0 = (WebRtcSpl_Int32x4)((WebRtcSpl_Uint32x4)state[1] +
+                             (WebRtcSpl_Uint32x4)diff *
+                                 (WebRtcSpl_Uint32x4)coef[1]);
+  state[1] = tmp1;
+  diff = (WebRtcSpl_Int32x4)((WebRtcSpl_Uint32x4)tmp0 -
+                             (WebRtcSpl_Uint32x4)state[3]);
+  diff = (diff >> 14) - (diff < 0);
+  state[3] = (WebRtcSpl_Int32x4)((WebRtcSpl_Uint32x4)state[2] +
+                                 (WebRtcSpl_Uint32x4)diff *
+                                     (WebRtcSpl_Uint32x4)coef[2]);
+  state[2] = tmp0;
+}
+#endif  // defined(WEBRTC_SPL_VECTOR_RESAMPLER)
+
 /*******************************************************************
  * resample_by_2_fast.c
  * Functions for internal use in the other resample functions
@@ -57,4 +136,13 @@ void WebRtcSpl_LPBy2IntToInt(const int32_t* in,
                              int32_t* out,
                              int32_t* state);
 
+// Scalar implementation of WebRtcSpl_LPBy2IntToInt(). Where the compiler
+// supports vector extensions (WEBRTC_SPL_VECTOR_RESAMPLER),
+// WebRtcSpl_LPBy2IntToInt() instead runs its four allpass filters in parallel
+// vector lanes, with bit-exact results.
+void WebRtcSpl_LPBy2IntToIntC(const int32_t* in,
+                              int32_t len,
+                              int32_t* out,
+                              int32_t* state);
+
 #endif  // COMMON_AUDIO_SIGNAL_PROCESSING_RESAMPLE_BY_2_INTERNAL_H_
@@ -16,13 +16,9 @@
  */
 
 #include "common_audio/signal_processing/include/signal_processing_library.h"
+#include "common_audio/signal_processing/resample_by_2_internal.h"
 
 // interpolation coefficients
-static const int16_t kCoefficients48To32[2][8] = {
-        {778, -2050, 1087, 23285, 12903, -3783, 441, 222},
-        {222, 441, -3783, 12903, 23285, 1087, -2050, 778}
-};
-
 static const int16_t kCoefficients32To24[3][8] = {
         {767, -2362, 2434, 24406, 10620, -3838, 721, 90},
         {386, -381, -2646, 19062, 19062, -2646, -381, 386},
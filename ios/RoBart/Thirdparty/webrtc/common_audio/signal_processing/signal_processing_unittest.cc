@@ -0,0 +1,113 @@
+//
+//  signal_processing_unittest.cc
+//  RoBart
+//
+//  Created by Bart Trzynadlowski on 10/16/26.
+//
+//  This file is part of RoBart.
+//
+//  RoBart is free software: you can redistribute it and/or modify it under the
+//  terms of the GNU General Public License as published by the Free Software
+//  Foundation, either version 3 of the License, or (at your option) any later
+//  version.
+//
+//  RoBart is distributed in the hope that it will be useful, but WITHOUT
+//  ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+//  FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+//  more details.
+//
+//  You should have received a copy of the GNU General Public License along
+//  with RoBart. If not, see <http://www.gnu.org/licenses/>.
+//
+
+#include <stdint.h>
+#include <string.h>
+
+#include <algorithm>
+
+#include "common_audio/signal_processing/include/signal_processing_library.h"
+#include "test/gtest.h"
+
+extern "C" {
+#include "common_audio/signal_processing/resample_by_2_internal.h"
+}
+
+namespace webrtc {
+namespace test {
+
+namespace {
+
+// Fills `frame` with uniform noise scaled by `amplitude` / 32768, saturated to
+// 16 bits. Amplitudes above 32768 produce mostly full-scale samples.
+void FillNoise(uint32_t* seed, int amplitude, int16_t* frame, size_t length) {
+  for (size_t i = 0; i < length; ++i) {
+    *seed = *seed * 1664525 + 1013904223;
+    int32_t sample = static_cast<int32_t>(*seed >> 16) - 32768;
+    sample = sample * amplitude / 32768;
+    frame[i] = static_cast<int16_t>(
+        std::max(-32768, std::min(32767, static_cast<int>(sample))));
+  }
+}
+
+}  // namespace
+
+TEST(SplTest, Resample48khzTo8khzMatchesStaged) {
+  int16_t in[480];
+  int16_t out[80];
+  int16_t reference_out[80];
+  int32_t tmpmem[496];
+  WebRtcSpl_State48khzTo8khz state;
+  WebRtcSpl_State48khzTo8khz reference_state;
+  WebRtcSpl_ResetResample48khzTo8khz(&state);
+  WebRtcSpl_ResetResample48khzTo8khz(&reference_state);
+
+  // Noise of increasing loudness up to clipping, then full-scale square waves
+  // at several periods, which drive the filters into saturation and wrap
+  // around. State carries over from frame to frame.
+  uint32_t seed = 4711;
+  for (int frame = 0; frame < 300; ++frame) {
+    if (frame < 240) {
+      FillNoise(&seed, 1 << (frame / 12), in, 480);
+    } else {
+      int period = 2 + frame % 7;
+      for (size_t i = 0; i < 480; ++i) {
+        in[i] = (i / period) % 2 ? 32767 : -32768;
+      }
+    }
+    WebRtcSpl_Resample48khzTo8khzC(in, reference_out, &reference_state,
+                                   tmpmem);
+    WebRtcSpl_Resample48khzTo8khz(in, out, &state, tmpmem);
+    ASSERT_EQ(0, memcmp(reference_out, out, sizeof(out))) << "frame " << frame;
+    ASSERT_EQ(0, memcmp(&reference_state, &state, sizeof(state)))
+        << "frame " << frame;
+  }
+}
+
+TEST(SplTest, LPBy2IntToIntMatchesScalar) {
+  int32_t in[240];
+  int32_t out[240];
+  int32_t reference_out[240];
+  int32_t state[16] = {0};
+  int32_t reference_state[16] = {0};
+
+  // Arbitrary 32-bit input, including the extremes, exercises the wrapping
+  // arithmetic of the filters.
+  uint32_t seed = 1234;
+  for (int frame = 0; frame < 100; ++frame) {
+    for (size_t i = 0; i < 240; ++i) {
+      seed = seed * 1664525 + 1013904223;
+      in[i] = static_cast<int32_t>(seed) >> (frame % 16);
+      if (frame % 10 == 9) {
+        in[i] = i % 2 ? INT32_MAX : INT32_MIN;
+      }
+    }
+    WebRtcSpl_LPBy2IntToIntC(in, 240, reference_out, reference_state);
+    WebRtcSpl_LPBy2IntToInt(in, 240, out, state);
+    ASSERT_EQ(0, memcmp(reference_out, out, sizeof(out))) << "frame " << frame;
+    ASSERT_EQ(0, memcmp(reference_state, state, sizeof(state)))
+        << "frame " << frame;
+  }
+}
+
+}  // namespace test
+}  // namespace webrtc
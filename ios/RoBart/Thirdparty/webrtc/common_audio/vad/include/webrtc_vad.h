@@ -80,6 +80,62 @@ int WebRtcVad_Process(VadInst* handle,
 // returns            : 0 - (valid combination), -1 - (invalid combination)
 int WebRtcVad_ValidRateAndFrameLength(int rate, size_t frame_length);
 
+// Batched VAD: `num_streams` independent VAD instances advanced together,
+// one frame of every stream per call. The instances are stored
+// structure-of-arrays so that the filter bank and the GMM run across streams
+// in vector lanes. Decisions are identical to running each stream through its
+// own VadInst. Streams are vectorized eight at a time; the remainder of
+// `num_streams` past a multiple of eight runs at the cost of separate VadInsts.
+typedef struct WebRtcVadBatchInst VadBatchInst;
+
+// Creates a batched VAD for `num_streams` streams.
+//
+// returns : The instance, or NULL if `num_streams` is 0 or allocation failed.
+VadBatchInst* WebRtcVad_CreateBatch(size_t num_streams);
+
+// Frees the dynamic memory of a batched VAD.
+//
+// - handle [i] : Pointer to batched VAD instance that should be freed.
+void WebRtcVad_FreeBatch(VadBatchInst* handle);
+
+// Initializes every stream of a batched VAD, like WebRtcVad_Init().
+//
+// - handle [i/o] : Instance that should be initialized.
+//
+// returns        : 0 - (OK),
+//                 -1 - (null pointer).
+int WebRtcVad_InitBatch(VadBatchInst* handle);
+
+// Sets the operating mode of one stream, like WebRtcVad_set_mode().
+//
+// - handle [i/o] : Batched VAD instance.
+// - stream [i]   : Index of the stream, less than `num_streams`.
+// - mode   [i]   : Aggressiveness mode (0, 1, 2, or 3).
+//
+// returns        : 0 - (OK),
+//                 -1 - (null pointer, invalid stream or mode, or the instance
+//                       has not been initialized).
+int WebRtcVad_set_mode_batch(VadBatchInst* handle, size_t stream, int mode);
+
+// Calculates a VAD decision for one frame of each stream. All frames share
+// the sampling frequency and length, with the combinations accepted by
+// WebRtcVad_Process().
+//
+// - handle        [i/o] : Batched VAD instance. Needs to be initialized by
+//                         WebRtcVad_InitBatch() before call.
+// - fs            [i]   : Sampling frequency (Hz): 8000, 16000, 32000 or 48000
+// - audio_frames  [i]   : `num_streams` audio frame buffers.
+// - frame_length  [i]   : Length of each audio frame buffer in samples.
+// - vad_decisions [o]   : `num_streams` decisions, 1 - (Active Voice) or
+//                         0 - (Non-active Voice).
+//
+// returns               : 0 - (OK), -1 - (Error)
+int WebRtcVad_ProcessBatch(VadBatchInst* handle,
+                           int fs,
+                           const int16_t* const* audio_frames,
+                           size_t frame_length,
+                           int* vad_decisions);
+
 #ifdef __cplusplus
 }
 #endif
@@ -0,0 +1,391 @@
+//
+//  vad_benchmark.cc
+//  RoBart
+//
+//  Created by Bart Trzynadlowski on 10/16/26.
+//
+//  This file is part of RoBart.
+//
+//  RoBart is free software: you can redistribute it and/or modify it under the
+//  terms of the GNU General Public License as published by the Free Software
+//  Foundation, either version 3 of the License, or (at your option) any later
+//  version.
+//
+//  RoBart is distributed in the hope that it will be useful, but WITHOUT
+//  ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+//  FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+//  more details.
+//
+//  You should have received a copy of the GNU General Public License along
+//  with RoBart. If not, see <http://www.gnu.org/licenses/>.
+//
+
+
+// Measures the cost of WebRtcVad_Process() on long audio at each supported
+// sample rate. Audio is read from a 16-bit PCM WAV file given on the command
+// line (first channel only) or, without one, synthesized: alternating voiced
+// segments (harmonics of a wandering pitch, amplitude modulated at a syllabic
+// rate) and background noise. The source is linearly resampled to each rate
+// before timing.
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <chrono>
+#include <cmath>
+#include <string>
+#include <vector>
+
+#include "common_audio/signal_processing/include/signal_processing_library.h"
+#include "common_audio/vad/include/webrtc_vad.h"
+
+extern "C" {
+#include "common_audio/vad/vad_core.h"
+#include "common_audio/vad/vad_filterbank.h"
+}
+
+namespace {
+
+constexpr int kRates[] = {8000, 16000, 32000, 48000};
+constexpr int kMode = 2;
+constexpr double kSyntheticSeconds = 600.0;
+constexpr int kSyntheticRate = 48000;
+
+struct Audio {
+  std::vector<int16_t> samples;
+  int rate = 0;
+};
+
+uint32_t ReadLittleEndian(const uint8_t* bytes, int size) {
+  uint32_t value = 0;
+  for (int i = size - 1; i >= 0; --i) {
+    value = (value << 8) | bytes[i];
+  }
+  return value;
+}
+
+bool LoadWav(const char* path, Audio* audio) {
+  FILE* file = fopen(path, "rb");
+  if (!file) {
+    fprintf(stderr, "Error: Unable to open %s\n", path);
+    return false;
+  }
+  std::vector<uint8_t> bytes;
+  uint8_t buffer[65536];
+  size_t num_read;
+  while ((num_read = fread(buffer, 1, sizeof(buffer), file)) > 0) {
+    bytes.insert(bytes.end(), buffer, buffer + num_read);
+  }
+  fclose(file);
+
+  if (bytes.size() < 12 || memcmp(&bytes[0], "RIFF", 4) != 0 ||
+      memcmp(&bytes[8], "WAVE", 4) != 0) {
+    fprintf(stderr, "Error: %s is not a WAV file\n", path);
+    return false;
+  }
+
+  int num_channels = 0;
+  int bits_per_sample = 0;
+  size_t offset = 12;
+  while (offset + 8 <= bytes.size()) {
+    const uint8_t* chunk = &bytes[offset];
+    size_t chunk_size = ReadLittleEndian(chunk + 4, 4);
+    size_t available = std::min(chunk_size, bytes.size() - offset - 8);
+    if (memcmp(chunk, "fmt ", 4) == 0 && available >= 16) {
+      num_channels = ReadLittleEndian(chunk + 10, 2);
+      audio->rate = ReadLittleEndian(chunk + 12, 4);
+      bits_per_sample = ReadLittleEndian(chunk + 22, 2);
+    } else if (memcmp(chunk, "data", 4) == 0) {
+      if (bits_per_sample != 16 || num_channels < 1) {
+        fprintf(stderr, "Error: %s is not 16-bit PCM\n", path);
+        return false;
+      }
+      size_t num_frames = available / (2 * num_channels);
+      audio->samples.resize(num_frames);
+      for (size_t i = 0; i < num_frames; ++i) {
+        audio->samples[i] = static_cast<int16_t>(
+            ReadLittleEndian(chunk + 8 + 2 * num_channels * i, 2));
+      }
+      return true;
+    }
+    offset += 8 + chunk_size + (chunk_size & 1);
+  }
+  fprintf(stderr, "Error: %s has no audio data\n", path);
+  return false;
+}
+
+void Synthesize(Audio* audio) {
+  audio->rate = kSyntheticRate;
+  audio->samples.resize(static_cast<size_t>(kSyntheticSeconds * kSyntheticRate));
+  uint32_t seed = 1;
+  double phase = 0;
+  for (size_t i = 0; i < audio->samples.size(); ++i) {
+    double t = static_cast<double>(i) / kSyntheticRate;
+    seed = seed * 1664525 + 1013904223;
+    double noise = (static_cast<double>(seed >> 8) / (1 << 24) - 0.5) * 200;
+
+    // Two seconds of "speech" alternating with two seconds of noise
+    double value = noise;
+    if (static_cast<int>(t / 2) % 2 == 0) {
+      double pitch = 140 + 40 * std::sin(2 * M_PI * 0.7 * t);
+      phase += 2 * M_PI * pitch / kSyntheticRate;
+      double envelope = 0.5 + 0.5 * std::sin(2 * M_PI * 4 * t);
+      double voiced = 0;
+      for (int harmonic = 1; harmonic <= 12; ++harmonic) {
+        voiced += std::sin(harmonic * phase) / harmonic;
+      }
+      value += 6000 * envelope * voiced;
+    }
+    audio->samples[i] = static_cast<int16_t>(
+        std::max(-32768.0, std::min(32767.0, value)));
+  }
+}
+
+std::vector<int16_t> Resample(const Audio& audio, int rate) {
+  if (rate == audio.rate) {
+    return audio.samples;
+  }
+  size_t num_samples = audio.samples.size() * static_cast<uint64_t>(rate) /
+                       static_cast<uint64_t>(audio.rate);
+  std::vector<int16_t> resampled(num_samples);
+  double step = static_cast<double>(audio.rate) / rate;
+  for (size_t i = 0; i < num_samples; ++i) {
+    double position = i * step;
+    size_t index = static_cast<size_t>(position);
+    double fraction = position - index;
+    int16_t a = audio.samples[index];
+    int16_t b = index + 1 < audio.samples.size() ? audio.samples[index + 1] : a;
+    resampled[i] = static_cast<int16_t>(std::lround(a + fraction * (b - a)));
+  }
+  return resampled;
+}
+
+// Times the feature extraction alone on 10 ms frames of 8 kHz audio, which is
+// what every rate is reduced to before it.
+void BenchmarkFilterbank(const Audio& audio) {
+  std::vector<int16_t> samples = Resample(audio, 8000);
+  constexpr size_t kFrameLength = 80;
+  size_t num_frames = samples.size() / kFrameLength;
+  int16_t features[kNumChannels];
+
+  struct Variant {
+    const char* name;
+    int16_t (*calculate)(VadInstT*, const int16_t*, size_t, int16_t*);
+  };
+  const Variant variants[] = {
+      {"scalar", WebRtcVad_CalculateFeaturesC},
+      {"default", WebRtcVad_CalculateFeatures},
+  };
+  // Best of several passes, as a single pass is short enough to be skewed by
+  // scheduling noise.
+  constexpr int kNumPasses = 5;
+  for (const Variant& variant : variants) {
+    double best = 0.0;
+    int32_t checksum = 0;
+    for (int pass = 0; pass < kNumPasses; ++pass) {
+      VadInstT self;
+      WebRtcVad_InitCore(&self);
+      checksum = 0;
+      auto start = std::chrono::steady_clock::now();
+      for (size_t i = 0; i < num_frames; ++i) {
+        checksum += variant.calculate(&self, &samples[i * kFrameLength],
+                                      kFrameLength, features);
+        checksum += features[0];
+      }
+      auto end = std::chrono::steady_clock::now();
+      double elapsed = std::chrono::duration<double>(end - start).count();
+      if (pass == 0 || elapsed < best) {
+        best = elapsed;
+      }
+    }
+    printf("Filterbank (%s): %.1f ns/frame, checksum %d\n", variant.name,
+           1e9 * best / num_frames, checksum);
+  }
+}
+
+// Times the 48 kHz -> 8 kHz resampler used by the VAD at 48 kHz, staged and
+// single pass, on the same frames, and counts frames on which they differ.
+void BenchmarkResampler(const Audio& audio) {
+  std::vector<int16_t> samples = Resample(audio, 48000);
+  constexpr size_t kFrameLength = 480;
+  size_t num_frames = samples.size() / kFrameLength;
+  std::vector<int16_t> outputs[2];
+  int32_t tmpmem[496];
+
+  struct Variant {
+    const char* name;
+    void (*resample)(const int16_t*, int16_t*, WebRtcSpl_State48khzTo8khz*,
+                     int32_t*);
+  };
+  const Variant variants[] = {
+      {"staged", WebRtcSpl_Resample48khzTo8khzC},
+      {"single pass", WebRtcSpl_Resample48khzTo8khz},
+  };
+  constexpr int kNumPasses = 5;
+  for (size_t v = 0; v < 2; ++v) {
+    double best = 0.0;
+    outputs[v].resize(num_frames * 80);
+    for (int pass = 0; pass < kNumPasses; ++pass) {
+      WebRtcSpl_State48khzTo8khz state;
+      WebRtcSpl_ResetResample48khzTo8khz(&state);
+      auto start = std::chrono::steady_clock::now();
+      for (size_t i = 0; i < num_frames; ++i) {
+        variants[v].resample(&samples[i * kFrameLength], &outputs[v][i * 80],
+                             &state, tmpmem);
+      }
+      auto end = std::chrono::steady_clock::now();
+      double elapsed = std::chrono::duration<double>(end - start).count();
+      if (pass == 0 || elapsed < best) {
+        best = elapsed;
+      }
+    }
+    printf("Resample 48 -> 8 kHz (%s): %.1f ns/frame\n", variants[v].name,
+           1e9 * best / num_frames);
+  }
+
+  size_t mismatches = 0;
+  for (size_t i = 0; i < num_frames; ++i) {
+    mismatches += memcmp(&outputs[0][i * 80], &outputs[1][i * 80],
+                         80 * sizeof(int16_t)) != 0;
+  }
+  printf("Resample 48 -> 8 kHz: %zu mismatched frames\n", mismatches);
+}
+
+// Compares N streams run through N independent VadInsts with the same streams
+// run through one batched VAD. Stream s is the audio rotated by s * 37 s, so
+// the streams differ but are statistically alike.
+void BenchmarkBatch(const Audio& audio) {
+  constexpr size_t kStreamCounts[] = {1, 2, 4, 8, 16, 32};
+  constexpr size_t kMaxFramesPerStream = 6000;
+  constexpr double kStreamOffsetSeconds = 37.0;
+
+  for (int rate : kRates) {
+    std::vector<int16_t> samples = Resample(audio, rate);
+    size_t frame_length = static_cast<size_t>(rate / 100);
+    size_t num_frames =
+        std::min(samples.size() / frame_length, kMaxFramesPerStream);
+    size_t stream_offset =
+        static_cast<size_t>(kStreamOffsetSeconds * rate) % samples.size();
+
+    for (size_t num_streams : kStreamCounts) {
+      std::vector<std::vector<int16_t>> streams(num_streams);
+      for (size_t s = 0; s < num_streams; ++s) {
+        size_t start = (s * stream_offset) % samples.size();
+        streams[s].resize(num_frames * frame_length);
+        for (size_t n = 0; n < streams[s].size(); ++n) {
+          streams[s][n] = samples[(start + n) % samples.size()];
+        }
+      }
+
+      std::vector<VadInst*> handles(num_streams);
+      for (size_t s = 0; s < num_streams; ++s) {
+        handles[s] = WebRtcVad_Create();
+        WebRtcVad_Init(handles[s]);
+        WebRtcVad_set_mode(handles[s], kMode);
+      }
+      VadBatchInst* batch = WebRtcVad_CreateBatch(num_streams);
+      WebRtcVad_InitBatch(batch);
+      for (size_t s = 0; s < num_streams; ++s) {
+        WebRtcVad_set_mode_batch(batch, s, kMode);
+      }
+
+      std::vector<int> independent(num_frames * num_streams);
+      auto start = std::chrono::steady_clock::now();
+      for (size_t i = 0; i < num_frames; ++i) {
+        for (size_t s = 0; s < num_streams; ++s) {
+          independent[i * num_streams + s] = WebRtcVad_Process(
+              handles[s], rate, &streams[s][i * frame_length], frame_length);
+        }
+      }
+      auto end = std::chrono::steady_clock::now();
+      double independent_elapsed =
+          std::chrono::duration<double>(end - start).count();
+
+      std::vector<int> batched(num_frames * num_streams);
+      std::vector<const int16_t*> frames(num_streams);
+      start = std::chrono::steady_clock::now();
+      for (size_t i = 0; i < num_frames; ++i) {
+        for (size_t s = 0; s < num_streams; ++s) {
+          frames[s] = &streams[s][i * frame_length];
+        }
+        WebRtcVad_ProcessBatch(batch, rate, frames.data(), frame_length,
+                               &batched[i * num_streams]);
+      }
+      end = std::chrono::steady_clock::now();
+      double batched_elapsed =
+          std::chrono::duration<double>(end - start).count();
+
+      size_t mismatches = 0;
+      for (size_t i = 0; i < independent.size(); ++i) {
+        mismatches += independent[i] != batched[i];
+      }
+      for (VadInst* handle : handles) {
+        WebRtcVad_Free(handle);
+      }
+      WebRtcVad_FreeBatch(batch);
+
+      double stream_frames = static_cast<double>(num_frames * num_streams);
+      printf(
+          "Batch %5d Hz, %2zu streams: independent %.1f ns/stream-frame, "
+          "batched %.1f ns/stream-frame (%.2fx), %zu mismatches\n",
+          rate, num_streams, 1e9 * independent_elapsed / stream_frames,
+          1e9 * batched_elapsed / stream_frames,
+          independent_elapsed / batched_elapsed, mismatches);
+    }
+  }
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  Audio audio;
+  std::string source = "synthetic";
+  if (argc > 1) {
+    if (!LoadWav(argv[1], &audio)) {
+      return 1;
+    }
+    source = argv[1];
+  } else {
+    Synthesize(&audio);
+  }
+  double seconds = static_cast<double>(audio.samples.size()) / audio.rate;
+  printf("Source: %s, %.1f s at %d Hz, mode %d\n", source.c_str(), seconds,
+         audio.rate, kMode);
+
+  for (int rate : kRates) {
+    std::vector<int16_t> samples = Resample(audio, rate);
+    size_t frame_length = static_cast<size_t>(rate / 100);
+    size_t num_frames = samples.size() / frame_length;
+
+    VadInst* vad = WebRtcVad_Create();
+    if (!vad || WebRtcVad_Init(vad) != 0 || WebRtcVad_set_mode(vad, kMode) != 0) {
+      fprintf(stderr, "Error: Unable to create VAD\n");
+      return 1;
+    }
+
+    size_t num_active = 0;
+    auto start = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < num_frames; ++i) {
+      int result =
+          WebRtcVad_Process(vad, rate, &samples[i * frame_length], frame_length);
+      num_active += result == 1;
+    }
+    auto end = std::chrono::steady_clock::now();
+    WebRtcVad_Free(vad);
+
+    double elapsed = std::chrono::duration<double>(end - start).count();
+    double audio_seconds = static_cast<double>(num_frames) / 100;
+    printf(
+        "%5d Hz: %zu frames, %.1f ns/frame, real-time factor %.2e "
+        "(%.0fx real time), %.1f%% active\n",
+        rate, num_frames, 1e9 * elapsed / num_frames, elapsed / audio_seconds,
+        audio_seconds / elapsed, 100.0 * num_active / num_frames);
+  }
+
+  BenchmarkFilterbank(audio);
+  BenchmarkResampler(audio);
+  BenchmarkBatch(audio);
+  return 0;
+}
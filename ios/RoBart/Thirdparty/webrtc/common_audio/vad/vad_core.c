@@ -683,3 +683,434 @@ int WebRtcVad_CalcVad8khz(VadInstT* inst, const int16_t* speech_frame,
 
     return inst->vad;
 }
+
+// GmmProbability() for each lane of `self`, with bit-exact results. Every
+// branch on a lane's data becomes a select between the values of both paths,
+// so that each loop over the lanes runs the same instructions for all of them.
+// Lanes whose `total_power` is too low compute the model update too, but keep
+// their old state.
+//
+// - self           [i/o] : Lanes of VAD instances
+// - features       [i]   : `kNumChannels` * `kNumLanes` features, channel c of
+//                          lane l at [c * kNumLanes + l]
+// - total_power    [i]   : `kNumLanes` total powers
+// - frame_length   [i]   : Number of input samples
+//
+// Writes the VAD decision of each lane to `self->vad`.
+static void GmmProbabilityLanes(VadLanesT* self, const int16_t* features,
+                                const int16_t* total_power,
+                                size_t frame_length) {
+  int channel, k, lane, gaussian;
+  int frame_index;
+  int16_t maxspe;
+  int16_t active[kNumLanes];
+  int16_t vadflag[kNumLanes] = { 0 };
+  int16_t feature_minimum[kNumLanes];
+  int16_t deltaN[kTableSize][kNumLanes], deltaS[kTableSize][kNumLanes];
+  int16_t ngprvec[kTableSize][kNumLanes];
+  int16_t sgprvec[kTableSize][kNumLanes];
+  int32_t h0_test[kNumLanes], h1_test[kNumLanes];
+  int32_t noise_probability[kNumLanes], speech_probability[kNumLanes];
+  int32_t probability[kNumLanes];
+  int32_t sum_log_likelihood_ratios[kNumLanes] = { 0 };
+  int32_t noise_global_mean[kNumLanes];
+
+  // Thresholds based on frame lengths (80, 160 or 240 samples).
+  if (frame_length == 80) {
+    frame_index = 0;
+  } else if (frame_length == 160) {
+    frame_index = 1;
+  } else {
+    frame_index = 2;
+  }
+
+  for (lane = 0; lane < kNumLanes; lane++) {
+    active[lane] = total_power[lane] > kMinEnergy;
+  }
+
+  // Likelihood of speech and the VAD decision, see GmmProbability().
+  for (channel = 0; channel < kNumChannels; channel++) {
+    const int16_t* feature = &features[channel * kNumLanes];
+
+    for (lane = 0; lane < kNumLanes; lane++) {
+      h0_test[lane] = 0;
+      h1_test[lane] = 0;
+    }
+    for (k = 0; k < kNumGaussians; k++) {
+      gaussian = channel + k * kNumChannels;
+      WebRtcVad_GaussianProbabilityLanes(feature, self->noise_means[gaussian],
+                                         self->noise_stds[gaussian],
+                                         deltaN[gaussian], probability);
+      for (lane = 0; lane < kNumLanes; lane++) {
+        int32_t weighted = kNoiseDataWeights[gaussian] * probability[lane];
+        noise_probability[lane] = k == 0 ? weighted : noise_probability[lane];
+        h0_test[lane] += weighted;  // Q27
+      }
+      WebRtcVad_GaussianProbabilityLanes(feature, self->speech_means[gaussian],
+                                         self->speech_stds[gaussian],
+                                         deltaS[gaussian], probability);
+      for (lane = 0; lane < kNumLanes; lane++) {
+        int32_t weighted = kSpeechDataWeights[gaussian] * probability[lane];
+        speech_probability[lane] = k == 0 ? weighted : speech_probability[lane];
+        h1_test[lane] += weighted;  // Q27
+      }
+    }
+
+    for (lane = 0; lane < kNumLanes; lane++) {
+      int16_t shifts_h0, shifts_h1, log_likelihood_ratio, h0, h1;
+      int32_t tmp1_s32;
+
+      shifts_h0 = h0_test[lane] == 0 ? 31 : WebRtcSpl_NormW32(h0_test[lane]);
+      shifts_h1 = h1_test[lane] == 0 ? 31 : WebRtcSpl_NormW32(h1_test[lane]);
+      log_likelihood_ratio = shifts_h0 - shifts_h1;
+      sum_log_likelihood_ratios[lane] +=
+          (int32_t) (log_likelihood_ratio * kSpectrumWeight[channel]);
+      if ((log_likelihood_ratio * 4) > self->individual[frame_index][lane]) {
+        vadflag[lane] = 1;
+      }
+
+      // Conditional probabilities of the two Gaussians, for the GMM update.
+      h0 = (int16_t) (h0_test[lane] >> 12);  // Q15
+      tmp1_s32 = (noise_probability[lane] & 0xFFFFF000) << 2;  // Q29
+      tmp1_s32 = (int16_t) WebRtcVad_DivW32W16Lane(tmp1_s32, h0);  // Q14
+      ngprvec[channel][lane] = h0 > 0 ? (int16_t) tmp1_s32 : 16384;
+      ngprvec[channel + kNumChannels][lane] =
+          h0 > 0 ? (int16_t) (16384 - tmp1_s32) : 0;
+
+      h1 = (int16_t) (h1_test[lane] >> 12);  // Q15
+      tmp1_s32 = (speech_probability[lane] & 0xFFFFF000) << 2;  // Q29
+      tmp1_s32 = (int16_t) WebRtcVad_DivW32W16Lane(tmp1_s32, h1);  // Q14
+      sgprvec[channel][lane] = h1 > 0 ? (int16_t) tmp1_s32 : 0;
+      sgprvec[channel + kNumChannels][lane] =
+          h1 > 0 ? (int16_t) (16384 - tmp1_s32) : 0;
+    }
+  }
+
+  // Make a global VAD decision. Lanes without enough power are noise.
+  for (lane = 0; lane < kNumLanes; lane++) {
+    vadflag[lane] |= (sum_log_likelihood_ratios[lane] >=
+                      self->total[frame_index][lane]);
+    vadflag[lane] = active[lane] ? vadflag[lane] : 0;
+  }
+
+  // Update the model parameters.
+  maxspe = 12800;
+  for (channel = 0; channel < kNumChannels; channel++) {
+    const int16_t* feature = &features[channel * kNumLanes];
+    const int16_t noise_weight0 = kNoiseDataWeights[channel];
+    const int16_t noise_weight1 = kNoiseDataWeights[channel + kNumChannels];
+    const int16_t speech_weight0 = kSpeechDataWeights[channel];
+    const int16_t speech_weight1 = kSpeechDataWeights[channel + kNumChannels];
+    int16_t* noise_means0 = self->noise_means[channel];
+    int16_t* noise_means1 = self->noise_means[channel + kNumChannels];
+    int16_t* speech_means0 = self->speech_means[channel];
+    int16_t* speech_means1 = self->speech_means[channel + kNumChannels];
+
+    // Get minimum value in past which is used for long term correction in Q4.
+    // The sorted insertion doesn't vectorize and runs lane by lane.
+    for (lane = 0; lane < kNumLanes; lane++) {
+      feature_minimum[lane] = active[lane] ?
+          WebRtcVad_FindMinimumLane(self, lane, feature[lane], channel) : 0;
+    }
+
+    for (lane = 0; lane < kNumLanes; lane++) {
+      noise_global_mean[lane] = noise_means0[lane] * noise_weight0 +
+                                noise_means1[lane] * noise_weight1;
+    }
+
+    for (k = 0; k < kNumGaussians; k++) {
+      gaussian = channel + k * kNumChannels;
+
+      for (lane = 0; lane < kNumLanes; lane++) {
+        int16_t nmk = self->noise_means[gaussian][lane];
+        int16_t smk = self->speech_means[gaussian][lane];
+        int16_t nsk = self->noise_stds[gaussian][lane];
+        int16_t ssk = self->speech_stds[gaussian][lane];
+        int16_t tmp1_s16 = (int16_t) (noise_global_mean[lane] >> 6);  // Q8
+        int16_t nmk2, nmk3, smk2, ndelt, delt, maxmu, tmp_s16, quotient;
+        int16_t speech_ssk, noise_nsk;
+        int32_t tmp1_s32, tmp2_s32;
+
+        // Noise mean, updated with the frame only if it is noise.
+        delt = (int16_t)((ngprvec[gaussian][lane] * deltaN[gaussian][lane]) >>
+                         11);
+        nmk2 = nmk + (int16_t)((delt * kNoiseUpdateConst) >> 22);
+        nmk2 = vadflag[lane] ? nmk : nmk2;
+
+        // Long term correction of the noise mean.
+        ndelt = (feature_minimum[lane] << 4) - tmp1_s16;
+        nmk3 = nmk2 + (int16_t)((ndelt * kBackEta) >> 9);
+        tmp_s16 = (int16_t) ((k + 5) << 7);
+        nmk3 = nmk3 < tmp_s16 ? tmp_s16 : nmk3;
+        tmp_s16 = (int16_t) ((72 + k - channel) << 7);
+        nmk3 = nmk3 > tmp_s16 ? tmp_s16 : nmk3;
+
+        // Speech mean and standard deviation, if the frame is speech.
+        delt = (int16_t)((sgprvec[gaussian][lane] * deltaS[gaussian][lane]) >>
+                         11);
+        tmp_s16 = (int16_t)((delt * kSpeechUpdateConst) >> 21);
+        smk2 = smk + ((tmp_s16 + 1) >> 1);
+        maxmu = maxspe + 640;
+        smk2 = smk2 < kMinimumMean[k] ? kMinimumMean[k] : smk2;
+        smk2 = smk2 > maxmu ? maxmu : smk2;
+
+        tmp_s16 = ((smk + 4) >> 3);
+        tmp_s16 = feature[lane] - tmp_s16;  // Q4
+        tmp1_s32 = (deltaS[gaussian][lane] * tmp_s16) >> 3;
+        tmp2_s32 = tmp1_s32 - 4096;
+        tmp_s16 = sgprvec[gaussian][lane] >> 2;
+        tmp1_s32 = tmp_s16 * tmp2_s32;
+        tmp2_s32 = tmp1_s32 >> 4;  // Q20
+        quotient = (int16_t) WebRtcVad_DivW32W16Lane(
+            tmp2_s32 > 0 ? tmp2_s32 : -tmp2_s32, (int16_t) (ssk * 10));
+        tmp_s16 = tmp2_s32 > 0 ? quotient : (int16_t) -quotient;
+        tmp_s16 += 128;  // Rounding.
+        speech_ssk = ssk + (tmp_s16 >> 8);
+        speech_ssk = speech_ssk < kMinStd ? kMinStd : speech_ssk;
+
+        // Noise standard deviation, if the frame is noise.
+        tmp_s16 = feature[lane] - (nmk >> 3);
+        tmp1_s32 = (deltaN[gaussian][lane] * tmp_s16) >> 3;
+        tmp1_s32 -= 4096;
+        tmp_s16 = (ngprvec[gaussian][lane] + 2) >> 2;
+        tmp2_s32 = OverflowingMulS16ByS32ToS32(tmp_s16, tmp1_s32);
+        tmp1_s32 = tmp2_s32 >> 14;
+        quotient = (int16_t) WebRtcVad_DivW32W16Lane(
+            tmp1_s32 > 0 ? tmp1_s32 : -tmp1_s32, nsk);
+        tmp_s16 = tmp1_s32 > 0 ? quotient : (int16_t) -quotient;
+        tmp_s16 += 32;  // Rounding
+        noise_nsk = nsk + (tmp_s16 >> 6);
+        noise_nsk = noise_nsk < kMinStd ? kMinStd : noise_nsk;
+
+        if (!active[lane]) {
+          nmk3 = nmk;
+        }
+        self->noise_means[gaussian][lane] = nmk3;
+        self->speech_means[gaussian][lane] =
+            active[lane] && vadflag[lane] ? smk2 : smk;
+        self->speech_stds[gaussian][lane] =
+            active[lane] && vadflag[lane] ? speech_ssk : ssk;
+        self->noise_stds[gaussian][lane] =
+            active[lane] && !vadflag[lane] ? noise_nsk : nsk;
+      }
+    }
+
+    // Separate models if they are too close, and control that the speech and
+    // noise means do not drift to much. Moving a mean by zero leaves it, and
+    // the global means derived from it, unchanged.
+    maxspe = kMaximumSpeech[channel];
+    for (lane = 0; lane < kNumLanes; lane++) {
+      int16_t diff, tmp_s16, speech_offset, noise_offset;
+      int32_t noise_mean, speech_mean;
+
+      noise_mean = noise_means0[lane] * noise_weight0 +
+                   noise_means1[lane] * noise_weight1;
+      speech_mean = speech_means0[lane] * speech_weight0 +
+                    speech_means1[lane] * speech_weight1;
+      diff = (int16_t) (speech_mean >> 9) - (int16_t) (noise_mean >> 9);
+      tmp_s16 = kMinimumDifference[channel] - diff;
+      speech_offset = diff < kMinimumDifference[channel] ?
+          (int16_t)((13 * tmp_s16) >> 2) : 0;
+      noise_offset = diff < kMinimumDifference[channel] ?
+          (int16_t)((3 * tmp_s16) >> 2) : 0;
+      speech_offset = active[lane] ? speech_offset : 0;
+      noise_offset = active[lane] ? noise_offset : 0;
+      speech_means0[lane] += speech_offset;
+      speech_means1[lane] += speech_offset;
+      noise_means0[lane] -= noise_offset;
+      noise_means1[lane] -= noise_offset;
+      speech_mean = speech_means0[lane] * speech_weight0 +
+                    speech_means1[lane] * speech_weight1;
+      noise_mean = noise_means0[lane] * noise_weight0 +
+                   noise_means1[lane] * noise_weight1;
+
+      tmp_s16 = (int16_t) (speech_mean >> 7);
+      tmp_s16 = tmp_s16 > maxspe ? (int16_t) (tmp_s16 - maxspe) : 0;
+      tmp_s16 = active[lane] ? tmp_s16 : 0;
+      speech_means0[lane] -= tmp_s16;
+      speech_means1[lane] -= tmp_s16;
+
+      tmp_s16 = (int16_t) (noise_mean >> 7);
+      tmp_s16 = tmp_s16 > kMaximumNoise[channel] ?
+          (int16_t) (tmp_s16 - kMaximumNoise[channel]) : 0;
+      tmp_s16 = active[lane] ? tmp_s16 : 0;
+      noise_means0[lane] -= tmp_s16;
+      noise_means1[lane] -= tmp_s16;
+    }
+  }
+
+  // Smooth with respect to transition hysteresis.
+  for (lane = 0; lane < kNumLanes; lane++) {
+    int16_t over_hang = self->over_hang[lane];
+    int16_t num_of_speech = self->num_of_speech[lane] + 1;
+
+    self->frame_counter[lane] += active[lane];
+    if (!vadflag[lane]) {
+      vadflag[lane] = over_hang > 0 ? 2 + over_hang : 0;
+      self->over_hang[lane] = over_hang > 0 ? over_hang - 1 : over_hang;
+      self->num_of_speech[lane] = 0;
+    } else {
+      self->over_hang[lane] = num_of_speech > kMaxSpeechFrames ?
+          self->over_hang_max_2[frame_index][lane] :
+          self->over_hang_max_1[frame_index][lane];
+      self->num_of_speech[lane] = num_of_speech > kMaxSpeechFrames ?
+          kMaxSpeechFrames : num_of_speech;
+    }
+    self->vad[lane] = vadflag[lane];
+  }
+}
+
+int WebRtcVad_InitCoreLanes(VadLanesT* self) {
+  VadInstT inst;
+  int lane;
+
+  if (self == NULL) {
+    return -1;
+  }
+
+  // Every lane starts out as a freshly initialized single instance.
+  if (WebRtcVad_InitCore(&inst) != 0) {
+    return -1;
+  }
+  memset(self, 0, sizeof(*self));
+  for (lane = 0; lane < kNumLanes; lane++) {
+    int i;
+
+    self->vad[lane] = (int16_t) inst.vad;
+    self->state_48_to_8[lane] = inst.state_48_to_8;
+    for (i = 0; i < kTableSize; i++) {
+      self->noise_means[i][lane] = inst.noise_means[i];
+      self->speech_means[i][lane] = inst.speech_means[i];
+      self->noise_stds[i][lane] = inst.noise_stds[i];
+      self->speech_stds[i][lane] = inst.speech_stds[i];
+    }
+    memcpy(self->index_vector[lane], inst.index_vector,
+           sizeof(inst.index_vector));
+    memcpy(self->low_value_vector[lane], inst.low_value_vector,
+           sizeof(inst.low_value_vector));
+    for (i = 0; i < kNumChannels; i++) {
+      self->mean_value[i][lane] = inst.mean_value[i];
+    }
+    for (i = 0; i < 3; i++) {
+      self->over_hang_max_1[i][lane] = inst.over_hang_max_1[i];
+      self->over_hang_max_2[i][lane] = inst.over_hang_max_2[i];
+      self->individual[i][lane] = inst.individual[i];
+      self->total[i][lane] = inst.total[i];
+    }
+  }
+
+  return 0;
+}
+
+int WebRtcVad_set_mode_core_lanes(VadLanesT* self, int lane, int mode) {
+  VadInstT inst;
+  int i;
+
+  if (self == NULL || lane < 0 || lane >= kNumLanes) {
+    return -1;
+  }
+  if (WebRtcVad_set_mode_core(&inst, mode) != 0) {
+    return -1;
+  }
+  for (i = 0; i < 3; i++) {
+    self->over_hang_max_1[i][lane] = inst.over_hang_max_1[i];
+    self->over_hang_max_2[i][lane] = inst.over_hang_max_2[i];
+    self->individual[i][lane] = inst.individual[i];
+    self->total[i][lane] = inst.total[i];
+  }
+
+  return 0;
+}
+
+// Makes the VAD decisions of all lanes from 8 kHz frames interleaved by lane.
+static void CalcVad8khzInterleaved(VadLanesT* inst, const int16_t* speech,
+                                   size_t frame_length) {
+  int16_t feature_vector[kNumChannels * kNumLanes];
+  int16_t total_power[kNumLanes];
+
+  WebRtcVad_CalculateFeaturesLanes(inst, speech, frame_length, feature_vector,
+                                   total_power);
+  GmmProbabilityLanes(inst, feature_vector, total_power, frame_length);
+}
+
+// Interleaves `frame_length` samples of each lane's frame, sample n of lane l
+// going to [n * kNumLanes + l].
+static void Interleave(const int16_t* const* frames, size_t frame_length,
+                       int16_t* interleaved) {
+  size_t i;
+  int lane;
+
+  for (i = 0; i < frame_length; i++) {
+    for (lane = 0; lane < kNumLanes; lane++) {
+      interleaved[i * kNumLanes + lane] = frames[lane][i];
+    }
+  }
+}
+
+void WebRtcVad_CalcVad48khzLanes(VadLanesT* inst,
+                                 const int16_t* const* speech_frames,
+                                 size_t frame_length) {
+  size_t i;
+  int lane;
+  int16_t speech_nb[kNumLanes][240];  // 30 ms in 8 kHz.
+  const int16_t* speech_nb_ptrs[kNumLanes];
+  int16_t speech_interleaved[240 * kNumLanes];
+  int32_t tmp_mem[480 + 256] = { 0 };
+  const size_t kFrameLen10ms48khz = 480;
+  const size_t kFrameLen10ms8khz = 80;
+  size_t num_10ms_frames = frame_length / kFrameLen10ms48khz;
+
+  // The resampler's state is per lane, as in WebRtcVad_CalcVad48khz().
+  for (lane = 0; lane < kNumLanes; lane++) {
+    for (i = 0; i < num_10ms_frames; i++) {
+      WebRtcSpl_Resample48khzTo8khz(speech_frames[lane],
+                                    &speech_nb[lane][i * kFrameLen10ms8khz],
+                                    &inst->state_48_to_8[lane],
+                                    tmp_mem);
+    }
+    speech_nb_ptrs[lane] = speech_nb[lane];
+  }
+
+  Interleave(speech_nb_ptrs, frame_length / 6, speech_interleaved);
+  CalcVad8khzInterleaved(inst, speech_interleaved, frame_length / 6);
+}
+
+void WebRtcVad_CalcVad32khzLanes(VadLanesT* inst,
+                                 const int16_t* const* speech_frames,
+                                 size_t frame_length) {
+  int16_t speech_swb[960 * kNumLanes];  // 30 ms in SWB.
+  int16_t speech_wb[480 * kNumLanes];
+  int16_t speech_nb[240 * kNumLanes];
+
+  // Downsample signal 32->16->8 before doing VAD.
+  Interleave(speech_frames, frame_length, speech_swb);
+  WebRtcVad_DownsamplingLanes(speech_swb, speech_wb,
+                              inst->downsampling_filter_states[2],
+                              frame_length);
+  WebRtcVad_DownsamplingLanes(speech_wb, speech_nb,
+                              inst->downsampling_filter_states[0],
+                              frame_length / 2);
+  CalcVad8khzInterleaved(inst, speech_nb, frame_length / 4);
+}
+
+void WebRtcVad_CalcVad16khzLanes(VadLanesT* inst,
+                                 const int16_t* const* speech_frames,
+                                 size_t frame_length) {
+  int16_t speech_wb[480 * kNumLanes];  // 30 ms in WB.
+  int16_t speech_nb[240 * kNumLanes];
+
+  Interleave(speech_frames, frame_length, speech_wb);
+  WebRtcVad_DownsamplingLanes(speech_wb, speech_nb,
+                              inst->downsampling_filter_states[0],
+                              frame_length);
+  CalcVad8khzInterleaved(inst, speech_nb, frame_length / 2);
+}
+
+void WebRtcVad_CalcVad8khzLanes(VadLanesT* inst,
+                                const int16_t* const* speech_frames,
+                                size_t frame_length) {
+  int16_t speech_nb[240 * kNumLanes];
+
+  Interleave(speech_frames, frame_length, speech_nb);
+  CalcVad8khzInterleaved(inst, speech_nb, frame_length);
+}
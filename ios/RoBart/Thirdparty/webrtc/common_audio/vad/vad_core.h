@@ -30,6 +30,8 @@ CONSTEXPR_INT(
 CONSTEXPR_INT(kTableSize = kNumChannels * kNumGaussians);
 CONSTEXPR_INT(
     kMinEnergy = 10);  // Minimum energy required to trigger audio signal.
+CONSTEXPR_INT(
+    kNumLanes = 8);  // Number of streams advanced together by VadLanesT.
 
 typedef struct VadInstT_ {
   int vad;
@@ -59,6 +61,53 @@ typedef struct VadInstT_ {
   int init_flag;
 } VadInstT;
 
+// State of `kNumLanes` independent VADs laid out structure-of-arrays: each
+// field of VadInstT becomes an array indexed by lane last, so that one loop
+// over the lanes advances every stream with the same instructions. The
+// minimum tracking of WebRtcVad_FindMinimum() inserts into sorted lists in a
+// data dependent way and keeps a per-lane layout instead.
+typedef struct VadLanesT_ {
+  int16_t vad[kNumLanes];
+  int32_t downsampling_filter_states[4][kNumLanes];
+  WebRtcSpl_State48khzTo8khz state_48_to_8[kNumLanes];
+  int16_t noise_means[kTableSize][kNumLanes];
+  int16_t speech_means[kTableSize][kNumLanes];
+  int16_t noise_stds[kTableSize][kNumLanes];
+  int16_t speech_stds[kTableSize][kNumLanes];
+  int32_t frame_counter[kNumLanes];
+  int16_t over_hang[kNumLanes];
+  int16_t num_of_speech[kNumLanes];
+  int16_t index_vector[kNumLanes][16 * kNumChannels];
+  int16_t low_value_vector[kNumLanes][16 * kNumChannels];
+  int16_t mean_value[kNumChannels][kNumLanes];
+  int16_t upper_state[5][kNumLanes];
+  int16_t lower_state[5][kNumLanes];
+  int16_t hp_filter_state[4][kNumLanes];
+  int16_t over_hang_max_1[3][kNumLanes];
+  int16_t over_hang_max_2[3][kNumLanes];
+  int16_t individual[3][kNumLanes];
+  int16_t total[3][kNumLanes];
+} VadLanesT;
+
+// The hot loops over lanes are written with GCC/Clang vector extensions, which
+// compile to SSE or NEON regardless of how well the auto-vectorizer copes with
+// them; elsewhere they are plain loops.
+#if (defined(__GNUC__) || defined(__clang__)) && \
+    !defined(WEBRTC_VAD_DISABLE_VECTOR_LANES)
+#define WEBRTC_VAD_VECTOR_LANES
+
+typedef int16_t VadInt16xL __attribute__((vector_size(2 * kNumLanes)));
+typedef int32_t VadInt32xL __attribute__((vector_size(4 * kNumLanes)));
+typedef uint32_t VadUint32xL __attribute__((vector_size(4 * kNumLanes)));
+typedef float VadFloatxL __attribute__((vector_size(4 * kNumLanes)));
+
+// Truncates each lane of a VadInt32xL to 16 bits and sign extends it back,
+// the lane equivalent of storing to an int16_t. A macro rather than a function
+// since vectors this wide aren't passed in registers without AVX.
+#define WEBRTC_VAD_WRAP_INT16_LANES(x) \
+  ((VadInt32xL) ((VadUint32xL) (x) << 16) >> 16)
+#endif
+
 // Initializes the core VAD component. The default aggressiveness mode is
 // controlled by `kDefaultMode` in vad_core.c.
 //
@@ -120,4 +169,50 @@ int WebRtcVad_CalcVad8khz(VadInstT* inst,
                           const int16_t* speech_frame,
                           size_t frame_length);
 
+// Initializes every lane of `self` like WebRtcVad_InitCore().
+//
+// - self [i/o] : Lanes that should be initialized
+//
+// returns      : 0 (OK), -1 (null pointer in)
+int WebRtcVad_InitCoreLanes(VadLanesT* self);
+
+// Sets the aggressiveness `mode` of a single `lane`, like
+// WebRtcVad_set_mode_core().
+//
+// returns      : 0 (OK), -1 (invalid mode or lane)
+int WebRtcVad_set_mode_core_lanes(VadLanesT* self, int lane, int mode);
+
+/****************************************************************************
+ * WebRtcVad_CalcVad48khzLanes(...)
+ * WebRtcVad_CalcVad32khzLanes(...)
+ * WebRtcVad_CalcVad16khzLanes(...)
+ * WebRtcVad_CalcVad8khzLanes(...)
+ *
+ * Batched WebRtcVad_CalcVad48khz() etc.: makes a VAD decision for one frame
+ * of each lane's stream. The results are bit-exact with running every lane
+ * through the single-stream functions.
+ *
+ * Input:
+ *      - inst          : Lanes, initialized by WebRtcVad_InitCoreLanes()
+ *      - speech_frames : `kNumLanes` input speech frames, one per lane
+ *      - frame_length  : Number of input samples in each frame
+ *
+ * Output:
+ *      - inst          : Updated filter states etc. and the VAD decision of
+ *                        each lane in `inst->vad`, 0 (no active speech) or
+ *                        1-6 (active speech)
+ */
+void WebRtcVad_CalcVad48khzLanes(VadLanesT* inst,
+                                 const int16_t* const* speech_frames,
+                                 size_t frame_length);
+void WebRtcVad_CalcVad32khzLanes(VadLanesT* inst,
+                                 const int16_t* const* speech_frames,
+                                 size_t frame_length);
+void WebRtcVad_CalcVad16khzLanes(VadLanesT* inst,
+                                 const int16_t* const* speech_frames,
+                                 size_t frame_length);
+void WebRtcVad_CalcVad8khzLanes(VadLanesT* inst,
+                                const int16_t* const* speech_frames,
+                                size_t frame_length);
+
 #endif  // COMMON_AUDIO_VAD_VAD_CORE_H_
@@ -10,6 +10,8 @@
 
 #include "common_audio/vad/vad_filterbank.h"
 
+#include <string.h>
+
 #include "rtc_base/checks.h"
 #include "common_audio/signal_processing/include/signal_processing_library.h"
 
@@ -138,32 +140,18 @@ static void SplitFilter(const int16_t* data_in, size_t data_length,
   }
 }
 
-// Calculates the energy of `data_in` in dB, and also updates an overall
-// `total_energy` if necessary.
+// Converts an energy computed by WebRtcSpl_Energy() to dB, and also updates an
+// overall `total_energy` if necessary.
 //
-// - data_in      [i]   : Input audio data for energy calculation.
-// - data_length  [i]   : Length of input data.
+// - energy       [i]   : Energy, in Q(-`tot_rshifts`).
+// - tot_rshifts  [i]   : Number of right shifts performed on `energy`.
 // - offset       [i]   : Offset value added to `log_energy`.
-// - total_energy [i/o] : An external energy updated with the energy of
-//                        `data_in`.
+// - total_energy [i/o] : An external energy updated with `energy`.
 //                        NOTE: `total_energy` is only updated if
 //                        `total_energy` <= `kMinEnergy`.
-// - log_energy   [o]   : 10 * log10("energy of `data_in`") given in Q4.
-static void LogOfEnergy(const int16_t* data_in, size_t data_length,
-                        int16_t offset, int16_t* total_energy,
-                        int16_t* log_energy) {
-  // `tot_rshifts` accumulates the number of right shifts performed on `energy`.
-  int tot_rshifts = 0;
-  // The `energy` will be normalized to 15 bits. We use unsigned integer because
-  // we eventually will mask out the fractional part.
-  uint32_t energy = 0;
-
-  RTC_DCHECK(data_in);
-  RTC_DCHECK_GT(data_length, 0);
-
-  energy = (uint32_t) WebRtcSpl_Energy((int16_t*) data_in, data_length,
-                                       &tot_rshifts);
-
+// - log_energy   [o]   : 10 * log10(`energy`) given in Q4.
+static void EnergyToLog(uint32_t energy, int tot_rshifts, int16_t offset,
+                        int16_t* total_energy, int16_t* log_energy) {
   if (energy != 0) {
     // By construction, normalizing to 15 bits is equivalent with 17 leading
     // zeros of an unsigned 32 bit value.
@@ -240,8 +228,36 @@ static void LogOfEnergy(const int16_t* data_in, size_t data_length,
   }
 }
 
-int16_t WebRtcVad_CalculateFeatures(VadInstT* self, const int16_t* data_in,
-                                    size_t data_length, int16_t* features) {
+// Calculates the energy of `data_in` in dB, and also updates an overall
+// `total_energy` if necessary.
+//
+// - data_in      [i]   : Input audio data for energy calculation.
+// - data_length  [i]   : Length of input data.
+// - offset       [i]   : Offset value added to `log_energy`.
+// - total_energy [i/o] : An external energy updated with the energy of
+//                        `data_in`.
+//                        NOTE: `total_energy` is only updated if
+//                        `total_energy` <= `kMinEnergy`.
+// - log_energy   [o]   : 10 * log10("energy of `data_in`") given in Q4.
+static void LogOfEnergy(const int16_t* data_in, size_t data_length,
+                        int16_t offset, int16_t* total_energy,
+                        int16_t* log_energy) {
+  // `tot_rshifts` accumulates the number of right shifts performed on `energy`.
+  int tot_rshifts = 0;
+  // The `energy` will be normalized to 15 bits. We use unsigned integer because
+  // we eventually will mask out the fractional part.
+  uint32_t energy = 0;
+
+  RTC_DCHECK(data_in);
+  RTC_DCHECK_GT(data_length, 0);
+
+  energy = (uint32_t) WebRtcSpl_Energy((int16_t*) data_in, data_length,
+                                       &tot_rshifts);
+  EnergyToLog(energy, tot_rshifts, offset, total_energy, log_energy);
+}
+
+int16_t WebRtcVad_CalculateFeaturesC(VadInstT* self, const int16_t* data_in,
+                                     size_t data_length, int16_t* features) {
   int16_t total_energy = 0;
   // We expect `data_length` to be 80, 160 or 240 samples, which corresponds to
   // 10, 20 or 30 ms in 8 kHz. Therefore, the intermediate downsampled data will
@@ -327,3 +343,397 @@ int16_t WebRtcVad_CalculateFeatures(VadInstT* self, const int16_t* data_in,
 
   return total_energy;
 }
+
+#if defined(WEBRTC_VAD_VECTOR_FILTERBANK)
+
+// Lanes are kept unsigned so that products and sums wrap exactly like the
+// int32_t arithmetic of the scalar code, and reinterpreted as signed for
+// arithmetic right shifts.
+typedef uint32_t VadUint32x4 __attribute__((vector_size(16)));
+typedef int32_t VadInt32x4 __attribute__((vector_size(16)));
+typedef int16_t VadInt16x8 __attribute__((vector_size(16)));
+
+// Runs SplitFilter() on two inputs of equal length at once. The upper and lower
+// all-pass branches of both splits are independent recursions, so they occupy
+// the four lanes of a vector and advance together. A lone split would leave
+// half the lanes idle and is cheaper with SplitFilter().
+//
+// - data_in_a, data_in_b [i]   : Input audio data of the two splits.
+// - data_length          [i]   : Length of each input.
+// - band_a, band_b       [i]   : Indices of the splits' filter states in
+//                                `self`.
+// - self                 [i/o] : VAD instance holding the filter states.
+// - hp_a, lp_a, hp_b, lp_b [o] : Upper and lower outputs of the two splits,
+//                                each `data_length` / 2 long.
+static void SplitFilterX2(const int16_t* data_in_a, const int16_t* data_in_b,
+                          size_t data_length, int band_a, int band_b,
+                          VadInstT* self, int16_t* hp_a, int16_t* lp_a,
+                          int16_t* hp_b, int16_t* lp_b) {
+  size_t i;
+  size_t half_length = data_length >> 1;
+  const VadUint32x4 coefs = {
+      (uint32_t) kAllPassCoefsQ15[0], (uint32_t) kAllPassCoefsQ15[1],
+      (uint32_t) kAllPassCoefsQ15[0], (uint32_t) kAllPassCoefsQ15[1]};
+  const VadUint32x4 coefs_x2 = coefs << 1;
+  // AllPassFilter() computes state32 = ((in << 14) - coefs * out) << 1 after
+  // each sample. Expanding the shift modulo 2^32 and folding the next
+  // sample's coefs * in leaves a single multiply on the recursion:
+  //   out[n] = ((in[n - 1] << 15) + coefs * in[n] - 2 * coefs * out[n - 1])
+  //            >> 16.
+  // The initial state takes the place of in[-1] << 15 with out[-1] = 0.
+  VadUint32x4 prev_in_q15 = {
+      (uint32_t) self->upper_state[band_a] << 16,
+      (uint32_t) self->lower_state[band_a] << 16,
+      (uint32_t) self->upper_state[band_b] << 16,
+      (uint32_t) self->lower_state[band_b] << 16};
+  VadInt32x4 out = {0, 0, 0, 0};  // Q(-1)
+
+  for (i = 0; i < half_length; i++) {
+    // Upper branches take even samples and lower branches odd ones.
+    VadUint32x4 in = {
+        (uint32_t) data_in_a[2 * i], (uint32_t) data_in_a[2 * i + 1],
+        (uint32_t) data_in_b[2 * i], (uint32_t) data_in_b[2 * i + 1]};
+    VadUint32x4 tmp32 = prev_in_q15 + coefs * in;
+    out = (VadInt32x4) (tmp32 - coefs_x2 * (VadUint32x4) out) >> 16;
+    prev_in_q15 = in << 15;
+
+    // Make LP and HP signals.
+    hp_a[i] = (int16_t) (out[0] - out[1]);
+    lp_a[i] = (int16_t) (out[1] + out[0]);
+    hp_b[i] = (int16_t) (out[2] - out[3]);
+    lp_b[i] = (int16_t) (out[3] + out[2]);
+  }
+
+  VadInt32x4 final_state =
+      (VadInt32x4) (prev_in_q15 - coefs_x2 * (VadUint32x4) out) >> 16;
+  self->upper_state[band_a] = (int16_t) final_state[0];
+  self->lower_state[band_a] = (int16_t) final_state[1];
+  self->upper_state[band_b] = (int16_t) final_state[2];
+  self->lower_state[band_b] = (int16_t) final_state[3];
+}
+
+// Equivalent of WebRtcSpl_Energy(), finding the peak magnitude and summing the
+// scaled squares 8 and 4 samples at a time respectively.
+static uint32_t EnergyX8(const int16_t* data_in, size_t data_length,
+                         int* scale_factor) {
+  size_t i = 0;
+  int16_t smax = -1;
+  int16_t nbits = WebRtcSpl_GetSizeInBits((uint32_t) data_length);
+  int scaling = 0;
+  int32_t energy = 0;
+
+  // Peak magnitude, negating in 16 bits like WebRtcSpl_GetScalingSquare() so
+  // that -32768 is treated identically.
+  VadInt16x8 smax8 = {-1, -1, -1, -1, -1, -1, -1, -1};
+  for (; i + 8 <= data_length; i += 8) {
+    VadInt16x8 x;
+    memcpy(&x, &data_in[i], sizeof(x));
+    VadInt16x8 positive = x > 0;
+    VadInt16x8 sabs = (positive & x) | (~positive & -x);
+    VadInt16x8 greater = sabs > smax8;
+    smax8 = (greater & sabs) | (~greater & smax8);
+  }
+  for (int lane = 0; lane < 8; lane++) {
+    smax = smax8[lane] > smax ? smax8[lane] : smax;
+  }
+  for (size_t j = i; j < data_length; j++) {
+    int16_t sabs = (int16_t) (data_in[j] > 0 ? data_in[j] : -data_in[j]);
+    smax = sabs > smax ? sabs : smax;
+  }
+  if (smax != 0) {
+    int16_t t = WebRtcSpl_NormW32(WEBRTC_SPL_MUL(smax, smax));
+    scaling = (t > nbits) ? 0 : nbits - t;
+  }
+
+  VadUint32x4 sum = {0, 0, 0, 0};
+  for (i = 0; i + 4 <= data_length; i += 4) {
+    VadInt32x4 x = {data_in[i], data_in[i + 1], data_in[i + 2],
+                    data_in[i + 3]};
+    sum += (VadUint32x4) ((x * x) >> scaling);
+  }
+  energy = (int32_t) (sum[0] + sum[1] + sum[2] + sum[3]);
+  for (; i < data_length; i++) {
+    energy += (data_in[i] * data_in[i]) >> scaling;
+  }
+
+  *scale_factor = scaling;
+  return (uint32_t) energy;
+}
+
+// LogOfEnergy() using EnergyX8().
+static void LogOfEnergyX8(const int16_t* data_in, size_t data_length,
+                          int16_t offset, int16_t* total_energy,
+                          int16_t* log_energy) {
+  int tot_rshifts = 0;
+  uint32_t energy;
+
+  RTC_DCHECK(data_in);
+  RTC_DCHECK_GT(data_length, 0);
+
+  energy = EnergyX8(data_in, data_length, &tot_rshifts);
+  EnergyToLog(energy, tot_rshifts, offset, total_energy, log_energy);
+}
+
+int16_t WebRtcVad_CalculateFeatures(VadInstT* self, const int16_t* data_in,
+                                    size_t data_length, int16_t* features) {
+  int16_t total_energy = 0;
+  // As in WebRtcVad_CalculateFeaturesC(), except that the 2000 - 4000 Hz and
+  // 0 - 2000 Hz splits run together and so need separate outputs. The other
+  // splits have no partner and stay scalar.
+  int16_t hp_120[120], lp_120[120];
+  int16_t hp_60[60], lp_60[60];
+  int16_t hp_60_low[60], lp_60_low[60];
+  const size_t half_data_length = data_length >> 1;
+  size_t length = half_data_length >> 1;
+
+  RTC_DCHECK_LE(data_length, 240);
+
+  // Split at 2000 Hz and downsample.
+  SplitFilter(data_in, data_length, &self->upper_state[0],
+              &self->lower_state[0], hp_120, lp_120);
+
+  // Split the upper band (2000 Hz - 4000 Hz) at 3000 Hz and the lower band
+  // (0 Hz - 2000 Hz) at 1000 Hz, and downsample.
+  SplitFilterX2(hp_120, lp_120, half_data_length, 1, 2, self, hp_60, lp_60,
+                hp_60_low, lp_60_low);
+
+  // Energy in 3000 Hz - 4000 Hz, 2000 Hz - 3000 Hz and 1000 Hz - 2000 Hz.
+  LogOfEnergyX8(hp_60, length, kOffsetVector[5], &total_energy, &features[5]);
+  LogOfEnergyX8(lp_60, length, kOffsetVector[4], &total_energy, &features[4]);
+  LogOfEnergyX8(hp_60_low, length, kOffsetVector[3], &total_energy,
+                &features[3]);
+
+  // For the lower band (0 Hz - 1000 Hz) split at 500 Hz and downsample.
+  SplitFilter(lp_60_low, length, &self->upper_state[3], &self->lower_state[3],
+              hp_120, lp_120);
+
+  // Energy in 500 Hz - 1000 Hz.
+  length >>= 1;  // `data_length` / 8 <=> bandwidth = 500 Hz.
+  LogOfEnergyX8(hp_120, length, kOffsetVector[2], &total_energy, &features[2]);
+
+  // For the lower band (0 Hz - 500 Hz) split at 250 Hz and downsample.
+  SplitFilter(lp_120, length, &self->upper_state[4], &self->lower_state[4],
+              hp_60, lp_60);
+
+  // Energy in 250 Hz - 500 Hz.
+  length >>= 1;  // `data_length` / 16 <=> bandwidth = 250 Hz.
+  LogOfEnergyX8(hp_60, length, kOffsetVector[1], &total_energy, &features[1]);
+
+  // Remove 0 Hz - 80 Hz, by high pass filtering the lower band.
+  HighPassFilter(lp_60, length, self->hp_filter_state, hp_120);
+
+  // Energy in 80 Hz - 250 Hz.
+  LogOfEnergyX8(hp_120, length, kOffsetVector[0], &total_energy, &features[0]);
+
+  return total_energy;
+}
+
+#else
+
+int16_t WebRtcVad_CalculateFeatures(VadInstT* self, const int16_t* data_in,
+                                    size_t data_length, int16_t* features) {
+  return WebRtcVad_CalculateFeaturesC(self, data_in, data_length, features);
+}
+
+#endif  // defined(WEBRTC_VAD_VECTOR_FILTERBANK)
+
+// Filtering and energy of `kNumLanes` streams at once, for
+// WebRtcVad_CalculateFeaturesLanes(). Signals are interleaved by lane, sample
+// n of lane l at [n * kNumLanes + l], and every loop over the lanes is the
+// single-stream computation repeated per lane, which compilers turn into
+// vector instructions.
+
+// HighPassFilter() per lane. `filter_state` holds the four states of each lane
+// interleaved by lane.
+static void HighPassFilterLanes(const int16_t* data_in, size_t data_length,
+                                int16_t* filter_state, int16_t* data_out) {
+  size_t i;
+  int lane;
+
+  for (i = 0; i < data_length; i++) {
+    const int16_t* in = &data_in[i * kNumLanes];
+    int16_t* out = &data_out[i * kNumLanes];
+    for (lane = 0; lane < kNumLanes; lane++) {
+      int16_t* state0 = &filter_state[lane];
+      int16_t* state1 = &filter_state[kNumLanes + lane];
+      int16_t* state2 = &filter_state[2 * kNumLanes + lane];
+      int16_t* state3 = &filter_state[3 * kNumLanes + lane];
+      int32_t tmp32;
+
+      // All-zero section (filter coefficients in Q14).
+      tmp32 = kHpZeroCoefs[0] * in[lane];
+      tmp32 += kHpZeroCoefs[1] * *state0;
+      tmp32 += kHpZeroCoefs[2] * *state1;
+      *state1 = *state0;
+      *state0 = in[lane];
+
+      // All-pole section (filter coefficients in Q14).
+      tmp32 -= kHpPoleCoefs[1] * *state2;
+      tmp32 -= kHpPoleCoefs[2] * *state3;
+      *state3 = *state2;
+      *state2 = (int16_t) (tmp32 >> 14);
+      out[lane] = *state2;
+    }
+  }
+}
+
+// SplitFilter() per lane. `upper_state` and `lower_state` hold one state per
+// lane.
+static void SplitFilterLanes(const int16_t* data_in, size_t data_length,
+                             int16_t* upper_state, int16_t* lower_state,
+                             int16_t* hp_data_out, int16_t* lp_data_out) {
+  size_t i;
+  int lane;
+  size_t half_length = data_length >> 1;  // Downsampling by 2.
+  // AllPassFilter() states in Q15, kept unsigned so that they wrap like the
+  // single-stream code.
+  uint32_t upper_state32[kNumLanes];
+  uint32_t lower_state32[kNumLanes];
+
+  for (lane = 0; lane < kNumLanes; lane++) {
+    upper_state32[lane] = (uint32_t) upper_state[lane] << 16;
+    lower_state32[lane] = (uint32_t) lower_state[lane] << 16;
+  }
+
+  for (i = 0; i < half_length; i++) {
+    const int16_t* upper_in = &data_in[(2 * i) * kNumLanes];
+    const int16_t* lower_in = &data_in[(2 * i + 1) * kNumLanes];
+    for (lane = 0; lane < kNumLanes; lane++) {
+      uint32_t upper_tmp32 = upper_state32[lane] +
+          (uint32_t) (kAllPassCoefsQ15[0] * upper_in[lane]);
+      uint32_t lower_tmp32 = lower_state32[lane] +
+          (uint32_t) (kAllPassCoefsQ15[1] * lower_in[lane]);
+      int16_t upper_out = (int16_t) ((int32_t) upper_tmp32 >> 16);  // Q(-1)
+      int16_t lower_out = (int16_t) ((int32_t) lower_tmp32 >> 16);  // Q(-1)
+      upper_state32[lane] = ((uint32_t) upper_in[lane] << 15) -
+          ((uint32_t) (kAllPassCoefsQ15[0] * upper_out) << 1);
+      lower_state32[lane] = ((uint32_t) lower_in[lane] << 15) -
+          ((uint32_t) (kAllPassCoefsQ15[1] * lower_out) << 1);
+
+      // Make LP and HP signals.
+      hp_data_out[i * kNumLanes + lane] = (int16_t) (upper_out - lower_out);
+      lp_data_out[i * kNumLanes + lane] = (int16_t) (lower_out + upper_out);
+    }
+  }
+
+  for (lane = 0; lane < kNumLanes; lane++) {
+    upper_state[lane] = (int16_t) ((int32_t) upper_state32[lane] >> 16);
+    lower_state[lane] = (int16_t) ((int32_t) lower_state32[lane] >> 16);
+  }
+}
+
+// LogOfEnergy() per lane. The energy follows WebRtcSpl_Energy(), with the
+// scaling of WebRtcSpl_GetScalingSquare() found per lane.
+static void LogOfEnergyLanes(const int16_t* data_in, size_t data_length,
+                             int16_t offset, int16_t* total_energy,
+                             int16_t* log_energy) {
+  size_t i;
+  int lane;
+  int16_t nbits = WebRtcSpl_GetSizeInBits((uint32_t) data_length);
+  int16_t smax[kNumLanes];
+  int scaling[kNumLanes];
+  uint32_t energy[kNumLanes];
+
+  RTC_DCHECK(data_in);
+  RTC_DCHECK_GT(data_length, 0);
+
+  // Peak magnitude, negating in 16 bits like WebRtcSpl_GetScalingSquare().
+  for (lane = 0; lane < kNumLanes; lane++) {
+    smax[lane] = -1;
+  }
+  for (i = 0; i < data_length; i++) {
+    for (lane = 0; lane < kNumLanes; lane++) {
+      int16_t sample = data_in[i * kNumLanes + lane];
+      int16_t sabs = sample > 0 ? sample : (int16_t) -sample;
+      smax[lane] = sabs > smax[lane] ? sabs : smax[lane];
+    }
+  }
+  for (lane = 0; lane < kNumLanes; lane++) {
+    int16_t t;
+    scaling[lane] = 0;
+    if (smax[lane] != 0) {
+      t = WebRtcSpl_NormW32(WEBRTC_SPL_MUL(smax[lane], smax[lane]));
+      scaling[lane] = (t > nbits) ? 0 : nbits - t;
+    }
+    energy[lane] = 0;
+  }
+
+  for (i = 0; i < data_length; i++) {
+    for (lane = 0; lane < kNumLanes; lane++) {
+      int32_t sample = data_in[i * kNumLanes + lane];
+      energy[lane] += (uint32_t) ((sample * sample) >> scaling[lane]);
+    }
+  }
+
+  for (lane = 0; lane < kNumLanes; lane++) {
+    EnergyToLog(energy[lane], scaling[lane], offset, &total_energy[lane],
+                &log_energy[lane]);
+  }
+}
+
+void WebRtcVad_CalculateFeaturesLanes(VadLanesT* self, const int16_t* data_in,
+                                      size_t data_length, int16_t* features,
+                                      int16_t* total_energy) {
+  // The single-stream buffers of WebRtcVad_CalculateFeaturesC(), for each lane.
+  int16_t hp_120[120 * kNumLanes], lp_120[120 * kNumLanes];
+  int16_t hp_60[60 * kNumLanes], lp_60[60 * kNumLanes];
+  const size_t half_data_length = data_length >> 1;
+  size_t length = half_data_length;
+  int lane;
+
+  RTC_DCHECK_LE(data_length, 240);
+
+  for (lane = 0; lane < kNumLanes; lane++) {
+    total_energy[lane] = 0;
+  }
+
+  // Split at 2000 Hz and downsample.
+  SplitFilterLanes(data_in, data_length, self->upper_state[0],
+                   self->lower_state[0], hp_120, lp_120);
+
+  // For the upper band (2000 Hz - 4000 Hz) split at 3000 Hz and downsample.
+  SplitFilterLanes(hp_120, length, self->upper_state[1], self->lower_state[1],
+                   hp_60, lp_60);
+
+  // Energy in 3000 Hz - 4000 Hz and 2000 Hz - 3000 Hz.
+  length >>= 1;
+  LogOfEnergyLanes(hp_60, length, kOffsetVector[5], total_energy,
+                   &features[5 * kNumLanes]);
+  LogOfEnergyLanes(lp_60, length, kOffsetVector[4], total_energy,
+                   &features[4 * kNumLanes]);
+
+  // For the lower band (0 Hz - 2000 Hz) split at 1000 Hz and downsample.
+  length = half_data_length;
+  SplitFilterLanes(lp_120, length, self->upper_state[2], self->lower_state[2],
+                   hp_60, lp_60);
+
+  // Energy in 1000 Hz - 2000 Hz.
+  length >>= 1;
+  LogOfEnergyLanes(hp_60, length, kOffsetVector[3], total_energy,
+                   &features[3 * kNumLanes]);
+
+  // For the lower band (0 Hz - 1000 Hz) split at 500 Hz and downsample.
+  SplitFilterLanes(lp_60, length, self->upper_state[3], self->lower_state[3],
+                   hp_120, lp_120);
+
+  // Energy in 500 Hz - 1000 Hz.
+  length >>= 1;
+  LogOfEnergyLanes(hp_120, length, kOffsetVector[2], total_energy,
+                   &features[2 * kNumLanes]);
+
+  // For the lower band (0 Hz - 500 Hz) split at 250 Hz and downsample.
+  SplitFilterLanes(lp_120, length, self->upper_state[4], self->lower_state[4],
+                   hp_60, lp_60);
+
+  // Energy in 250 Hz - 500 Hz.
+  length >>= 1;
+  LogOfEnergyLanes(hp_60, length, kOffsetVector[1], total_energy,
+                   &features[1 * kNumLanes]);
+
+  // Remove 0 Hz - 80 Hz, by high pass filtering the lower band.
+  HighPassFilterLanes(lp_60, length, self->hp_filter_state[0], hp_120);
+
+  // Energy in 80 Hz - 250 Hz.
+  LogOfEnergyLanes(hp_120, length, kOffsetVector[0], total_energy,
+                   &features[0]);
+}
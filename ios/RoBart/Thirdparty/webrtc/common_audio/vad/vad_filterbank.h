@@ -17,6 +17,11 @@
 
 #include "common_audio/vad/vad_core.h"
 
+#if (defined(__GNUC__) || defined(__clang__)) && \
+    !defined(WEBRTC_VAD_DISABLE_VECTOR_FILTERBANK)
+#define WEBRTC_VAD_VECTOR_FILTERBANK
+#endif
+
 // Takes `data_length` samples of `data_in` and calculates the logarithm of the
 // energy of each of the `kNumChannels` = 6 frequency bands used by the VAD:
 //        80 Hz - 250 Hz
@@ -42,4 +47,30 @@ int16_t WebRtcVad_CalculateFeatures(VadInstT* self,
                                     size_t data_length,
                                     int16_t* features);
 
+// Scalar implementation of WebRtcVad_CalculateFeatures(). Where the compiler
+// supports vector extensions (WEBRTC_VAD_VECTOR_FILTERBANK),
+// WebRtcVad_CalculateFeatures() instead runs independent filter branches in
+// parallel vector lanes, with bit-exact results.
+int16_t WebRtcVad_CalculateFeaturesC(VadInstT* self,
+                                     const int16_t* data_in,
+                                     size_t data_length,
+                                     int16_t* features);
+
+// WebRtcVad_CalculateFeatures() for `kNumLanes` streams at once, with
+// bit-exact results. `data_in` holds `data_length` samples of each stream
+// interleaved by lane, sample n of lane l at [n * kNumLanes + l].
+//
+// - self         [i/o] : Lanes with the filter states.
+// - data_in      [i]   : Interleaved input audio data.
+// - data_length  [i]   : Number of samples per lane (80, 160 or 240).
+// - features     [o]   : `kNumChannels` * `kNumLanes` log energies, channel
+//                        c of lane l at [c * kNumLanes + l].
+// - total_energy [o]   : `kNumLanes` total energies, as returned by
+//                        WebRtcVad_CalculateFeatures().
+void WebRtcVad_CalculateFeaturesLanes(VadLanesT* self,
+                                      const int16_t* data_in,
+                                      size_t data_length,
+                                      int16_t* features,
+                                      int16_t* total_energy);
+
 #endif  // COMMON_AUDIO_VAD_VAD_FILTERBANK_H_
@@ -10,6 +10,8 @@
 
 #include <stdlib.h>
 
+#include <algorithm>
+
 #include "common_audio/vad/vad_unittest.h"
 #include "test/gtest.h"
 
@@ -87,5 +89,56 @@ TEST_F(VadTest, vad_filterbank) {
 
   free(self);
 }
+
+TEST_F(VadTest, vad_filterbank_matches_scalar) {
+  VadInstT* self = reinterpret_cast<VadInstT*>(malloc(sizeof(VadInstT)));
+  VadInstT* reference = reinterpret_cast<VadInstT*>(malloc(sizeof(VadInstT)));
+  int16_t features[kNumChannels];
+  int16_t reference_features[kNumChannels];
+  int16_t speech[kMaxFrameLength];
+
+  // Random frames of increasing loudness, including full-scale values, carry
+  // filter state from frame to frame.
+  uint32_t seed = 12345;
+  for (size_t j = 0; j < kFrameLengthsSize; ++j) {
+    if (!ValidRatesAndFrameLengths(8000, kFrameLengths[j])) {
+      continue;
+    }
+    ASSERT_EQ(0, WebRtcVad_InitCore(self));
+    ASSERT_EQ(0, WebRtcVad_InitCore(reference));
+    for (int frame = 0; frame < 200; ++frame) {
+      int amplitude = frame < 190 ? 1 << (frame / 12) : 65536;
+      for (size_t i = 0; i < kFrameLengths[j]; ++i) {
+        seed = seed * 1664525 + 1013904223;
+        int32_t sample = static_cast<int32_t>(seed >> 16) - 32768;
+        sample = sample * amplitude / 32768;
+        speech[i] = static_cast<int16_t>(
+            std::max(-32768, std::min(32767, static_cast<int>(sample))));
+      }
+      if (frame % 50 == 49) {
+        speech[0] = -32768;
+        speech[1] = -32768;
+      }
+      EXPECT_EQ(WebRtcVad_CalculateFeaturesC(reference, speech,
+                                             kFrameLengths[j],
+                                             reference_features),
+                WebRtcVad_CalculateFeatures(self, speech, kFrameLengths[j],
+                                            features));
+      for (int k = 0; k < kNumChannels; ++k) {
+        EXPECT_EQ(reference_features[k], features[k]);
+      }
+      for (int k = 0; k < kNumChannels - 1; ++k) {
+        EXPECT_EQ(reference->upper_state[k], self->upper_state[k]);
+        EXPECT_EQ(reference->lower_state[k], self->lower_state[k]);
+      }
+      for (int k = 0; k < 4; ++k) {
+        EXPECT_EQ(reference->hp_filter_state[k], self->hp_filter_state[k]);
+      }
+    }
+  }
+
+  free(reference);
+  free(self);
+}
 }  // namespace test
 }  // namespace webrtc
@@ -10,7 +10,10 @@
 
 #include "common_audio/vad/vad_gmm.h"
 
+#include <string.h>
+
 #include "common_audio/signal_processing/include/signal_processing_library.h"
+#include "common_audio/vad/vad_core.h"
 
 static const int32_t kCompVar = 22005;
 static const int16_t kLog2Exp = 5909;  // log2(exp(1)) in Q12.
@@ -80,3 +83,105 @@ int32_t WebRtcVad_GaussianProbability(int16_t input,
   // Q-domain: Q10 * Q10 = Q20.
   return inv_std * exp_value;
 }
+
+#if defined(WEBRTC_VAD_VECTOR_LANES)
+
+// WebRtcVad_GaussianProbability() with every lane in one vector. Values the
+// scalar code stores to int16_t are wrapped to 16 bits at the same points.
+void WebRtcVad_GaussianProbabilityLanes(const int16_t* input,
+                                        const int16_t* mean,
+                                        const int16_t* std,
+                                        int16_t* delta,
+                                        int32_t* probability) {
+  VadInt16xL input16, mean16, std16, delta16;
+  VadInt32xL std32, std_is_zero, inv_std, inv_std2, tmp, diff, delta32;
+  VadInt32xL in_range, exponent, exp_value, shifts, probability32;
+  VadFloatxL quotient;
+
+  memcpy(&input16, input, sizeof(input16));
+  memcpy(&mean16, mean, sizeof(mean16));
+  memcpy(&std16, std, sizeof(std16));
+  std32 = __builtin_convertvector(std16, VadInt32xL);
+
+  // `inv_std` = 1 / s, in Q10. The numerator is below 2^18, so that a float
+  // division truncates to the same quotient (see WebRtcVad_DivW32W16Lane()).
+  // Zero lanes divide by one and then take the division by zero result.
+  std_is_zero = std32 == 0;
+  quotient = __builtin_convertvector(131072 + (std32 >> 1), VadFloatxL) /
+             __builtin_convertvector(std32 - std_is_zero, VadFloatxL);
+  inv_std = WEBRTC_VAD_WRAP_INT16_LANES(
+      __builtin_convertvector(quotient, VadInt32xL) | std_is_zero);
+
+  // `inv_std2` = 1 / s^2, in Q14.
+  tmp = inv_std >> 2;
+  inv_std2 = WEBRTC_VAD_WRAP_INT16_LANES((tmp * tmp) >> 2);
+
+  // `delta` = (x - m) / s^2, in Q11.
+  diff = WEBRTC_VAD_WRAP_INT16_LANES(
+      (__builtin_convertvector(input16, VadInt32xL) << 3) -
+      __builtin_convertvector(mean16, VadInt32xL));  // Q7
+  delta32 = WEBRTC_VAD_WRAP_INT16_LANES((inv_std2 * diff) >> 10);
+
+  // Exponent (x - m)^2 / (2 * s^2) in Q10, and exp() of it where small enough.
+  // Lanes past `kCompVar` evaluate it at zero, keeping the shifts in range.
+  tmp = (delta32 * diff) >> 9;
+  in_range = tmp < kCompVar;
+  exponent = WEBRTC_VAD_WRAP_INT16_LANES(
+      -WEBRTC_VAD_WRAP_INT16_LANES((kLog2Exp * (tmp & in_range)) >> 12));
+  exp_value = 0x0400 | (exponent & 0x03FF);
+  shifts = (WEBRTC_VAD_WRAP_INT16_LANES(exponent ^ 0xFFFF) >> 10) + 1;
+  exp_value = (exp_value >> shifts) & in_range;
+
+  probability32 = inv_std * exp_value;  // Q20
+  delta16 = __builtin_convertvector(delta32, VadInt16xL);
+  memcpy(probability, &probability32, sizeof(probability32));
+  memcpy(delta, &delta16, sizeof(delta16));
+}
+
+#else
+
+void WebRtcVad_GaussianProbabilityLanes(const int16_t* input,
+                                        const int16_t* mean,
+                                        const int16_t* std,
+                                        int16_t* delta,
+                                        int32_t* probability) {
+  int lane;
+
+  // WebRtcVad_GaussianProbability() with the branch on `kCompVar` turned into
+  // a select, so that all lanes follow the same path. Lanes past `kCompVar`
+  // evaluate the exponential at zero instead, which keeps the products and
+  // shifts in range, and then discard it.
+  for (lane = 0; lane < kNumLanes; lane++) {
+    int16_t tmp16, inv_std, inv_std2, exp_value;
+    int16_t exponent, shifts;
+    int32_t tmp32, in_range;
+
+    // The numerator is below 2^18, so that a float division truncates to the
+    // same quotient (see WebRtcVad_DivW32W16Lane()).
+    tmp32 = (int32_t) 131072 + (int32_t) (std[lane] >> 1);
+    inv_std = (int16_t) (int32_t) ((float) tmp32 /
+                                   (std[lane] + (std[lane] == 0)));  // Q10
+    inv_std = std[lane] != 0 ? inv_std : -1;
+    tmp16 = (inv_std >> 2);
+    inv_std2 = (int16_t)((tmp16 * tmp16) >> 2);  // Q14
+
+    tmp16 = (input[lane] << 3);
+    tmp16 = tmp16 - mean[lane];  // Q7
+    delta[lane] = (int16_t)((inv_std2 * tmp16) >> 10);  // Q11
+    tmp32 = (delta[lane] * tmp16) >> 9;  // Q10
+
+    in_range = tmp32 < kCompVar;
+    exponent = (int16_t)((kLog2Exp * (in_range ? tmp32 : 0)) >> 12);
+    exponent = -exponent;
+    exp_value = (0x0400 | (exponent & 0x03FF));
+    shifts = (int16_t) (exponent ^ 0xFFFF);
+    shifts >>= 10;
+    shifts += 1;
+    exp_value >>= shifts;
+    exp_value = in_range ? exp_value : 0;
+
+    probability[lane] = inv_std * exp_value;  // Q20
+  }
+}
+
+#endif  // defined(WEBRTC_VAD_VECTOR_LANES)
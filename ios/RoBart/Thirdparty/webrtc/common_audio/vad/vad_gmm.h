@@ -36,4 +36,33 @@ int32_t WebRtcVad_GaussianProbability(int16_t input,
                                       int16_t std,
                                       int16_t* delta);
 
+// WebRtcSpl_DivW32W16() in a form compilers can vectorize across lanes. For a
+// 32-bit `num` and a nonzero 16-bit `den`, a true quotient that isn't an
+// integer lies at least 2^-46 (relatively) from one, far more than the
+// rounding error of a double division, so truncating the double quotient
+// gives the same result as integer division. The division is unconditional,
+// by 1 in place of 0, as compilers won't if-convert a floating point
+// operation that may trap.
+static __inline int32_t WebRtcVad_DivW32W16Lane(int32_t num, int16_t den) {
+  int32_t quotient = (int32_t) ((double) num / (den + (den == 0)));
+  return den != 0 ? quotient : (int32_t) 0x7FFFFFFF;
+}
+
+// WebRtcVad_GaussianProbability() for each of `kNumLanes` (see vad_core.h)
+// independent inputs, with bit-exact results.
+//
+// Inputs:
+//      - input         : `kNumLanes` input samples in Q4.
+//      - mean          : `kNumLanes` means, Q7.
+//      - std           : `kNumLanes` standard deviations, Q7.
+//
+// Output:
+//      - delta         : `kNumLanes` deltas, Q11.
+//      - probability   : `kNumLanes` probabilities, Q20.
+void WebRtcVad_GaussianProbabilityLanes(const int16_t* input,
+                                        const int16_t* mean,
+                                        const int16_t* std,
+                                        int16_t* delta,
+                                        int32_t* probability);
+
 #endif  // COMMON_AUDIO_VAD_VAD_GMM_H_
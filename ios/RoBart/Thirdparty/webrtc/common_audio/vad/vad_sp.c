@@ -52,25 +52,46 @@ void WebRtcVad_Downsampling(const int16_t* signal_in,
   filter_state[1] = tmp32_2;
 }
 
-// Inserts `feature_value` into `low_value_vector`, if it is one of the 16
-// smallest values the last 100 frames. Then calculates and returns the median
-// of the five smallest values.
-int16_t WebRtcVad_FindMinimum(VadInstT* self,
-                              int16_t feature_value,
-                              int channel) {
+void WebRtcVad_DownsamplingLanes(const int16_t* signal_in,
+                                 int16_t* signal_out,
+                                 int32_t* filter_state,
+                                 size_t in_length) {
+  size_t n = 0;
+  int lane = 0;
+  size_t half_length = (in_length >> 1);
+
+  // Same recursion as WebRtcVad_Downsampling(), run side by side in each lane.
+  for (n = 0; n < half_length; n++) {
+    const int16_t* upper_in = &signal_in[(2 * n) * kNumLanes];
+    const int16_t* lower_in = &signal_in[(2 * n + 1) * kNumLanes];
+    for (lane = 0; lane < kNumLanes; lane++) {
+      int32_t tmp32_1 = filter_state[lane];
+      int32_t tmp32_2 = filter_state[kNumLanes + lane];
+      int16_t tmp16_1 = (int16_t) ((tmp32_1 >> 1) +
+          ((kAllPassCoefsQ13[0] * upper_in[lane]) >> 14));
+      int16_t tmp16_2 = (int16_t) ((tmp32_2 >> 1) +
+          ((kAllPassCoefsQ13[1] * lower_in[lane]) >> 14));
+      signal_out[n * kNumLanes + lane] = (int16_t) (tmp16_1 + tmp16_2);
+      filter_state[lane] = (int32_t) upper_in[lane] -
+          ((kAllPassCoefsQ13[0] * tmp16_1) >> 12);
+      filter_state[kNumLanes + lane] = (int32_t) lower_in[lane] -
+          ((kAllPassCoefsQ13[1] * tmp16_2) >> 12);
+    }
+  }
+}
+
+// Inserts `feature_value` into the 16 smallest values `smallest_values` of a
+// channel, if it is one of the 16 smallest values the last 100 frames. Then
+// calculates, smooths into `mean_value` and returns the median of the five
+// smallest values.
+static int16_t FindMinimum(int16_t* age, int16_t* smallest_values,
+                           int16_t* mean_value, int32_t frame_counter,
+                           int16_t feature_value) {
   int i = 0, j = 0;
   int position = -1;
-  // Offset to beginning of the 16 minimum values in memory.
-  const int offset = (channel << 4);
   int16_t current_median = 1600;
   int16_t alpha = 0;
   int32_t tmp32 = 0;
-  // Pointer to memory for the 16 minimum values and the age of each value of
-  // the `channel`.
-  int16_t* age = &self->index_vector[offset];
-  int16_t* smallest_values = &self->low_value_vector[offset];
-
-  RTC_DCHECK_LT(channel, kNumChannels);
 
   // Each value in `smallest_values` is getting 1 loop older. Update `age`, and
   // remove old values.
@@ -153,24 +174,53 @@ int16_t WebRtcVad_FindMinimum(VadInstT* self,
   }
 
   // Get `current_median`.
-  if (self->frame_counter > 2) {
+  if (frame_counter > 2) {
     current_median = smallest_values[2];
-  } else if (self->frame_counter > 0) {
+  } else if (frame_counter > 0) {
     current_median = smallest_values[0];
   }
 
   // Smooth the median value.
-  if (self->frame_counter > 0) {
-    if (current_median < self->mean_value[channel]) {
+  if (frame_counter > 0) {
+    if (current_median < *mean_value) {
       alpha = kSmoothingDown;  // 0.2 in Q15.
     } else {
       alpha = kSmoothingUp;  // 0.99 in Q15.
     }
   }
-  tmp32 = (alpha + 1) * self->mean_value[channel];
+  tmp32 = (alpha + 1) * *mean_value;
   tmp32 += (WEBRTC_SPL_WORD16_MAX - alpha) * current_median;
   tmp32 += 16384;
-  self->mean_value[channel] = (int16_t) (tmp32 >> 15);
+  *mean_value = (int16_t) (tmp32 >> 15);
+
+  return *mean_value;
+}
+
+int16_t WebRtcVad_FindMinimum(VadInstT* self,
+                              int16_t feature_value,
+                              int channel) {
+  // Offset to beginning of the 16 minimum values in memory.
+  const int offset = (channel << 4);
+
+  RTC_DCHECK_LT(channel, kNumChannels);
+
+  return FindMinimum(&self->index_vector[offset],
+                     &self->low_value_vector[offset],
+                     &self->mean_value[channel], self->frame_counter,
+                     feature_value);
+}
+
+int16_t WebRtcVad_FindMinimumLane(VadLanesT* self,
+                                  int lane,
+                                  int16_t feature_value,
+                                  int channel) {
+  const int offset = (channel << 4);
+
+  RTC_DCHECK_LT(channel, kNumChannels);
+  RTC_DCHECK_LT(lane, kNumLanes);
 
-  return self->mean_value[channel];
+  return FindMinimum(&self->index_vector[lane][offset],
+                     &self->low_value_vector[lane][offset],
+                     &self->mean_value[channel][lane],
+                     self->frame_counter[lane], feature_value);
 }
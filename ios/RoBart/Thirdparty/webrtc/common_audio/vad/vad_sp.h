@@ -51,4 +51,19 @@ int16_t WebRtcVad_FindMinimum(VadInstT* handle,
                               int16_t feature_value,
                               int channel);
 
+// WebRtcVad_Downsampling() of `kNumLanes` signals at once. Input and output
+// samples are interleaved by lane, sample n of lane l at [n * kNumLanes + l],
+// and `filter_state` holds the two filter states of each lane in the same
+// way.
+void WebRtcVad_DownsamplingLanes(const int16_t* signal_in,
+                                 int16_t* signal_out,
+                                 int32_t* filter_state,
+                                 size_t in_length);
+
+// WebRtcVad_FindMinimum() for one `lane` of `handle`.
+int16_t WebRtcVad_FindMinimumLane(VadLanesT* handle,
+                                  int lane,
+                                  int16_t feature_value,
+                                  int channel);
+
 #endif  // COMMON_AUDIO_VAD_VAD_SP_H_
@@ -142,6 +142,80 @@ TEST_F(VadTest, ValidRatesFrameLengths) {
   }
 }
 
+TEST_F(VadTest, BatchMatchesIndependentInstances) {
+  // An odd number of streams leaves lanes of the last group unused. Each
+  // stream gets its own mode and signal: silence, noise and tone bursts of
+  // different levels, so that the streams' models and decisions diverge.
+  const size_t kNumStreams = 11;
+  const int kNumFrames = 150;
+  int16_t audio[kNumStreams][kMaxFrameLength];
+  const int16_t* frames[kNumStreams];
+  int decisions[kNumStreams];
+  VadInst* handles[kNumStreams];
+
+  VadBatchInst* batch = WebRtcVad_CreateBatch(kNumStreams);
+  ASSERT_TRUE(batch != nullptr);
+
+  for (size_t i = 0; i < kRatesSize; ++i) {
+    for (size_t j = 0; j < kFrameLengthsSize; ++j) {
+      if (!ValidRatesAndFrameLengths(kRates[i], kFrameLengths[j])) {
+        continue;
+      }
+      ASSERT_EQ(0, WebRtcVad_InitBatch(batch));
+      for (size_t stream = 0; stream < kNumStreams; ++stream) {
+        int mode = kModes[stream % kModesSize];
+        handles[stream] = WebRtcVad_Create();
+        ASSERT_EQ(0, WebRtcVad_Init(handles[stream]));
+        ASSERT_EQ(0, WebRtcVad_set_mode(handles[stream], mode));
+        ASSERT_EQ(0, WebRtcVad_set_mode_batch(batch, stream, mode));
+        frames[stream] = audio[stream];
+      }
+
+      uint32_t seed = 17;
+      for (int frame = 0; frame < kNumFrames; ++frame) {
+        for (size_t stream = 0; stream < kNumStreams; ++stream) {
+          int level = (stream * 7 + frame / 10) % 5;
+          bool tone = ((frame / 8) + stream) % 3 == 0;
+          for (size_t n = 0; n < kFrameLengths[j]; ++n) {
+            seed = seed * 1664525 + 1013904223;
+            int value = (static_cast<int>(seed >> 20) - 2048) << level;
+            if (tone) {
+              value += ((n * (stream + 3)) % 64 < 32 ? 6000 : -6000) >> level;
+            }
+            audio[stream][n] = level == 0 ? 0 : static_cast<int16_t>(value);
+          }
+        }
+
+        ASSERT_EQ(0, WebRtcVad_ProcessBatch(batch, kRates[i], frames,
+                                            kFrameLengths[j], decisions));
+        for (size_t stream = 0; stream < kNumStreams; ++stream) {
+          EXPECT_EQ(WebRtcVad_Process(handles[stream], kRates[i],
+                                      audio[stream], kFrameLengths[j]),
+                    decisions[stream])
+              << "rate " << kRates[i] << ", length " << kFrameLengths[j]
+              << ", frame " << frame << ", stream " << stream;
+        }
+      }
+
+      for (size_t stream = 0; stream < kNumStreams; ++stream) {
+        WebRtcVad_Free(handles[stream]);
+      }
+    }
+  }
+
+  // Invalid use.
+  EXPECT_TRUE(WebRtcVad_CreateBatch(0) == nullptr);
+  EXPECT_EQ(-1, WebRtcVad_InitBatch(nullptr));
+  EXPECT_EQ(-1, WebRtcVad_set_mode_batch(batch, kNumStreams, kModes[0]));
+  EXPECT_EQ(-1, WebRtcVad_set_mode_batch(batch, 0, 4));
+  EXPECT_EQ(-1, WebRtcVad_ProcessBatch(batch, 9999, frames, kFrameLengths[0],
+                                       decisions));
+  EXPECT_EQ(-1, WebRtcVad_ProcessBatch(batch, kRates[0], nullptr,
+                                       kFrameLengths[0], decisions));
+
+  WebRtcVad_FreeBatch(batch);
+}
+
 // TODO(bjornv): Add a process test, run on file.
 
 }  // namespace test
@@ -21,6 +21,17 @@ static const int kValidRates[] = { 8000, 16000, 32000, 48000 };
 static const size_t kRatesSize = sizeof(kValidRates) / sizeof(*kValidRates);
 static const int kMaxFrameLengthMs = 30;
 
+// Streams of a batched VAD, `kNumLanes` to a group. A partly filled group
+// costs as much as a full one, so the streams left over after the full groups
+// run on scalar instances instead.
+typedef struct {
+  size_t num_streams;
+  size_t num_groups;
+  VadLanesT* groups;
+  VadInstT* remainder;
+  int init_flag;
+} VadBatchT;
+
 VadInst* WebRtcVad_Create(void) {
   VadInstT* self = (VadInstT*)malloc(sizeof(VadInstT));
 
@@ -88,6 +99,163 @@ int WebRtcVad_Process(VadInst* handle, int fs, const int16_t* audio_frame,
   return vad;
 }
 
+VadBatchInst* WebRtcVad_CreateBatch(size_t num_streams) {
+  VadBatchT* self;
+
+  if (num_streams == 0) {
+    return NULL;
+  }
+  self = (VadBatchT*)malloc(sizeof(VadBatchT));
+  if (self == NULL) {
+    return NULL;
+  }
+  self->num_streams = num_streams;
+  self->num_groups = num_streams / kNumLanes;
+  self->groups = NULL;
+  self->remainder = NULL;
+  if (self->num_groups > 0) {
+    self->groups = (VadLanesT*)malloc(self->num_groups * sizeof(VadLanesT));
+  }
+  if (num_streams % kNumLanes > 0) {
+    self->remainder =
+        (VadInstT*)malloc((num_streams % kNumLanes) * sizeof(VadInstT));
+  }
+  if ((self->num_groups > 0 && self->groups == NULL) ||
+      (num_streams % kNumLanes > 0 && self->remainder == NULL)) {
+    WebRtcVad_FreeBatch((VadBatchInst*)self);
+    return NULL;
+  }
+  self->init_flag = 0;
+
+  return (VadBatchInst*)self;
+}
+
+void WebRtcVad_FreeBatch(VadBatchInst* handle) {
+  VadBatchT* self = (VadBatchT*) handle;
+
+  if (self != NULL) {
+    free(self->groups);
+    free(self->remainder);
+  }
+  free(self);
+}
+
+int WebRtcVad_InitBatch(VadBatchInst* handle) {
+  VadBatchT* self = (VadBatchT*) handle;
+  size_t i;
+
+  if (handle == NULL) {
+    return -1;
+  }
+
+  for (i = 0; i < self->num_groups; i++) {
+    if (WebRtcVad_InitCoreLanes(&self->groups[i]) != 0) {
+      return -1;
+    }
+  }
+  for (i = self->num_groups * kNumLanes; i < self->num_streams; i++) {
+    if (WebRtcVad_InitCore(
+            &self->remainder[i - self->num_groups * kNumLanes]) != 0) {
+      return -1;
+    }
+  }
+  self->init_flag = kInitCheck;
+
+  return 0;
+}
+
+int WebRtcVad_set_mode_batch(VadBatchInst* handle, size_t stream, int mode) {
+  VadBatchT* self = (VadBatchT*) handle;
+
+  if (handle == NULL) {
+    return -1;
+  }
+  if (self->init_flag != kInitCheck) {
+    return -1;
+  }
+  if (stream >= self->num_streams) {
+    return -1;
+  }
+
+  if (stream >= self->num_groups * kNumLanes) {
+    return WebRtcVad_set_mode_core(
+        &self->remainder[stream - self->num_groups * kNumLanes], mode);
+  }
+  return WebRtcVad_set_mode_core_lanes(&self->groups[stream / kNumLanes],
+                                       (int) (stream % kNumLanes), mode);
+}
+
+int WebRtcVad_ProcessBatch(VadBatchInst* handle,
+                           int fs,
+                           const int16_t* const* audio_frames,
+                           size_t frame_length,
+                           int* vad_decisions) {
+  VadBatchT* self = (VadBatchT*) handle;
+  size_t i;
+  int lane;
+
+  if (handle == NULL) {
+    return -1;
+  }
+
+  if (self->init_flag != kInitCheck) {
+    return -1;
+  }
+  if (audio_frames == NULL || vad_decisions == NULL) {
+    return -1;
+  }
+  for (i = 0; i < self->num_streams; i++) {
+    if (audio_frames[i] == NULL) {
+      return -1;
+    }
+  }
+  if (WebRtcVad_ValidRateAndFrameLength(fs, frame_length) != 0) {
+    return -1;
+  }
+
+  for (i = 0; i < self->num_groups; i++) {
+    VadLanesT* group = &self->groups[i];
+    size_t first = i * kNumLanes;
+    const int16_t* frames[kNumLanes];
+
+    for (lane = 0; lane < kNumLanes; lane++) {
+      frames[lane] = audio_frames[first + lane];
+    }
+
+    if (fs == 48000) {
+      WebRtcVad_CalcVad48khzLanes(group, frames, frame_length);
+    } else if (fs == 32000) {
+      WebRtcVad_CalcVad32khzLanes(group, frames, frame_length);
+    } else if (fs == 16000) {
+      WebRtcVad_CalcVad16khzLanes(group, frames, frame_length);
+    } else {
+      WebRtcVad_CalcVad8khzLanes(group, frames, frame_length);
+    }
+
+    for (lane = 0; lane < kNumLanes; lane++) {
+      vad_decisions[first + lane] = group->vad[lane] > 0 ? 1 : 0;
+    }
+  }
+
+  for (i = self->num_groups * kNumLanes; i < self->num_streams; i++) {
+    VadInstT* inst = &self->remainder[i - self->num_groups * kNumLanes];
+    int vad;
+
+    if (fs == 48000) {
+      vad = WebRtcVad_CalcVad48khz(inst, audio_frames[i], frame_length);
+    } else if (fs == 32000) {
+      vad = WebRtcVad_CalcVad32khz(inst, audio_frames[i], frame_length);
+    } else if (fs == 16000) {
+      vad = WebRtcVad_CalcVad16khz(inst, audio_frames[i], frame_length);
+    } else {
+      vad = WebRtcVad_CalcVad8khz(inst, audio_frames[i], frame_length);
+    }
+    vad_decisions[i] = vad > 0 ? 1 : 0;
+  }
+
+  return 0;
+}
+
 int WebRtcVad_ValidRateAndFrameLength(int rate, size_t frame_length) {
   int return_value = -1;
   size_t i;
@@ -0,0 +1,19 @@
+/*
+ *  Copyright (c) 2016 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#ifndef TEST_GTEST_H_
+#define TEST_GTEST_H_
+
+// The WebRTC tree wraps its testing/gtest checkout here. Outside of it (see
+// CMakeLists.txt), the system Google Test is used.
+#include <gtest/gtest-spi.h>
+#include <gtest/gtest.h>
+
+#endif  // TEST_GTEST_H_